@@ -121,6 +121,22 @@ UNIFYFS_DEF(pwrite, ssize_t,
 UNIFYFS_DEF(pwrite64, ssize_t,
             (int fd, const void* buf, size_t count, off64_t off),
             (fd, buf, count, off))
+UNIFYFS_DEF(preadv, ssize_t,
+            (int fd, const struct iovec* iov, int iovcnt, off_t off),
+            (fd, iov, iovcnt, off))
+UNIFYFS_DEF(pwritev, ssize_t,
+            (int fd, const struct iovec* iov, int iovcnt, off_t off),
+            (fd, iov, iovcnt, off))
+#ifdef HAVE_PREADV2
+UNIFYFS_DEF(preadv2, ssize_t,
+            (int fd, const struct iovec* iov, int iovcnt, off_t off, int flags),
+            (fd, iov, iovcnt, off, flags))
+#endif
+#ifdef HAVE_PWRITEV2
+UNIFYFS_DEF(pwritev2, ssize_t,
+            (int fd, const struct iovec* iov, int iovcnt, off_t off, int flags),
+            (fd, iov, iovcnt, off, flags))
+#endif
 UNIFYFS_DEF(close, int,
             (int fd),
             (fd))
@@ -343,6 +359,14 @@ struct gotcha_binding_t unifyfs_wrappers[] = {
     { "pread64", UNIFYFS_WRAP(pread64), &wrappee_handle_pread64 },
     { "pwrite", UNIFYFS_WRAP(pwrite), &wrappee_handle_pwrite },
     { "pwrite64", UNIFYFS_WRAP(pwrite64), &wrappee_handle_pwrite64 },
+    { "preadv", UNIFYFS_WRAP(preadv), &wrappee_handle_preadv },
+    { "pwritev", UNIFYFS_WRAP(pwritev), &wrappee_handle_pwritev },
+#ifdef HAVE_PREADV2
+    { "preadv2", UNIFYFS_WRAP(preadv2), &wrappee_handle_preadv2 },
+#endif
+#ifdef HAVE_PWRITEV2
+    { "pwritev2", UNIFYFS_WRAP(pwritev2), &wrappee_handle_pwritev2 },
+#endif
     { "ftruncate", UNIFYFS_WRAP(ftruncate), &wrappee_handle_ftruncate },
     { "fsync", UNIFYFS_WRAP(fsync), &wrappee_handle_fsync },
     { "fdatasync", UNIFYFS_WRAP(fdatasync), &wrappee_handle_fdatasync },
@@ -74,6 +74,11 @@ static void register_client_rpcs(client_rpc_context_t* ctx)
                        unifyfs_mread_in_t,
                        unifyfs_mread_out_t,
                        NULL);
+
+    ctx->rpcs.log_extents_id = MARGO_REGISTER(mid, "unifyfs_log_extents_rpc",
+                       unifyfs_log_extents_in_t,
+                       unifyfs_log_extents_out_t,
+                       NULL);
 }
 
 /* initialize margo client-server rpc */
@@ -576,8 +581,9 @@ int invoke_client_laminate_rpc(int gfid)
     return (int)ret;
 }
 
-/* invokes the client sync rpc function */
-int invoke_client_sync_rpc(void)
+/* invokes the client sync rpc function, for the given file
+ * or all files if gfid is -1, reading the given index buffer */
+int invoke_client_sync_rpc(int gfid, int index_buf)
 {
     /* check that we have initialized margo */
     if (NULL == client_rpc_context) {
@@ -591,6 +597,8 @@ int invoke_client_sync_rpc(void)
     unifyfs_sync_in_t in;
     in.app_id    = (int32_t) unifyfs_app_id;
     in.client_id = (int32_t) unifyfs_client_id;
+    in.gfid      = (int32_t) gfid;
+    in.index_buf = (int32_t) index_buf;
 
     /* call rpc function */
     LOGDBG("invoking the sync rpc function in client");
@@ -611,7 +619,8 @@ int invoke_client_sync_rpc(void)
 }
 
 /* invokes the client read rpc function */
-int invoke_client_read_rpc(int gfid, size_t offset, size_t length)
+int invoke_client_read_rpc(int gfid, size_t offset, size_t length,
+                           size_t buf)
 {
     /* check that we have initialized margo */
     if (NULL == client_rpc_context) {
@@ -628,6 +637,7 @@ int invoke_client_read_rpc(int gfid, size_t offset, size_t length)
     in.gfid      = (int32_t) gfid;
     in.offset    = (hg_size_t) offset;
     in.length    = (hg_size_t) length;
+    in.buf       = (hg_size_t) buf;
 
     /* call rpc function */
     LOGDBG("invoking the read rpc function in client");
@@ -688,3 +698,95 @@ int invoke_client_mread_rpc(int read_count, size_t size, void* buffer)
     margo_destroy(handle);
     return (int)ret;
 }
+
+/* invokes the client log extents rpc function, returns an error
+ * rather than aborting on margo failures so that the caller can
+ * fall back to reading through the server */
+int invoke_client_log_extents_rpc(int num_ranges,
+                                  unifyfs_log_range_t* ranges,
+                                  int max_extents,
+                                  unifyfs_log_extent_t* extents,
+                                  int* num_extents,
+                                  int* num_ranges_done)
+{
+    *num_extents = 0;
+    *num_ranges_done = 0;
+
+    /* check that we have initialized margo */
+    if (NULL == client_rpc_context) {
+        return UNIFYFS_FAILURE;
+    }
+
+    /* register range list for the server to pull, and extents array
+     * so server can push locations into it */
+    unifyfs_log_extents_in_t in;
+    void* range_buf = (void*) ranges;
+    hg_size_t range_size = num_ranges * sizeof(unifyfs_log_range_t);
+    hg_return_t hret = margo_bulk_create(
+        client_rpc_context->mid, 1, &range_buf, &range_size,
+        HG_BULK_READ_ONLY, &in.range_bulk);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_bulk_create() for log ranges failed");
+        return (int)UNIFYFS_ERROR_MARGO;
+    }
+    void* ext_buf = (void*) extents;
+    hg_size_t ext_size = max_extents * sizeof(unifyfs_log_extent_t);
+    hret = margo_bulk_create(
+        client_rpc_context->mid, 1, &ext_buf, &ext_size,
+        HG_BULK_WRITE_ONLY, &in.extent_bulk);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_bulk_create() for log extents failed");
+        margo_bulk_free(in.range_bulk);
+        return (int)UNIFYFS_ERROR_MARGO;
+    }
+
+    /* fill in input struct */
+    in.app_id      = (int32_t) unifyfs_app_id;
+    in.client_id   = (int32_t) unifyfs_client_id;
+    in.num_ranges  = (int32_t) num_ranges;
+    in.max_extents = (int32_t) max_extents;
+
+    /* get handle to rpc function */
+    hg_handle_t handle;
+    hret = margo_create(client_rpc_context->mid, client_rpc_context->svr_addr,
+                        client_rpc_context->rpcs.log_extents_id, &handle);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_create() for log extents failed");
+        margo_bulk_free(in.range_bulk);
+        margo_bulk_free(in.extent_bulk);
+        return (int)UNIFYFS_ERROR_MARGO;
+    }
+
+    /* call rpc function */
+    int32_t ret;
+    LOGDBG("invoking the log extents rpc function in client");
+    hret = margo_forward(handle, &in);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_forward() for log extents failed");
+        ret = (int32_t)UNIFYFS_ERROR_MARGO;
+    } else {
+        /* decode response */
+        unifyfs_log_extents_out_t out;
+        hret = margo_get_output(handle, &out);
+        if (hret != HG_SUCCESS) {
+            LOGERR("margo_get_output() for log extents failed");
+            ret = (int32_t)UNIFYFS_ERROR_MARGO;
+        } else {
+            ret = out.ret;
+            LOGDBG("Got response ret=%" PRIi32 " num_extents=%" PRIi32
+                   " num_ranges_done=%" PRIi32,
+                   ret, out.num_extents, out.num_ranges_done);
+            if (ret == UNIFYFS_SUCCESS) {
+                *num_extents = (int) out.num_extents;
+                *num_ranges_done = (int) out.num_ranges_done;
+            }
+            margo_free_output(handle, &out);
+        }
+    }
+
+    /* free resources */
+    margo_bulk_free(in.range_bulk);
+    margo_bulk_free(in.extent_bulk);
+    margo_destroy(handle);
+    return (int)ret;
+}
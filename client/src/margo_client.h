@@ -22,6 +22,7 @@ typedef struct ClientRpcIds {
     hg_id_t sync_id;
     hg_id_t read_id;
     hg_id_t mread_id;
+    hg_id_t log_extents_id;
 } client_rpcs_t;
 
 typedef struct ClientRpcContext {
@@ -57,10 +58,18 @@ int invoke_client_unlink_rpc(int gfid);
 
 int invoke_client_laminate_rpc(int gfid);
 
-int invoke_client_sync_rpc(void);
+int invoke_client_sync_rpc(int gfid, int index_buf);
 
-int invoke_client_read_rpc(int gfid, size_t offset, size_t length);
+int invoke_client_read_rpc(int gfid, size_t offset, size_t length,
+                           size_t buf);
 
 int invoke_client_mread_rpc(int read_count, size_t size, void* buffer);
 
+int invoke_client_log_extents_rpc(int num_ranges,
+                                  unifyfs_log_range_t* ranges,
+                                  int max_extents,
+                                  unifyfs_log_extent_t* extents,
+                                  int* num_extents,
+                                  int* num_ranges_done);
+
 #endif // MARGO_CLIENT_H
@@ -120,6 +120,18 @@ static int unifyfs_coalesce_index(
     return UNIFYFS_SUCCESS;
 }
 
+/* generation of the index buffer contents, bumped each time the
+ * index is cleared (with unifyfs_index_lock held for writing) */
+static unsigned long unifyfs_index_gen = 1;
+
+/* index slot most recently appended by this thread, and the index
+ * generation it belongs to. Threads only coalesce writes into their
+ * own entries, so appends from other threads never race with it. */
+static __thread size_t last_index_slot;
+static __thread unsigned long last_index_gen;
+
+static int flush_full_index(void);
+
 /*
  * Clear all entries in the log index.  This only clears the metadata,
  * not the data itself.
@@ -127,23 +139,67 @@ static int unifyfs_coalesce_index(
 static void clear_index(void)
 {
     *unifyfs_indices.ptr_num_entries = 0;
+    unifyfs_index_gen++;
 }
 
-static void add_index_entry_to_seg_tree(unifyfs_filemeta_t* meta,
-                                        unifyfs_index_t* index)
+/*
+ * Release log space holding unsynced data that is overwritten by the
+ * given index entry.  Only extents that have not been synced may be
+ * released, since the server may still reference synced data.
+ */
+static void reclaim_overwritten_log(unifyfs_filemeta_t* meta,
+                                    unifyfs_index_t* index)
 {
-    /* add index to our local log */
-    if (unifyfs_local_extents) {
-        seg_tree_add(&meta->extents, index->file_pos,
-            index->file_pos + index->length - 1,
-            index->log_pos);
+    unsigned long start = index->file_pos;
+    unsigned long end   = index->file_pos + index->length - 1;
+
+    seg_tree_rdlock(&meta->extents_sync);
+    struct seg_tree_node* node =
+        seg_tree_find_nolock(&meta->extents_sync, start, end);
+    while ((node != NULL) && (node->start <= end)) {
+        /* compute portion of this extent that is overwritten */
+        unsigned long ovl_start = (node->start > start) ? node->start : start;
+        unsigned long ovl_end   = (node->end < end) ? node->end : end;
+        if (ovl_start <= ovl_end) {
+            off_t old_pos = node->ptr + (ovl_start - node->start);
+            off_t new_pos = index->log_pos + (ovl_start - start);
+            if (old_pos != new_pos) {
+                size_t nbytes = (size_t)(ovl_end - ovl_start + 1);
+                int rc = unifyfs_logio_free(logio_ctx, old_pos, nbytes);
+                if (rc != UNIFYFS_SUCCESS) {
+                    LOGWARN("logio_free(%zu, %zu) failed",
+                            (size_t)old_pos, nbytes);
+                }
+            }
+        }
+        node = seg_tree_iter(&meta->extents_sync, node);
     }
+    seg_tree_unlock(&meta->extents_sync);
+}
+
+/* Adds the index entry to the file's extent trees, returns the change
+ * in the number of unsynced segments */
+static long add_index_entry_to_seg_tree(unifyfs_filemeta_t* meta,
+                                        unifyfs_index_t* index)
+{
+    pthread_mutex_lock(&meta->extents_lock);
+
+    /* add index to our local log, we always track extents so that
+     * log space can be released on truncate and unlink */
+    seg_tree_add(&meta->extents, index->file_pos,
+        index->file_pos + index->length - 1,
+        index->log_pos);
 
     if (!unifyfs_flatten_writes) {
         /* We're not flattening writes.  Nothing to do */
-        return;
+        pthread_mutex_unlock(&meta->extents_lock);
+        return 0;
     }
 
+    /* the new write hides any unsynced data it overlaps,
+     * return that log space before it is dropped from the tree */
+    reclaim_overwritten_log(meta, index);
+
     /* to update the global running segment count, we need to capture
      * the count in this tree before adding and the count after to
      * add the difference */
@@ -157,25 +213,17 @@ static void add_index_entry_to_seg_tree(unifyfs_filemeta_t* meta,
         index->file_pos + index->length - 1,
         index->log_pos);
 
-    /*
-     * We want to make sure the next write following this wont overflow the
-     * max number of index entries (if it were synced).  A write can at most
-     * create two new nodes in the seg_tree.  If we're close to potentially
-     * filling up the index, sync it out.
-     */
-    if (unifyfs_segment_count >= (unifyfs_max_index_entries - 2)) {
-        /* this will flush our segments, sync them, and set the running
-         * segment count back to 0 */
-        unifyfs_sync();
-    } else {
-        /* increase the running global segment count by the number of
-         * new entries we added to this tree */
-        unsigned long count_after = seg_tree_count(&meta->extents_sync);
-        unifyfs_segment_count += (count_after - count_before);
-    }
+    unsigned long count_after = seg_tree_count(&meta->extents_sync);
+
+    pthread_mutex_unlock(&meta->extents_lock);
+
+    return (long)count_after - (long)count_before;
 }
 
-/* Add the metadata for a single write to the index */
+/* Add the metadata for a single write to the index. Concurrent writers
+ * append to the index buffer without blocking each other, by atomically
+ * claiming index slots and segments while holding the index lock for
+ * reading. When the index is full, the writer syncs and tries again. */
 static int add_write_meta_to_index(unifyfs_filemeta_t* meta,
                                    off_t file_pos,
                                    off_t log_pos,
@@ -191,56 +239,89 @@ static int add_write_meta_to_index(unifyfs_filemeta_t* meta,
     cur_idx.log_pos  = log_pos;
     cur_idx.length   = length;
 
-    /* lookup number of existing index entries */
-    off_t num_entries = *(unifyfs_indices.ptr_num_entries);
-
     /* get pointer to index array */
     unifyfs_index_t* idxs = unifyfs_indices.index_entry;
 
-    /* attempt to coalesce contiguous index entries if we
-     * have an existing index in the buffer */
-    if (num_entries > 0) {
-        /* get pointer to last element in index array */
-        unifyfs_index_t* prev_idx = &idxs[num_entries - 1];
-
-        /* attempt to coalesce current index with last index,
-         * updates fields in last index and current index
-         * accordingly */
-        unifyfs_coalesce_index(prev_idx, &cur_idx,
-            unifyfs_key_slice_range);
-        if (cur_idx.length == 0) {
-            /* We were able to coalesce this write into prev_idx */
-            add_index_entry_to_seg_tree(meta, prev_idx);
+    while (1) {
+        pthread_rwlock_rdlock(&unifyfs_index_lock);
+
+        if (unifyfs_flatten_writes) {
+            /* We want to make sure this write wont overflow the max
+             * number of index entries when the segments are synced.
+             * If we're close to filling up the index, sync it out. */
+            unsigned long segs = __atomic_add_fetch(&unifyfs_segment_count,
+                WRITE_SEGMENT_RESERVE, __ATOMIC_RELAXED);
+            if (segs > unifyfs_max_index_entries) {
+                __atomic_sub_fetch(&unifyfs_segment_count,
+                    WRITE_SEGMENT_RESERVE, __ATOMIC_RELAXED);
+                pthread_rwlock_unlock(&unifyfs_index_lock);
+                if (flush_full_index() != UNIFYFS_SUCCESS) {
+                    LOGERR("failed to flush key/value index to server");
+                    return EIO;
+                }
+                continue;
+            }
+        }
+
+        long segs_added = 0;
+        if (last_index_gen == unifyfs_index_gen) {
+            /* attempt to coalesce current index with the last index
+             * this thread added, updates fields in last index and
+             * current index accordingly */
+            unifyfs_index_t* prev_idx = &idxs[last_index_slot];
+            long prev_len = prev_idx->length;
+            unifyfs_coalesce_index(prev_idx, &cur_idx,
+                unifyfs_key_slice_range);
+            if (prev_idx->length != prev_len) {
+                /* We were able to coalesce (part of) this write */
+                segs_added += add_index_entry_to_seg_tree(meta, prev_idx);
+            }
+        }
+
+        /* add new index entry if needed */
+        int index_full = 0;
+        if (cur_idx.length > 0) {
+            /* claim the next slot in the index buffer */
+            size_t slot = __atomic_fetch_add(unifyfs_indices.ptr_num_entries,
+                                             1, __ATOMIC_RELAXED);
+            if (slot < unifyfs_max_index_entries) {
+                /* copy entry into index buffer */
+                idxs[slot] = cur_idx;
+
+                /* Add index entry to our seg_tree */
+                segs_added += add_index_entry_to_seg_tree(meta, &idxs[slot]);
+
+                /* remember our entry for coalescing later writes */
+                last_index_slot = slot;
+                last_index_gen  = unifyfs_index_gen;
+            } else {
+                /* index buffer is full, give back the slot */
+                __atomic_fetch_sub(unifyfs_indices.ptr_num_entries, 1,
+                                   __ATOMIC_RELAXED);
+                index_full = 1;
+            }
         }
-    }
 
-    /* add new index entry if needed */
-    if (cur_idx.length > 0) {
-        /* remaining entries we can fit in the shared memory region */
-        off_t remaining_entries = unifyfs_max_index_entries - num_entries;
+        if (unifyfs_flatten_writes) {
+            /* replace reserved segments by the number actually added */
+            __atomic_add_fetch(&unifyfs_segment_count,
+                (unsigned long)(segs_added - WRITE_SEGMENT_RESERVE),
+                __ATOMIC_RELAXED);
+        }
 
-        /* if we have filled the key/value buffer, flush it to server */
-        if (0 == remaining_entries) {
-            /* index buffer is full, flush it */
-            int ret = unifyfs_sync();
-            if (ret != UNIFYFS_SUCCESS) {
+        if (index_full) {
+            /* flush the index, then add what remains of the write */
+            pthread_rwlock_unlock(&unifyfs_index_lock);
+            if (flush_full_index() != UNIFYFS_SUCCESS) {
                 /* something went wrong when trying to flush key/values */
                 LOGERR("failed to flush key/value index to server");
                 return EIO;
             }
+            continue;
         }
 
-        /* copy entry into index buffer */
-        idxs[num_entries] = cur_idx;
-
-        /* Add index entry to our seg_tree */
-        add_index_entry_to_seg_tree(meta, &idxs[num_entries]);
-
-        /* account for entries we just added */
-        num_entries += 1;
-
-        /* update number of entries in index array */
-        (*unifyfs_indices.ptr_num_entries) = num_entries;
+        pthread_rwlock_unlock(&unifyfs_index_lock);
+        break;
     }
 
     return UNIFYFS_SUCCESS;
@@ -257,7 +338,8 @@ static int add_write_meta_to_index(unifyfs_filemeta_t* meta,
  * and sequential, for each file, one after another.  All seg_trees will be
  * cleared.
  *
- * This function is called when we sync our extents.
+ * This function is called when we sync our extents, with the index lock
+ * held for writing.
  */
 void unifyfs_rewrite_index_from_seg_tree(void)
 {
@@ -306,16 +388,155 @@ void unifyfs_rewrite_index_from_seg_tree(void)
     *unifyfs_indices.ptr_num_entries = idx;
 }
 
-/*
- * Sync all the extents to the server.  Clears the metadata index afterwards.
- *
- * Returns 0 on success, nonzero otherwise.
- */
-int unifyfs_sync(void)
+/* Ensure log data has reached storage, then tell the server to read
+ * the extents in the given index buffer (only those of gfid, if not -1) */
+static int send_index_to_server(int index_buf, int gfid)
 {
-    /* NOTE: we currently ignore gfid and sync extents for all files in
-     * the index. If we ever switch to storing extents in a per-file index,
-     * we can support per-file sync. */
+    /* ensure any data written to the spill over file is flushed */
+    int ret = unifyfs_logio_sync(logio_ctx);
+    if (ret != UNIFYFS_SUCCESS) {
+        LOGERR("failed to sync logio data");
+        return EIO;
+    }
+
+    /* tell the server to grab our new extents */
+    ret = invoke_client_sync_rpc(gfid, index_buf);
+
+    /* the new extents may change the size of the files */
+    unifyfs_attr_cache_invalidate(gfid);
+    if (ret != UNIFYFS_SUCCESS) {
+        /* something went wrong when trying to flush key/values */
+        LOGERR("failed to flush key/value index to server");
+        return EIO;
+    }
+    return UNIFYFS_SUCCESS;
+}
+
+/* Index buffer that writes are currently added to. When flushing
+ * asynchronously, the flush thread sends a full buffer to the server
+ * while writes continue in the other one. Only one buffer is flushed
+ * at a time, so extents reach the server in the order they were
+ * written. */
+static int active_index_buf;
+
+static pthread_t flush_thread;
+static int flush_running;  /* is the flush thread running? */
+static pthread_mutex_t flush_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t flush_cond = PTHREAD_COND_INITIALIZER;
+static int flush_buf = -1; /* index buffer being flushed, or -1 if none */
+static int failed_buf = -1; /* index buffer whose flush failed, or -1 */
+static int flush_exit;     /* set to stop the flush thread */
+
+/* main loop of the index flush thread */
+static void* index_flusher_main(void* arg)
+{
+    pthread_mutex_lock(&flush_lock);
+    while (1) {
+        while ((-1 == flush_buf) && !flush_exit) {
+            pthread_cond_wait(&flush_cond, &flush_lock);
+        }
+        if (-1 == flush_buf) {
+            /* asked to exit, and nothing left to flush */
+            break;
+        }
+        int index_buf = flush_buf;
+        pthread_mutex_unlock(&flush_lock);
+
+        int rc = send_index_to_server(index_buf, -1);
+        if (rc == UNIFYFS_SUCCESS) {
+            *(unifyfs_index_bufs[index_buf].ptr_num_entries) = 0;
+        }
+
+        pthread_mutex_lock(&flush_lock);
+        if (rc != UNIFYFS_SUCCESS) {
+            /* the extents of a failed flush were already dropped from
+             * the segment trees, so keep them in the buffer until they
+             * are sent by the next sync */
+            LOGERR("background flush of index buffer %d failed",
+                   index_buf);
+            failed_buf = index_buf;
+        }
+        flush_buf = -1;
+        pthread_cond_broadcast(&flush_cond);
+    }
+    pthread_mutex_unlock(&flush_lock);
+    return NULL;
+}
+
+/* Wait for any in-flight background flush to complete, then send the
+ * buffer of a failed background flush, if any, so that its extents
+ * reach the server before any later ones. Assumes the index lock is
+ * held for writing, or that the flush thread has stopped. */
+static int finish_index_flush(void)
+{
+    pthread_mutex_lock(&flush_lock);
+    while (-1 != flush_buf) {
+        pthread_cond_wait(&flush_cond, &flush_lock);
+    }
+    int index_buf = failed_buf;
+    pthread_mutex_unlock(&flush_lock);
+
+    if (-1 == index_buf) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    int rc = send_index_to_server(index_buf, -1);
+    if (rc != UNIFYFS_SUCCESS) {
+        return rc;
+    }
+    *(unifyfs_index_bufs[index_buf].ptr_num_entries) = 0;
+
+    pthread_mutex_lock(&flush_lock);
+    failed_buf = -1;
+    pthread_mutex_unlock(&flush_lock);
+    return UNIFYFS_SUCCESS;
+}
+
+/* start the thread that flushes full index buffers */
+int unifyfs_index_flusher_start(void)
+{
+    flush_buf  = -1;
+    failed_buf = -1;
+    flush_exit = 0;
+    int rc = pthread_create(&flush_thread, NULL, index_flusher_main, NULL);
+    if (rc != 0) {
+        LOGERR("pthread_create() failed for index flusher (rc=%d)", rc);
+        return UNIFYFS_FAILURE;
+    }
+    flush_running = 1;
+    return UNIFYFS_SUCCESS;
+}
+
+/* stop the index flush thread, after any pending flush completes,
+ * does nothing if the thread is not running */
+void unifyfs_index_flusher_stop(void)
+{
+    if (!flush_running) {
+        return;
+    }
+
+    pthread_mutex_lock(&flush_lock);
+    flush_exit = 1;
+    pthread_cond_broadcast(&flush_cond);
+    pthread_mutex_unlock(&flush_lock);
+    pthread_join(flush_thread, NULL);
+    flush_running = 0;
+
+    /* last chance to send the extents of a failed flush */
+    if (finish_index_flush() != UNIFYFS_SUCCESS) {
+        LOGERR("failed to flush key/value index to server");
+    }
+}
+
+/* Hand the active index buffer to the flush thread and continue in the
+ * other buffer, assumes the index lock is held for writing */
+static int swap_index_bufs(void)
+{
+    /* the other buffer must be empty before writes go into it */
+    int rc = finish_index_flush();
+    if (rc != UNIFYFS_SUCCESS) {
+        return rc;
+    }
 
     /* write contents from segment tree to index buffer
      * if we're using that optimization */
@@ -323,24 +544,41 @@ int unifyfs_sync(void)
         unifyfs_rewrite_index_from_seg_tree();
     }
 
-    /* if there are no index entries, we've got nothing to sync */
     if (*unifyfs_indices.ptr_num_entries == 0) {
         return UNIFYFS_SUCCESS;
     }
 
-    /* ensure any data written to the spill over file is flushed */
-    int ret = unifyfs_logio_sync(logio_ctx);
-    if (ret != UNIFYFS_SUCCESS) {
-        LOGERR("failed to sync logio data");
-        return EIO;
+    pthread_mutex_lock(&flush_lock);
+    flush_buf = active_index_buf;
+    pthread_cond_broadcast(&flush_cond);
+    pthread_mutex_unlock(&flush_lock);
+
+    active_index_buf = (active_index_buf + 1) % unifyfs_num_index_bufs;
+    unifyfs_indices = unifyfs_index_bufs[active_index_buf];
+    clear_index();
+
+    return UNIFYFS_SUCCESS;
+}
+
+/* Sync all the extents to the server, assumes the index lock is held
+ * for writing */
+static int sync_index(void)
+{
+    /* write contents from segment tree to index buffer
+     * if we're using that optimization */
+    if (unifyfs_flatten_writes) {
+        unifyfs_rewrite_index_from_seg_tree();
+    }
+
+    /* if there are no index entries, we've got nothing to sync */
+    if (*unifyfs_indices.ptr_num_entries == 0) {
+        return UNIFYFS_SUCCESS;
     }
 
     /* tell the server to grab our new extents */
-    ret = invoke_client_sync_rpc();
+    int ret = send_index_to_server(active_index_buf, -1);
     if (ret != UNIFYFS_SUCCESS) {
-        /* something went wrong when trying to flush key/values */
-        LOGERR("failed to flush key/value index to server");
-        return EIO;
+        return ret;
     }
 
     /* flushed, clear buffer and refresh number of entries
@@ -350,6 +588,232 @@ int unifyfs_sync(void)
     return UNIFYFS_SUCCESS;
 }
 
+/* Sync the extents of a single file to the server, assumes the index
+ * lock is held for writing. The entries of the file are placed at the
+ * front of the index buffer, so the server reads only those, and the
+ * entries of other files are kept for a later sync. */
+static int sync_file_index(unifyfs_filemeta_t* meta)
+{
+    int gfid = meta->gfid;
+    unifyfs_index_t* idxs = unifyfs_indices.index_entry;
+    size_t num_entries = *unifyfs_indices.ptr_num_entries;
+    size_t num_file = 0;
+    size_t num_others = 0;
+
+    if (unifyfs_flatten_writes) {
+        /* the segment trees hold all unsynced writes, so we drop the
+         * entries in the index buffer and write the flattened extents
+         * of this file in their place, other files are rewritten from
+         * their own trees when they sync */
+        clear_index();
+        seg_tree_rdlock(&meta->extents_sync);
+        struct seg_tree_node* node = NULL;
+        while ((node = seg_tree_iter(&meta->extents_sync, node))) {
+            idxs[num_file].file_pos = node->start;
+            idxs[num_file].log_pos  = node->ptr;
+            idxs[num_file].length   = node->end - node->start + 1;
+            idxs[num_file].gfid     = gfid;
+            num_file++;
+        }
+        seg_tree_unlock(&meta->extents_sync);
+        *unifyfs_indices.ptr_num_entries = num_file;
+    } else if (num_entries > 0) {
+        /* move entries of this file to the front of the index, keeping
+         * the order of the entries within each file */
+        unifyfs_index_t* others = (unifyfs_index_t*)
+            malloc(num_entries * sizeof(unifyfs_index_t));
+        if (NULL == others) {
+            /* fall back to syncing all files */
+            return sync_index();
+        }
+        for (size_t i = 0; i < num_entries; i++) {
+            if (idxs[i].gfid == gfid) {
+                idxs[num_file++] = idxs[i];
+            } else {
+                others[num_others++] = idxs[i];
+            }
+        }
+        memcpy(&idxs[num_file], others, num_others * sizeof(unifyfs_index_t));
+        free(others);
+
+        /* entries have moved, do not coalesce into them */
+        unifyfs_index_gen++;
+    }
+
+    /* if there are no index entries, we've got nothing to sync */
+    if (num_file == 0) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    /* tell the server to grab the new extents of this file */
+    int ret = send_index_to_server(active_index_buf, gfid);
+    if (ret != UNIFYFS_SUCCESS) {
+        return ret;
+    }
+
+    if (unifyfs_flatten_writes) {
+        /* flushed, drop segments of this file */
+        clear_index();
+        unifyfs_segment_count -= seg_tree_count(&meta->extents_sync);
+        seg_tree_clear(&meta->extents_sync);
+    } else {
+        /* flushed, keep only the entries of other files */
+        memmove(idxs, &idxs[num_file], num_others * sizeof(unifyfs_index_t));
+        *unifyfs_indices.ptr_num_entries = num_others;
+    }
+
+    return UNIFYFS_SUCCESS;
+}
+
+/*
+ * Sync all the extents to the server.  Clears the metadata index afterwards.
+ *
+ * Returns 0 on success, nonzero otherwise.
+ */
+int unifyfs_sync(void)
+{
+    /* wait for in-progress writers to finish their index updates */
+    pthread_rwlock_wrlock(&unifyfs_index_lock);
+
+    /* earlier extents must reach the server before those we send */
+    int ret = finish_index_flush();
+    if (ret == UNIFYFS_SUCCESS) {
+        ret = sync_index();
+    }
+
+    pthread_rwlock_unlock(&unifyfs_index_lock);
+    return ret;
+}
+
+/* Called by a writer that found the index full. Syncs the index with
+ * the server, or with asynchronous flushing, hands the full buffer to
+ * the flush thread so that the write can continue in the other one. */
+static int flush_full_index(void)
+{
+    pthread_rwlock_wrlock(&unifyfs_index_lock);
+
+    /* another writer may have already made room */
+    int full = (*unifyfs_indices.ptr_num_entries >=
+                unifyfs_max_index_entries);
+    if (unifyfs_flatten_writes &&
+        ((unifyfs_segment_count + WRITE_SEGMENT_RESERVE) >
+         unifyfs_max_index_entries)) {
+        full = 1;
+    }
+
+    int ret = UNIFYFS_SUCCESS;
+    if (full) {
+        if (unifyfs_async_index) {
+            ret = swap_index_bufs();
+        } else {
+            ret = sync_index();
+        }
+    }
+
+    pthread_rwlock_unlock(&unifyfs_index_lock);
+    return ret;
+}
+
+/*
+ * Sync the extents of the given file to the server, leaving those of
+ * other files in the index.
+ *
+ * Returns 0 on success, nonzero otherwise.
+ */
+int unifyfs_sync_file(unifyfs_filemeta_t* meta)
+{
+    /* wait for in-progress writers to finish their index updates */
+    pthread_rwlock_wrlock(&unifyfs_index_lock);
+
+    /* earlier extents must reach the server before those we send */
+    int ret = finish_index_flush();
+    if (ret == UNIFYFS_SUCCESS) {
+        ret = sync_file_index(meta);
+    }
+
+    pthread_rwlock_unlock(&unifyfs_index_lock);
+    return ret;
+}
+
+/* Scan an index buffer for entries of the given file, see
+ * unifyfs_find_unsynced() */
+static void scan_index_entries(unifyfs_index_t* idxs,
+                               size_t num_entries,
+                               int gfid,
+                               size_t start,
+                               size_t end,
+                               int* overlap,
+                               size_t* size)
+{
+    for (size_t i = 0; i < num_entries; i++) {
+        unifyfs_index_t* idx = &idxs[i];
+        if ((idx->gfid != gfid) || (idx->length == 0)) {
+            continue;
+        }
+
+        size_t ext_start = (size_t) idx->file_pos;
+        size_t ext_end   = ext_start + idx->length - 1;
+        if ((ext_start <= end) && (ext_end >= start)) {
+            *overlap = 1;
+        }
+        if ((ext_end + 1) > *size) {
+            *size = ext_end + 1;
+        }
+    }
+}
+
+/*
+ * Look up the writes of the given file that have not yet been synced
+ * to the server. Sets overlap to 1 if any of them intersects the byte
+ * range [start, end], and sets size to one past the last byte they
+ * cover, or to 0 if there are none.
+ */
+void unifyfs_find_unsynced(unifyfs_filemeta_t* meta,
+                           size_t start,
+                           size_t end,
+                           int* overlap,
+                           size_t* size)
+{
+    int gfid = meta->gfid;
+
+    *overlap = 0;
+    *size    = 0;
+
+    if (unifyfs_flatten_writes) {
+        /* the segment tree holds the unsynced writes of the file */
+        pthread_rwlock_rdlock(&unifyfs_index_lock);
+        if (seg_tree_find(&meta->extents_sync, start, end) != NULL) {
+            *overlap = 1;
+        }
+        if (seg_tree_count(&meta->extents_sync) > 0) {
+            *size = seg_tree_max(&meta->extents_sync) + 1;
+        }
+    } else {
+        /* entries are added to the index buffer without holding the
+         * lock for writing, so wait for writers to finish theirs */
+        pthread_rwlock_wrlock(&unifyfs_index_lock);
+        scan_index_entries(unifyfs_indices.index_entry,
+                           *unifyfs_indices.ptr_num_entries,
+                           gfid, start, end, overlap, size);
+    }
+
+    /* extents handed to the flush thread may not be on the server yet,
+     * the buffer is not reused while we hold the index lock */
+    pthread_mutex_lock(&flush_lock);
+    int index_buf = flush_buf;
+    if (-1 == index_buf) {
+        index_buf = failed_buf;
+    }
+    if (-1 != index_buf) {
+        unifyfs_index_buf_t* buf = &unifyfs_index_bufs[index_buf];
+        scan_index_entries(buf->index_entry, *(buf->ptr_num_entries),
+                           gfid, start, end, overlap, size);
+    }
+    pthread_mutex_unlock(&flush_lock);
+
+    pthread_rwlock_unlock(&unifyfs_index_lock);
+}
+
 /* ---------------------------------------
  * Operations on file storage
  * --------------------------------------- */
@@ -371,6 +835,32 @@ int unifyfs_fid_logio_write(int fid,
                             const void* buf,
                             size_t count,
                             size_t* nwritten)
+{
+    struct iovec iov;
+    iov.iov_base = (void*) buf;
+    iov.iov_len  = count;
+    return unifyfs_fid_logio_writev(fid, meta, pos, &iov, 1, nwritten);
+}
+
+/**
+ * Write a vector of buffers to contiguous file space using log-based
+ * I/O. The data goes into a single log allocation and is described by
+ * a single index entry.
+ *
+ * @param fid       file id to write to
+ * @param meta      metadata for file
+ * @param pos       file position to start writing at
+ * @param iov       user buffers holding data
+ * @param iovcnt    number of user buffers
+ * @param nwritten  number of bytes written
+ * @return UNIFYFS_SUCCESS, or error code
+ */
+int unifyfs_fid_logio_writev(int fid,
+                             unifyfs_filemeta_t* meta,
+                             off_t pos,
+                             const struct iovec* iov,
+                             int iovcnt,
+                             size_t* nwritten)
 {
     /* assume we'll fail to write anything */
     *nwritten = 0;
@@ -381,6 +871,15 @@ int unifyfs_fid_logio_write(int fid,
         return EINVAL;
     }
 
+    /* total number of bytes to write */
+    size_t count = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        count += iov[i].iov_len;
+    }
+    if (count == 0) {
+        return UNIFYFS_SUCCESS;
+    }
+
     /* allocate space in the log for this write */
     off_t log_off;
     int rc = unifyfs_logio_alloc(logio_ctx, count, &log_off);
@@ -389,16 +888,37 @@ int unifyfs_fid_logio_write(int fid,
         return rc;
     }
 
-    /* do the write */
-    rc = unifyfs_logio_write(logio_ctx, log_off, count, buf, nwritten);
-    if (rc != UNIFYFS_SUCCESS) {
-        LOGERR("logio_write(%zu, %zu) failed", log_off, count);
-        return rc;
+    /* copy each buffer into the log after the previous one */
+    for (int i = 0; i < iovcnt; i++) {
+        size_t len = iov[i].iov_len;
+        if (len == 0) {
+            continue;
+        }
+
+        size_t written = 0;
+        rc = unifyfs_logio_write(logio_ctx, log_off + *nwritten, len,
+                                 iov[i].iov_base, &written);
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGERR("logio_write(%zu, %zu) failed",
+                   (size_t)log_off + *nwritten, len);
+            unifyfs_logio_free(logio_ctx, log_off, count);
+            *nwritten = 0;
+            return rc;
+        }
+
+        *nwritten += written;
+        if (written < len) {
+            break;
+        }
     }
 
     if (*nwritten < count) {
         LOGWARN("partial logio_write() @ offset=%zu (%zu of %zu bytes)",
                 (size_t)log_off, *nwritten, count);
+
+        /* return log space we did not write */
+        unifyfs_logio_free(logio_ctx, log_off + *nwritten,
+                           count - *nwritten);
     } else {
         LOGDBG("successful logio_write() @ log offset=%zu (%zu bytes)",
                (size_t)log_off, count);
@@ -51,6 +51,24 @@ void unifyfs_rewrite_index_from_seg_tree(void);
 /* sync all writes from client's index with local server */
 int unifyfs_sync(void);
 
+/* sync writes of one file from client's index with local server */
+int unifyfs_sync_file(unifyfs_filemeta_t* meta);
+
+/* check whether unsynced writes of a file overlap a byte range,
+ * and how far they extend the file */
+void unifyfs_find_unsynced(
+    unifyfs_filemeta_t* meta, /* meta data for file */
+    size_t start,             /* first byte of range */
+    size_t end,               /* last byte of range */
+    int* overlap,             /* set to 1 if any write overlaps range */
+    size_t* size              /* set to end of the last unsynced write */
+);
+
+/* start and stop the thread that flushes full index buffers to the
+ * local server in the background */
+int unifyfs_index_flusher_start(void);
+void unifyfs_index_flusher_stop(void);
+
 /* write data to file using log-based I/O */
 int unifyfs_fid_logio_write(
     int fid,                  /* file id to write to */
@@ -61,4 +79,14 @@ int unifyfs_fid_logio_write(
     size_t* nwritten          /* returns number of bytes written */
 );
 
+/* write a vector of buffers to file using log-based I/O */
+int unifyfs_fid_logio_writev(
+    int fid,                  /* file id to write to */
+    unifyfs_filemeta_t* meta, /* meta data for file */
+    off_t pos,                /* file position to start writing at */
+    const struct iovec* iov,  /* user buffers holding data */
+    int iovcnt,               /* number of user buffers */
+    size_t* nwritten          /* returns number of bytes written */
+);
+
 #endif /* UNIFYFS_FIXED_H */
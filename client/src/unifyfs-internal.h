@@ -272,6 +272,7 @@ enum {FILE_STORAGE_NULL = 0, FILE_STORAGE_LOGIO};
 typedef struct {
     off_t global_size;            /* Global size of the file */
     pthread_spinlock_t fspinlock; /* file lock variable */
+    pthread_mutex_t extents_lock; /* serializes updates to extent trees */
     enum flock_enum flock_status; /* file lock status */
 
     int storage;                  /* FILE_STORAGE type */
@@ -289,8 +290,8 @@ typedef struct {
 } unifyfs_filemeta_t;
 
 /* struct used to map a full path to its local file id,
- * an array of these is kept and a simple linear search
- * is used to find a match */
+ * an array of these is kept and a hash table on the
+ * name is used to find a match */
 typedef struct {
     /* flag incidating whether slot is in use */
     int in_use;
@@ -324,12 +325,25 @@ typedef struct {
     unifyfs_index_t* index_entry;
 } unifyfs_index_buf_t;
 
+/* index buffer that writes are added to, and all index buffers in the
+ * superblock (a second buffer exists when flushing asynchronously) */
 extern unifyfs_index_buf_t unifyfs_indices;
+extern unifyfs_index_buf_t unifyfs_index_bufs[2];
+extern int unifyfs_num_index_bufs;
 extern unsigned long unifyfs_max_index_entries;
 
+/* writers append to the index buffer while holding this lock for
+ * reading, syncing the index with the server holds it for writing */
+extern pthread_rwlock_t unifyfs_index_lock;
+
 /* tracks total number of unsync'd segments for all files */
 extern unsigned long unifyfs_segment_count;
 
+/* number of segments reserved by each write, a write adds at most two
+ * index entries, each of which creates at most two new segments,
+ * so the index must hold at least this many entries */
+#define WRITE_SEGMENT_RESERVE 4
+
 /* shmem context for read-request replies data region */
 extern shm_context* shm_recv_ctx;
 
@@ -357,8 +371,8 @@ extern int unifyfs_initialized;
 
 /* list of file name structures of fixed length,
  * used to map a full path to its local file id,
- * an array of these is kept and a simple linear search
- * is used to find a match */
+ * an array of these is kept and a hash table on
+ * the name is used to find a match */
 extern unifyfs_filename_t* unifyfs_filelist;
 
 /* mount directory */
@@ -396,6 +410,12 @@ extern pthread_mutex_t unifyfs_stack_mutex;
 extern int    unifyfs_max_files;  /* maximum number of files to store */
 extern bool   unifyfs_flatten_writes; /* enable write flattening */
 extern bool   unifyfs_local_extents;  /* enable tracking of local extents */
+extern bool   unifyfs_direct_read;    /* server places read data in buffers */
+extern bool   unifyfs_node_local_reads; /* read co-located clients' logs */
+extern bool   unifyfs_spill_mmap;       /* read spilled data via mapping */
+extern bool   unifyfs_async_index;    /* flush index buffers in background */
+extern long   unifyfs_attr_lease;     /* lease in ms on cached attributes */
+extern long   unifyfs_read_timeout;   /* secs to wait for server read data */
 
 /* -------------------------------
  * Common functions
@@ -437,6 +457,11 @@ int unifyfs_intercept_dirstream(DIR* dirp);
 /* given a path, return the file id */
 int unifyfs_get_fid_from_path(const char* path);
 
+/* add file id to, or remove it from, the tables used to look up
+ * a file id by its path and gfid */
+void unifyfs_fid_map_add(int fid);
+void unifyfs_fid_map_remove(int fid);
+
 /* given a file descriptor, return the file id */
 int unifyfs_get_fid_from_fd(int fd);
 
@@ -528,6 +553,15 @@ int unifyfs_fid_write(
     size_t* nwritten /* returns number of bytes written */
 );
 
+/* write data from a vector of buffers into file starting at offset pos */
+int unifyfs_fid_writev(
+    int fid,                 /* local file id to write to */
+    off_t pos,               /* starting offset within file */
+    const struct iovec* iov, /* buffers of data to be written */
+    int iovcnt,              /* number of buffers */
+    size_t* nwritten         /* returns number of bytes written */
+);
+
 /* truncate file id to given length, frees resources if length is
  * less than size and allocates and zero-fills new bytes if length
  * is more than size */
@@ -536,6 +570,10 @@ int unifyfs_fid_truncate(int fid, off_t length);
 /* sync data for file id to server if needed */
 int unifyfs_fid_sync(int fid);
 
+/* sync data for file id to server if needed before reading count bytes
+ * at pos, skipped if no unsynced write overlaps the range */
+int unifyfs_fid_sync_extent(int fid, off_t pos, size_t count);
+
 /* opens a new file id with specified path, access flags, and permissions,
  * fills outfid with file id and outpos with position for current file pointer,
  * returns UNIFYFS error code */
@@ -566,6 +604,14 @@ int unifyfs_get_global_file_meta(
     int gfid,
     unifyfs_file_attr_t* gfattr);
 
+/* get the global size of a file that is not laminated, using the
+ * attribute cache when it holds a current value */
+int unifyfs_get_global_file_size(int gfid, size_t* size);
+
+/* drop cached attributes of gfid, or of all files that are not
+ * laminated if gfid is -1 */
+void unifyfs_attr_cache_invalidate(int gfid);
+
 // These require types/structures defined above
 #include "unifyfs-fixed.h"
 #include "unifyfs-stdio.h"
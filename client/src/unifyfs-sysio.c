@@ -205,7 +205,9 @@ int UNIFYFS_WRAP(rename)(const char* oldpath, const char* newpath)
         /* finally overwrite the old name with the new name */
         LOGDBG("Changing %s to %s",
                (char*)&unifyfs_filelist[fid].filename, new_upath);
+        unifyfs_fid_map_remove(fid);
         strcpy((void*)&unifyfs_filelist[fid].filename, new_upath);
+        unifyfs_fid_map_add(fid);
 
         /* success */
         return 0;
@@ -251,6 +253,7 @@ int UNIFYFS_WRAP(truncate)(const char* path, off_t length)
             /* invoke truncate rpc */
             int gfid = unifyfs_generate_gfid(upath);
             int rc = invoke_client_truncate_rpc(gfid, length);
+            unifyfs_attr_cache_invalidate(gfid);
             if (rc != UNIFYFS_SUCCESS) {
                 LOGDBG("truncate rpc failed %s in UNIFYFS", upath);
                 errno = EIO;
@@ -361,7 +364,7 @@ static int unifyfs_get_meta_with_size(int gfid, unifyfs_file_attr_t* pfattr)
     if (!pfattr->is_laminated) {
         /* lookup current global file size */
         size_t filesize;
-        ret = invoke_client_filesize_rpc(gfid, &filesize);
+        ret = unifyfs_get_global_file_size(gfid, &filesize);
         if (ret == UNIFYFS_SUCCESS) {
             /* success, we have a file size value */
             pfattr->size = (uint64_t) filesize;
@@ -602,6 +605,29 @@ int UNIFYFS_WRAP(fstatfs)(int fd, struct statfs* fsbuf)
  * POSIX wrappers: file descriptors
  * --------------------------------------- */
 
+/* compute total length of an I/O vector, returns EINVAL if the vector
+ * is invalid or its length would overflow */
+static int iov_total_length(const struct iovec* iov, int iovcnt,
+                            size_t* count)
+{
+    *count = 0;
+    if ((iovcnt < 0) || (iovcnt > IOV_MAX)) {
+        return EINVAL;
+    }
+
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        size_t len = iov[i].iov_len;
+        if (len > (size_t)SSIZE_MAX - total) {
+            return EINVAL;
+        }
+        total += len;
+    }
+
+    *count = total;
+    return UNIFYFS_SUCCESS;
+}
+
 /*
  * Read 'count' bytes info 'buf' from file starting at offset 'pos'.
  *
@@ -609,6 +635,20 @@ int UNIFYFS_WRAP(fstatfs)(int fd, struct statfs* fsbuf)
  * case errno will be set.
  */
 int unifyfs_fd_read(int fd, off_t pos, void* buf, size_t count, size_t* nread)
+{
+    struct iovec iov;
+    iov.iov_base = buf;
+    iov.iov_len  = count;
+    return unifyfs_fd_readv(fd, pos, &iov, 1, nread);
+}
+
+/*
+ * Read into a vector of buffers from file starting at offset 'pos',
+ * filling each buffer before the next, with a single read request
+ * per buffer issued together.
+ */
+int unifyfs_fd_readv(int fd, off_t pos, const struct iovec* iov, int iovcnt,
+                     size_t* nread)
 {
     /* assume we'll fail, set bytes read to 0 as a clue */
     *nread = 0;
@@ -631,6 +671,13 @@ int unifyfs_fd_read(int fd, off_t pos, void* buf, size_t count, size_t* nread)
         return EBADF;
     }
 
+    /* get total number of bytes to read */
+    size_t count;
+    int ret = iov_total_length(iov, iovcnt, &count);
+    if (ret != UNIFYFS_SUCCESS) {
+        return ret;
+    }
+
     /* TODO: is it safe to assume that off_t is bigger than size_t? */
     /* check that we don't overflow the file length */
     if (unifyfs_would_overflow_offt(pos, (off_t) count)) {
@@ -644,32 +691,62 @@ int unifyfs_fd_read(int fd, off_t pos, void* buf, size_t count, size_t* nread)
     }
 
     /* TODO: handle error if sync fails? */
-    /* sync data for file before reading, if needed */
-    unifyfs_fid_sync(fid);
-
-    /* fill in read request */
-    read_req_t req;
-    req.gfid    = unifyfs_gfid_from_fid(fid);
-    req.offset  = (size_t) pos;
-    req.length  = count;
-    req.nread   = 0;
-    req.errcode = UNIFYFS_SUCCESS;
-    req.buf     = buf;
+    /* sync data for file before reading, if the read
+     * overlaps unsynced writes */
+    unifyfs_fid_sync_extent(fid, pos, count);
+
+    /* fill in a read request for each non-empty buffer */
+    read_req_t one_req;
+    read_req_t* reqs = &one_req;
+    if (iovcnt > 1) {
+        reqs = (read_req_t*) calloc(iovcnt, sizeof(read_req_t));
+        if (NULL == reqs) {
+            return ENOMEM;
+        }
+    }
+    int reqcnt = 0;
+    size_t offset = (size_t) pos;
+    for (int i = 0; i < iovcnt; i++) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+        reqs[reqcnt].gfid    = unifyfs_gfid_from_fid(fid);
+        reqs[reqcnt].offset  = offset;
+        reqs[reqcnt].length  = iov[i].iov_len;
+        reqs[reqcnt].nread   = 0;
+        reqs[reqcnt].errcode = UNIFYFS_SUCCESS;
+        reqs[reqcnt].buf     = (char*) iov[i].iov_base;
+        offset += iov[i].iov_len;
+        reqcnt++;
+    }
 
     /* execute read operation */
-    int ret = unifyfs_gfid_read_reqs(&req, 1);
+    ret = unifyfs_gfid_read_reqs(reqs, reqcnt);
     if (ret != UNIFYFS_SUCCESS) {
         /* failed to issue read operation */
-        return EIO;
-    } else if (req.errcode != UNIFYFS_SUCCESS) {
-        /* read executed, but failed */
-        return EIO;
+        ret = EIO;
+    } else {
+        /* count bytes up to the first short read, which hit end of file */
+        for (int i = 0; i < reqcnt; i++) {
+            if (reqs[i].errcode != UNIFYFS_SUCCESS) {
+                /* read executed, but failed */
+                ret = EIO;
+                break;
+            }
+            *nread += reqs[i].nread;
+            if (reqs[i].nread < reqs[i].length) {
+                break;
+            }
+        }
+        if (ret != UNIFYFS_SUCCESS) {
+            *nread = 0;
+        }
     }
 
-    /* success, get number of bytes read from read request field */
-    *nread = req.nread;
-
-    return UNIFYFS_SUCCESS;
+    if (reqs != &one_req) {
+        free(reqs);
+    }
+    return ret;
 }
 
 /*
@@ -680,6 +757,20 @@ int unifyfs_fd_read(int fd, off_t pos, void* buf, size_t count, size_t* nread)
  */
 int unifyfs_fd_write(int fd, off_t pos, const void* buf, size_t count,
     size_t* nwritten)
+{
+    struct iovec iov;
+    iov.iov_base = (void*) buf;
+    iov.iov_len  = count;
+    return unifyfs_fd_writev(fd, pos, &iov, 1, nwritten);
+}
+
+/*
+ * Write a vector of buffers into contiguous file space starting at
+ * offset 'pos', as a single write to the log.  O_APPEND behavior is
+ * ignored, as in unifyfs_fd_write().
+ */
+int unifyfs_fd_writev(int fd, off_t pos, const struct iovec* iov, int iovcnt,
+    size_t* nwritten)
 {
     /* assume we'll fail, set bytes written to 0 as a clue */
     *nwritten = 0;
@@ -701,6 +792,13 @@ int unifyfs_fd_write(int fd, off_t pos, const void* buf, size_t count,
         return EBADF;
     }
 
+    /* get total number of bytes to write */
+    size_t count;
+    int ret = iov_total_length(iov, iovcnt, &count);
+    if (ret != UNIFYFS_SUCCESS) {
+        return ret;
+    }
+
     /* TODO: is it safe to assume that off_t is bigger than size_t? */
     /* check that our write won't overflow the length */
     if (unifyfs_would_overflow_offt(pos, (off_t) count)) {
@@ -709,7 +807,7 @@ int unifyfs_fd_write(int fd, off_t pos, const void* buf, size_t count,
     }
 
     /* finally write specified data to file */
-    int write_rc = unifyfs_fid_write(fid, pos, buf, count, nwritten);
+    int write_rc = unifyfs_fid_writev(fid, pos, iov, iovcnt, nwritten);
     return write_rc;
 }
 
@@ -1167,59 +1265,76 @@ ssize_t UNIFYFS_WRAP(write)(int fd, const void* buf, size_t count)
 
 ssize_t UNIFYFS_WRAP(readv)(int fd, const struct iovec* iov, int iovcnt)
 {
-    ssize_t ret;
-
     /* check whether we should intercept this file descriptor */
-    int origfd = fd;
     if (unifyfs_intercept_fd(&fd)) {
-        ssize_t rret;
-        int i;
-        ret = 0;
-        for (i = 0; i < iovcnt; i++) {
-            rret = UNIFYFS_WRAP(read)(origfd, (void*)iov[i].iov_base,
-                iov[i].iov_len);
-            if (-1 == rret) {
-                return -1;
-            } else if (0 == rret) {
-                return ret;
-            } else {
-                ret += rret;
-            }
+        /* get pointer to file descriptor structure */
+        unifyfs_fd_t* filedesc = unifyfs_get_filedesc_from_fd(fd);
+        if (filedesc == NULL) {
+            /* ERROR: invalid file descriptor */
+            errno = EBADF;
+            return (ssize_t)(-1);
         }
-        return ret;
+
+        /* execute read of all buffers */
+        size_t bytes;
+        int read_rc = unifyfs_fd_readv(fd, filedesc->pos, iov, iovcnt,
+                                       &bytes);
+        if (read_rc != UNIFYFS_SUCCESS) {
+            /* read operation failed */
+            errno = unifyfs_rc_errno(read_rc);
+            return (ssize_t)(-1);
+        }
+
+        /* success, update file pointer position */
+        filedesc->pos += (off_t)bytes;
+
+        /* return number of bytes read */
+        return (ssize_t)bytes;
     } else {
         MAP_OR_FAIL(readv);
-        ret = UNIFYFS_REAL(readv)(fd, iov, iovcnt);
+        ssize_t ret = UNIFYFS_REAL(readv)(fd, iov, iovcnt);
         return ret;
     }
 }
 
 ssize_t UNIFYFS_WRAP(writev)(int fd, const struct iovec* iov, int iovcnt)
 {
-    ssize_t ret;
-
     /* check whether we should intercept this file descriptor */
-    int origfd = fd;
     if (unifyfs_intercept_fd(&fd)) {
-        ssize_t wret;
-        int i;
-        ret = 0;
-        for (i = 0; i < iovcnt; i++) {
-            wret = UNIFYFS_WRAP(write)(origfd, (const void*)iov[i].iov_base,
-                iov[i].iov_len);
-            if (-1 == wret) {
-                return -1;
-            } else {
-                ret += wret;
-                if ((size_t)wret != iov[i].iov_len) {
-                    return ret;
-                }
-            }
+        /* get pointer to file descriptor structure */
+        unifyfs_fd_t* filedesc = unifyfs_get_filedesc_from_fd(fd);
+        if (filedesc == NULL) {
+            /* ERROR: invalid file descriptor */
+            errno = EBADF;
+            return (ssize_t)(-1);
         }
-        return ret;
+
+        /* compute starting position to write within file,
+         * assume at current position on file descriptor */
+        off_t pos = filedesc->pos;
+        if (filedesc->append) {
+            /* With O_APPEND we always write to the end */
+            int fid = unifyfs_get_fid_from_fd(fd);
+            pos = unifyfs_fid_logical_size(fid);
+        }
+
+        /* write data of all buffers to file */
+        size_t bytes;
+        int write_rc = unifyfs_fd_writev(fd, pos, iov, iovcnt, &bytes);
+        if (write_rc != UNIFYFS_SUCCESS) {
+            /* write failed */
+            errno = unifyfs_rc_errno(write_rc);
+            return (ssize_t)(-1);
+        }
+
+        /* update file position */
+        filedesc->pos = pos + bytes;
+
+        /* return number of bytes written */
+        return (ssize_t)bytes;
     } else {
         MAP_OR_FAIL(writev);
-        ret = UNIFYFS_REAL(writev)(fd, iov, iovcnt);
+        ssize_t ret = UNIFYFS_REAL(writev)(fd, iov, iovcnt);
         return ret;
     }
 }
@@ -1265,8 +1380,10 @@ int UNIFYFS_WRAP(lio_listio)(int mode, struct aiocb* const aiocb_list[],
                     AIOCB_ERROR_CODE(cbp) = EINVAL;
                 } else {
                     /* TODO: handle error if sync fails? */
-                    /* sync data for file before reading, if needed */
-                    unifyfs_fid_sync(fid);
+                    /* sync data for file before reading, if the read
+                     * overlaps unsynced writes */
+                    unifyfs_fid_sync_extent(fid, cbp->aio_offset,
+                                            cbp->aio_nbytes);
 
                     /* define read request for this file */
                     reqs[reqcnt].gfid    = unifyfs_gfid_from_fid(fid);
@@ -1344,8 +1461,9 @@ ssize_t UNIFYFS_WRAP(pread)(int fd, void* buf, size_t count, off_t offset)
         }
 
         /* TODO: handle error if sync fails? */
-        /* sync data for file before reading, if needed */
-        unifyfs_fid_sync(fid);
+        /* sync data for file before reading, if the read
+         * overlaps unsynced writes */
+        unifyfs_fid_sync_extent(fid, offset, count);
 
         /* fill in read request */
         read_req_t req;
@@ -1440,6 +1558,112 @@ ssize_t UNIFYFS_WRAP(pwrite64)(int fd, const void* buf, size_t count,
     }
 }
 
+ssize_t UNIFYFS_WRAP(preadv)(int fd, const struct iovec* iov, int iovcnt,
+                             off_t offset)
+{
+    /* equivalent to readv(), except that it shall read from a given
+     * position in the file without changing the file pointer */
+
+    /* check whether we should intercept this file descriptor */
+    if (unifyfs_intercept_fd(&fd)) {
+        /* execute read of all buffers */
+        size_t bytes;
+        int read_rc = unifyfs_fd_readv(fd, offset, iov, iovcnt, &bytes);
+        if (read_rc != UNIFYFS_SUCCESS) {
+            errno = unifyfs_rc_errno(read_rc);
+            return (ssize_t)(-1);
+        }
+
+        /* return number of bytes read */
+        return (ssize_t)bytes;
+    } else {
+        MAP_OR_FAIL(preadv);
+        ssize_t ret = UNIFYFS_REAL(preadv)(fd, iov, iovcnt, offset);
+        return ret;
+    }
+}
+
+ssize_t UNIFYFS_WRAP(pwritev)(int fd, const struct iovec* iov, int iovcnt,
+                              off_t offset)
+{
+    /* equivalent to writev(), except that it writes into a given
+     * position without changing the file pointer */
+
+    /* check whether we should intercept this file descriptor */
+    if (unifyfs_intercept_fd(&fd)) {
+        /* write data of all buffers to file */
+        size_t bytes;
+        int write_rc = unifyfs_fd_writev(fd, offset, iov, iovcnt, &bytes);
+        if (write_rc != UNIFYFS_SUCCESS) {
+            errno = unifyfs_rc_errno(write_rc);
+            return (ssize_t)(-1);
+        }
+
+        /* return number of bytes written */
+        return (ssize_t)bytes;
+    } else {
+        MAP_OR_FAIL(pwritev);
+        ssize_t ret = UNIFYFS_REAL(pwritev)(fd, iov, iovcnt, offset);
+        return ret;
+    }
+}
+
+#ifdef HAVE_PREADV2
+ssize_t UNIFYFS_WRAP(preadv2)(int fd, const struct iovec* iov, int iovcnt,
+                              off_t offset, int flags)
+{
+    /* check whether we should intercept this file descriptor */
+    int origfd = fd;
+    if (unifyfs_intercept_fd(&fd)) {
+        /* the flags are only hints for reads, an offset of -1 reads
+         * at the current file position */
+        if (offset == -1) {
+            return UNIFYFS_WRAP(readv)(origfd, iov, iovcnt);
+        }
+        return UNIFYFS_WRAP(preadv)(origfd, iov, iovcnt, offset);
+    } else {
+        MAP_OR_FAIL(preadv2);
+        ssize_t ret = UNIFYFS_REAL(preadv2)(fd, iov, iovcnt, offset, flags);
+        return ret;
+    }
+}
+#endif
+
+#ifdef HAVE_PWRITEV2
+ssize_t UNIFYFS_WRAP(pwritev2)(int fd, const struct iovec* iov, int iovcnt,
+                               off_t offset, int flags)
+{
+    /* check whether we should intercept this file descriptor */
+    int origfd = fd;
+    if (unifyfs_intercept_fd(&fd)) {
+        /* an offset of -1 writes at the current file position */
+        ssize_t ret;
+        if (offset == -1) {
+            ret = UNIFYFS_WRAP(writev)(origfd, iov, iovcnt);
+        } else {
+            ret = UNIFYFS_WRAP(pwritev)(origfd, iov, iovcnt, offset);
+        }
+
+#if defined(RWF_SYNC) && defined(RWF_DSYNC)
+        /* per-write equivalent of O_SYNC and O_DSYNC */
+        if ((ret > 0) && (flags & (RWF_SYNC | RWF_DSYNC))) {
+            int fid = unifyfs_get_fid_from_fd(fd);
+            int sync_rc = unifyfs_fid_sync(fid);
+            if (sync_rc != UNIFYFS_SUCCESS) {
+                errno = unifyfs_rc_errno(sync_rc);
+                return (ssize_t)(-1);
+            }
+        }
+#endif
+        return ret;
+    } else {
+        MAP_OR_FAIL(pwritev2);
+        ssize_t ret = UNIFYFS_REAL(pwritev2)(fd, iov, iovcnt, offset, flags);
+        return ret;
+    }
+}
+#endif
+
 int UNIFYFS_WRAP(ftruncate)(int fd, off_t length)
 {
     /* check whether we should intercept this file descriptor */
@@ -1778,6 +2002,7 @@ static int __chmod(int fid, mode_t mode)
         (((meta->mode & 0222) & mode) == 0)) {
         /* We're laminating. */
         ret = invoke_client_laminate_rpc(gfid);
+        unifyfs_attr_cache_invalidate(gfid);
         if (ret) {
             LOGERR("chmod: couldn't get the global file size on laminate");
             errno = EIO;
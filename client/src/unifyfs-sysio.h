@@ -85,6 +85,14 @@ UNIFYFS_DECL(pwrite, ssize_t, (int fd, const void* buf, size_t count,
                                off_t offset));
 UNIFYFS_DECL(pwrite64, ssize_t, (int fd, const void* buf, size_t count,
                                  off64_t offset));
+UNIFYFS_DECL(preadv, ssize_t, (int fd, const struct iovec* iov, int iovcnt,
+                               off_t offset));
+UNIFYFS_DECL(pwritev, ssize_t, (int fd, const struct iovec* iov, int iovcnt,
+                                off_t offset));
+UNIFYFS_DECL(preadv2, ssize_t, (int fd, const struct iovec* iov, int iovcnt,
+                                off_t offset, int flags));
+UNIFYFS_DECL(pwritev2, ssize_t, (int fd, const struct iovec* iov, int iovcnt,
+                                 off_t offset, int flags));
 UNIFYFS_DECL(posix_fadvise, int, (int fd, off_t offset, off_t len, int advice));
 UNIFYFS_DECL(lseek, off_t, (int fd, off_t offset, int whence));
 UNIFYFS_DECL(lseek64, off64_t, (int fd, off64_t offset, int whence));
@@ -119,6 +127,19 @@ int unifyfs_fd_read(
     size_t* nread /* number of bytes read */
 );
 
+/*
+ * Read into a vector of buffers from file starting at offset 'pos'.
+ * Returns UNIFYFS_SUCCESS and sets number of bytes actually read in bytes
+ * on success.  Otherwise returns error code on error.
+ */
+int unifyfs_fd_readv(
+    int fd,                  /* file descriptor to read from */
+    off_t pos,               /* offset within file to read from */
+    const struct iovec* iov, /* buffers to hold data */
+    int iovcnt,              /* number of buffers */
+    size_t* nread            /* number of bytes read */
+);
+
 /*
  * Write 'count' bytes from 'buf' into file starting at offset 'pos'.
  * Returns UNIFYFS_SUCCESS and sets number of bytes actually written in bytes
@@ -132,6 +153,19 @@ int unifyfs_fd_write(
     size_t* nwritten /* number of bytes written */
 );
 
+/*
+ * Write a vector of buffers into file starting at offset 'pos'.
+ * Returns UNIFYFS_SUCCESS and sets number of bytes actually written in bytes
+ * on success.  Otherwise returns error code on error.
+ */
+int unifyfs_fd_writev(
+    int fd,                  /* file descriptor to write to */
+    off_t pos,               /* offset within file to write to */
+    const struct iovec* iov, /* buffers holding data to write */
+    int iovcnt,              /* number of buffers */
+    size_t* nwritten         /* number of bytes written */
+);
+
 #include "unifyfs-dirops.h"
 
 #endif /* UNIFYFS_SYSIO_H */
@@ -61,9 +61,14 @@ static int unifyfs_fpos_enabled   = 1;  /* whether we can use fgetpos/fsetpos */
 unifyfs_cfg_t client_cfg;
 
 unifyfs_index_buf_t unifyfs_indices;
+unifyfs_index_buf_t unifyfs_index_bufs[2]; /* index buffers in superblock */
+int unifyfs_num_index_bufs;              /* two if flushed asynchronously */
 static size_t unifyfs_index_buf_size;    /* size of metadata log */
 unsigned long unifyfs_max_index_entries; /* max metadata log entries */
 
+/* guards appends to the index buffer against syncs */
+pthread_rwlock_t unifyfs_index_lock = PTHREAD_RWLOCK_INITIALIZER;
+
 /* tracks total number of unsync'd segments for all files */
 unsigned long unifyfs_segment_count;
 
@@ -90,10 +95,22 @@ static off_t unifyfs_min_long;
 int    unifyfs_max_files;  /* maximum number of files to store */
 bool   unifyfs_flatten_writes; /* flatten our writes (true = enabled) */
 bool   unifyfs_local_extents;  /* track data extents in client to read local */
+bool   unifyfs_direct_read;    /* let server write read data into our buffers */
+bool   unifyfs_node_local_reads; /* read co-located clients' logs directly */
+bool   unifyfs_spill_mmap;       /* read spilled data through a mapping */
+bool   unifyfs_async_index;      /* flush full index buffers in background */
+long   unifyfs_attr_lease;       /* lease in ms on cached attributes */
+long   unifyfs_read_timeout;     /* secs to wait for server read data */
 
 /* log-based I/O context */
 logio_context* logio_ctx;
 
+/* logio contexts for co-located clients of our app whose logs
+ * we attached to for node-local reads, indexed by client id,
+ * along with the attach id of the log owner when we attached */
+static logio_context* peer_logio_ctx[MAX_APP_CLIENTS];
+static uint32_t peer_logio_attach_id[MAX_APP_CLIENTS];
+
 /* keep track of what we've initialized */
 int unifyfs_initialized = 0;
 
@@ -105,6 +122,38 @@ static void* free_fid_stack;
 unifyfs_filename_t* unifyfs_filelist;
 static unifyfs_filemeta_t* unifyfs_filemetas;
 
+/* hash tables mapping the path and the gfid of each file in use
+ * to its file id, one node per file id, kept in process memory
+ * alongside the file list in the superblock */
+typedef struct {
+    int fid;
+    UT_hash_handle hh_path; /* keyed by file name in unifyfs_filelist */
+    UT_hash_handle hh_gfid; /* keyed by gfid in unifyfs_filemetas */
+} fid_map_node_t;
+
+static fid_map_node_t* fid_map_nodes;
+static fid_map_node_t* fid_path_map;
+static fid_map_node_t* fid_gfid_map;
+static pthread_rwlock_t fid_map_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+/* cache of global file attributes and sizes, direct-mapped by gfid
+ * with one entry per file id, kept in the superblock. Attributes of
+ * laminated files never change, so they stay valid until evicted.
+ * Those of other files are valid for unifyfs_attr_lease milliseconds,
+ * and are dropped when this client changes the file. */
+typedef struct {
+    int valid;                 /* entry holds attributes of gfid */
+    int laminated;             /* file was laminated */
+    uint64_t attr_expire;      /* end of attribute lease, in ns */
+    int size_valid;            /* entry holds current size of gfid */
+    uint64_t size_expire;      /* end of size lease, in ns */
+    size_t size;               /* cached file size */
+    unifyfs_file_attr_t attr;  /* cached file attributes */
+} unifyfs_attr_cache_t;
+
+static unifyfs_attr_cache_t* unifyfs_attr_cache;
+static pthread_mutex_t attr_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
 /* TODO: metadata spillover is not currently supported */
 int unifyfs_spillmetablock = -1;
 
@@ -385,22 +434,49 @@ inline int unifyfs_intercept_dirstream(DIR* dirp)
     return 0;
 }
 
+/* add file id to the path and gfid hash tables, its name and gfid
+ * must be set */
+void unifyfs_fid_map_add(int fid)
+{
+    fid_map_node_t* node = &fid_map_nodes[fid];
+    const char* path = unifyfs_filelist[fid].filename;
+    unifyfs_filemeta_t* meta = &unifyfs_filemetas[fid];
+
+    pthread_rwlock_wrlock(&fid_map_lock);
+    node->fid = fid;
+    HASH_ADD_KEYPTR(hh_path, fid_path_map, path, strlen(path), node);
+    HASH_ADD_KEYPTR(hh_gfid, fid_gfid_map, &meta->gfid, sizeof(int), node);
+    pthread_rwlock_unlock(&fid_map_lock);
+}
+
+/* remove file id from the path and gfid hash tables */
+void unifyfs_fid_map_remove(int fid)
+{
+    fid_map_node_t* node = &fid_map_nodes[fid];
+
+    pthread_rwlock_wrlock(&fid_map_lock);
+    HASH_DELETE(hh_path, fid_path_map, node);
+    HASH_DELETE(hh_gfid, fid_gfid_map, node);
+    pthread_rwlock_unlock(&fid_map_lock);
+}
+
 /* given a path, return the file id */
 inline int unifyfs_get_fid_from_path(const char* path)
 {
-    int i = 0;
-    while (i < unifyfs_max_files) {
-        if (unifyfs_filelist[i].in_use &&
-            strcmp((void*)&unifyfs_filelist[i].filename, path) == 0) {
-            LOGDBG("File found: unifyfs_filelist[%d].filename = %s",
-                   i, (char*)&unifyfs_filelist[i].filename);
-            return i;
-        }
-        i++;
+    int fid = -1;
+
+    fid_map_node_t* node;
+    pthread_rwlock_rdlock(&fid_map_lock);
+    HASH_FIND(hh_path, fid_path_map, path, strlen(path), node);
+    if (node != NULL) {
+        fid = node->fid;
+        LOGDBG("File found: unifyfs_filelist[%d].filename = %s",
+               fid, (char*)&unifyfs_filelist[fid].filename);
     }
+    pthread_rwlock_unlock(&fid_map_lock);
 
-    /* couldn't find specified path */
-    return -1;
+    /* returns -1 if we couldn't find specified path */
+    return fid;
 }
 
 /* initialize file descriptor structure for given fd value */
@@ -521,6 +597,39 @@ static int fid_store_alloc(int fid)
     return UNIFYFS_SUCCESS;
 }
 
+/* release log space holding data for the file at or beyond the
+ * given offset, and drop those extents from the local extent tree,
+ * assumes any writes to the file have been synced with the server */
+static void fid_reclaim_log(unifyfs_filemeta_t* meta, off_t offset)
+{
+    unsigned long start = (unsigned long) offset;
+
+    pthread_mutex_lock(&meta->extents_lock);
+    seg_tree_wrlock(&meta->extents);
+    struct seg_tree_node* node = NULL;
+    while ((node = seg_tree_iter(&meta->extents, node))) {
+        if (node->end < start) {
+            continue;
+        }
+
+        /* release portion of this extent past the offset */
+        unsigned long skip = 0;
+        if (node->start < start) {
+            skip = start - node->start;
+        }
+        off_t log_pos = (off_t)(node->ptr + skip);
+        size_t nbytes = (size_t)(node->end - node->start + 1 - skip);
+        int rc = unifyfs_logio_free(logio_ctx, log_pos, nbytes);
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGWARN("logio_free(%zu, %zu) failed", (size_t)log_pos, nbytes);
+        }
+    }
+    seg_tree_unlock(&meta->extents);
+
+    seg_tree_remove(&meta->extents, start, ULONG_MAX);
+    pthread_mutex_unlock(&meta->extents_lock);
+}
+
 /* free data management resource for file */
 static int fid_store_free(int fid)
 {
@@ -536,9 +645,7 @@ static int fid_store_free(int fid)
     }
 
     /* Free our extent seg_tree */
-    if (unifyfs_local_extents) {
-        seg_tree_destroy(&meta->extents);
-    }
+    seg_tree_destroy(&meta->extents);
 
     return UNIFYFS_SUCCESS;
 }
@@ -570,49 +677,47 @@ static int compare_read_req(const void* a, const void* b)
     }
 }
 
-/* notify our delegator that the shared memory buffer
- * is now clear and ready to hold more read data */
+/* notify our delegator that the shared memory segment we are
+ * draining is now clear and ready to hold more read data */
 static void delegator_signal(void)
 {
     LOGDBG("receive buffer now empty");
 
-    /* set shm flag to signal delegator we're done */
+    /* reset counts and set shm flag to signal delegator we're done */
     shm_data_header* hdr = (shm_data_header*)(shm_recv_ctx->addr);
-    hdr->state = SHMEM_REGION_EMPTY;
+    shm_data_segment* seg = hdr->segs + hdr->cons_seg;
+    seg->meta_cnt = 0;
+    seg->bytes = 0;
+    unifyfs_shm_segment_signal(seg, SHMEM_REGION_EMPTY);
+}
 
-    /* TODO: MEM_FLUSH */
+/* move on to the next shared memory segment the delegator fills,
+ * or back to the first segment once all read data has arrived */
+static void delegator_advance(int done)
+{
+    shm_data_header* hdr = (shm_data_header*)(shm_recv_ctx->addr);
+    if (done) {
+        hdr->cons_seg = 0;
+    } else {
+        hdr->cons_seg = (hdr->cons_seg + 1) % SHMEM_DATA_SEGMENTS;
+    }
 }
 
-/* wait for delegator to inform us that shared memory buffer
+/* wait for delegator to inform us that shared memory segment
  * is filled with read data */
 static int delegator_wait(void)
 {
-    int rc = (int)UNIFYFS_SUCCESS;
-
-    /* specify time to sleep between checking flag in shared
-     * memory indicating server has produced */
-    struct timespec shm_wait_tm;
-    shm_wait_tm.tv_sec  = 0;
-    shm_wait_tm.tv_nsec = SHM_WAIT_INTERVAL;
-
     /* get pointer to flag in shared memory */
     shm_data_header* hdr = (shm_data_header*)(shm_recv_ctx->addr);
+    shm_data_segment* seg = hdr->segs + hdr->cons_seg;
 
-    /* wait for server to set flag to non-zero */
-    int max_sleep = 5000000; // 5s
-    volatile int* vip = (volatile int*)&(hdr->state);
-    while (*vip == SHMEM_REGION_EMPTY) {
-        /* not there yet, sleep for a while */
-        nanosleep(&shm_wait_tm, NULL);
-        /* TODO: MEM_FETCH */
-        max_sleep--;
-        if (0 == max_sleep) {
-            LOGERR("timed out waiting for non-empty");
-            rc = (int)UNIFYFS_ERROR_SHMEM;
-            break;
-        }
+    /* wait for server to set flag to non-zero, spinning briefly
+     * before blocking */
+    int rc = unifyfs_shm_segment_wait(seg, SHMEM_REGION_EMPTY,
+                                      0, unifyfs_read_timeout * 1000);
+    if (rc != (int)UNIFYFS_SUCCESS) {
+        LOGERR("timed out waiting for non-empty");
     }
-
     return rc;
 }
 
@@ -624,12 +729,13 @@ static int process_read_data(read_req_t* read_reqs, int count, int* done)
     /* assume we'll succeed */
     int rc = UNIFYFS_SUCCESS;
 
-    /* get pointer to start of shared memory buffer */
+    /* get pointer to start of shared memory segment */
     shm_data_header* shm_hdr = (shm_data_header*)(shm_recv_ctx->addr);
-    char* shmptr = ((char*)shm_hdr) + sizeof(shm_data_header);
+    shm_data_segment* seg = shm_hdr->segs + shm_hdr->cons_seg;
+    char* shmptr = shm_data_segment_buf(shm_hdr, shm_hdr->cons_seg);
 
-    /* get number of read replies in shared memory */
-    size_t num = shm_hdr->meta_cnt;
+    /* get number of read replies in shared memory segment */
+    size_t num = seg->meta_cnt;
 
     /* process each of our read replies */
     size_t i;
@@ -638,9 +744,12 @@ static int process_read_data(read_req_t* read_reqs, int count, int* done)
         shm_data_meta* rep = (shm_data_meta*)shmptr;
         shmptr += sizeof(shm_data_meta);
 
-        /* get pointer to data */
+        /* get pointer to data, which is absent if the server
+         * already placed it in our read buffer */
         char* rep_buf = shmptr;
-        shmptr += rep->length;
+        if (!rep->direct) {
+            shmptr += rep->length;
+        }
 
         /* get start and end offset of reply */
         size_t rep_start = rep->offset;
@@ -711,18 +820,23 @@ static int process_read_data(read_req_t* read_reqs, int count, int* done)
             size_t rep_offset = start - rep_start;
             size_t req_offset = start - req_start;
 
-            /* if we have a gap, fill with zeros */
+            /* if we have a gap, fill with zeros, unless the server
+             * may place data directly, in which case the buffer was
+             * zeroed up front and a gap may hold data placed by a
+             * reply we have not seen yet */
             size_t gap_start = req_start + req->nread;
-            if (start > gap_start) {
+            if (start > gap_start && !unifyfs_direct_read) {
                 size_t gap_length = start - gap_start;
                 char* req_ptr = req->buf + req->nread;
                 memset(req_ptr, 0, gap_length);
             }
 
             /* copy data from reply buffer into request buffer */
-            char* req_ptr = req->buf + req_offset;
-            char* rep_ptr = rep_buf  + rep_offset;
-            memcpy(req_ptr, rep_ptr, length);
+            if (!rep->direct) {
+                char* req_ptr = req->buf + req_offset;
+                char* rep_ptr = rep_buf  + rep_offset;
+                memcpy(req_ptr, rep_ptr, length);
+            }
 
             /* update max number of bytes we have written to in the
              * request buffer */
@@ -734,13 +848,58 @@ static int process_read_data(read_req_t* read_reqs, int count, int* done)
     }
 
     /* set done flag if there is no more data */
-    if (shm_hdr->state == SHMEM_REGION_DATA_COMPLETE) {
+    if (seg->state == SHMEM_REGION_DATA_COMPLETE) {
         *done = 1;
     }
 
     return rc;
 }
 
+/* Returns the extent holding the first byte of the range [start, end)
+ * if the extents of the tree cover the full range without holes,
+ * NULL otherwise. Assumes the tree is locked by the caller. */
+static struct seg_tree_node* find_local_extents(
+    struct seg_tree* extents, /* extent tree of the file */
+    size_t start,             /* first byte of range */
+    size_t end)               /* one past the last byte of range */
+{
+    /* this will point to the offset of the next byte we
+     * need to account for */
+    size_t expected_start = start;
+
+    /* iterate over extents we have for this file,
+     * and check that there are no holes in coverage,
+     * we search for a starting extent using a range
+     * of just the very first byte that we need */
+    struct seg_tree_node* first;
+    first = seg_tree_find_nolock(extents, start, start);
+    struct seg_tree_node* next = first;
+    while (next != NULL && next->start < end) {
+        if (expected_start >= next->start) {
+            /* this extent has the next byte we expect,
+             * bump up to the first byte past the end
+             * of this extent */
+            expected_start = next->end + 1;
+        } else {
+            /* there is a gap between extents so we're missing
+             * some bytes */
+            return NULL;
+        }
+
+        /* get the next element in the tree */
+        next = seg_tree_iter(extents, next);
+    }
+
+    /* check that we account for the full request
+     * up until the last byte */
+    if (expected_start < end) {
+        /* missing some bytes at the end of the request */
+        return NULL;
+    }
+
+    return first;
+}
+
 /* This uses information in the extent map for a file on the client to
  * complete any read requests.  It only complets a request if it contains
  * all of the data.  Otherwise the request is copied to the list of
@@ -799,48 +958,13 @@ static void service_local_reqs(
         /* lock the extent tree for reading */
         seg_tree_rdlock(extents);
 
-        /* identify whether we can satisfy this full request
-         * or not, assume we can */
-        int have_local = 1;
-
-        /* this will point to the offset of the next byte we
-         * need to account for */
-        size_t expected_start = req_start;
-
-        /* iterate over extents we have for this file,
-         * and check that there are no holes in coverage,
-         * we search for a starting extent using a range
-         * of just the very first byte that we need */
+        /* identify whether we can satisfy this full request */
         struct seg_tree_node* first;
-        first = seg_tree_find_nolock(extents, req_start, req_start);
-        struct seg_tree_node* next = first;
-        while (next != NULL && next->start < req_end) {
-            if (expected_start >= next->start) {
-                /* this extent has the next byte we expect,
-                 * bump up to the first byte past the end
-                 * of this extent */
-                expected_start = next->end + 1;
-            } else {
-                /* there is a gap between extents so we're missing
-                 * some bytes */
-                have_local = 0;
-                break;
-            }
-
-            /* get the next element in the tree */
-            next = seg_tree_iter(extents, next);
-        }
-
-        /* check that we account for the full request
-         * up until the last byte */
-        if (expected_start < req_end) {
-            /* missing some bytes at the end of the request */
-            have_local = 0;
-        }
+        first = find_local_extents(extents, req_start, req_end);
 
         /* if we can't fully satisfy the request, copy request to
          * output array, so it can be passed on to server */
-        if (!have_local) {
+        if (first == NULL) {
             /* copy current request into list of requests
              * that we'll ask server for */
             memcpy(&server_reqs[server_count], req, sizeof(read_req_t));
@@ -856,7 +980,7 @@ static void service_local_reqs(
          * over the extents and copy data into request buffer,
          * again search for a starting extent using a range
          * of just the very first byte that we need */
-        next = first;
+        struct seg_tree_node* next = first;
         while ((next != NULL) && (next->start < req_end)) {
             /* get start and end of this extent (reply) */
             size_t rep_start = next->start;
@@ -935,6 +1059,215 @@ static void service_local_reqs(
     return;
 }
 
+/* get logio context for the client log that holds the given extent,
+ * attaching to the log of a co-located client on first use, or again
+ * if that client has attached to the server since */
+static logio_context* get_log_extent_ctx(unifyfs_log_extent_t* ext)
+{
+    int id = ext->log_client_id;
+    if ((ext->log_app_id != unifyfs_app_id) ||
+        (id < 0) || (id >= MAX_APP_CLIENTS)) {
+        return NULL;
+    }
+
+    /* data is in our own log */
+    if (id == unifyfs_client_id) {
+        return logio_ctx;
+    }
+
+    /* drop our attachment to a log that has since been replaced */
+    if ((NULL != peer_logio_ctx[id]) &&
+        (peer_logio_attach_id[id] != ext->log_attach_id)) {
+        LOGDBG("client %d re-attached, refreshing its log", id);
+        unifyfs_logio_close(peer_logio_ctx[id]);
+        peer_logio_ctx[id] = NULL;
+    }
+
+    if (NULL == peer_logio_ctx[id]) {
+        int rc = unifyfs_logio_attach_peer(unifyfs_app_id, id,
+                                           ext->log_mem_size,
+                                           ext->log_spill_size,
+                                           client_cfg.logio_spill_dir,
+                                           &(peer_logio_ctx[id]));
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGERR("failed to attach log of client %d", id);
+            peer_logio_ctx[id] = NULL;
+        } else {
+            peer_logio_attach_id[id] = ext->log_attach_id;
+            if (unifyfs_spill_mmap) {
+                rc = unifyfs_logio_map_spill(peer_logio_ctx[id]);
+                if (rc != UNIFYFS_SUCCESS) {
+                    LOGWARN("failed to map spill file of client %d", id);
+                }
+            }
+        }
+    }
+    return peer_logio_ctx[id];
+}
+
+/* copy the data of a read request from the client logs holding it,
+ * given the locations of its data sorted by file offset,
+ * returns 1 if all data of the request was read, 0 otherwise */
+static int read_from_client_logs(read_req_t* req,
+                                 unifyfs_log_extent_t* exts,
+                                 int num_exts)
+{
+    size_t req_start = req->offset;
+    size_t req_end   = req->offset + req->length;
+
+    /* check that extents cover the full request without holes,
+     * and that we can get at each client log */
+    size_t expected_start = req_start;
+    int j;
+    for (j = 0; j < num_exts; j++) {
+        unifyfs_log_extent_t* ext = exts + j;
+        if ((ext->offset > expected_start) ||
+            (NULL == get_log_extent_ctx(ext))) {
+            return 0;
+        } else if ((ext->offset + ext->length) > expected_start) {
+            expected_start = ext->offset + ext->length;
+        }
+    }
+    if (expected_start < req_end) {
+        return 0;
+    }
+
+    /* copy data from client logs into request buffer */
+    for (j = 0; j < num_exts; j++) {
+        unifyfs_log_extent_t* ext = exts + j;
+
+        /* clip extent to request range */
+        size_t start = ext->offset;
+        if (req_start > start) {
+            start = req_start;
+        }
+        size_t end = ext->offset + ext->length;
+        if (req_end < end) {
+            end = req_end;
+        }
+        if (end <= start) {
+            continue;
+        }
+
+        size_t length = end - start;
+        char* req_ptr = req->buf + (start - req_start);
+        off_t log_offset = (off_t)(ext->log_offset +
+                                   (start - ext->offset));
+        size_t nread = 0;
+        int rc = unifyfs_logio_read(get_log_extent_ctx(ext), log_offset,
+                                    length, req_ptr, &nread);
+        if ((rc != UNIFYFS_SUCCESS) || (nread != length)) {
+            LOGERR("node-local log read failed for offset=%zu size=%zu",
+                   (size_t)log_offset, length);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* This asks our server where the data for the read requests is held,
+ * using a single lookup for all requests, and completes a request by
+ * copying directly from the write logs of clients attached to the same
+ * server (including our own) if all of its data is held there.
+ * Completed requests are copied to local_reqs, while requests that
+ * still need to be handled by the server are compacted to the front
+ * of read_reqs. */
+static void service_node_local_reqs(
+    read_req_t* read_reqs,   /* list of input read requests */
+    int count,               /* number of input read requests */
+    read_req_t* local_reqs,  /* list to copy requests completed by client */
+    int* out_count)          /* number of requests left for server */
+{
+    int local_count  = 0;
+    int server_count = 0;
+
+    *out_count = count;
+
+    unifyfs_log_range_t* ranges = (unifyfs_log_range_t*)
+        malloc(count * sizeof(unifyfs_log_range_t));
+    int* range_reqs = (int*) malloc(count * sizeof(int));
+    char* done = (char*) calloc(count, sizeof(char));
+    unifyfs_log_extent_t* exts = (unifyfs_log_extent_t*)
+        malloc(UNIFYFS_MAX_LOG_EXTENTS * sizeof(unifyfs_log_extent_t));
+    if ((NULL == ranges) || (NULL == range_reqs) ||
+        (NULL == done) || (NULL == exts)) {
+        goto node_local_exit;
+    }
+
+    /* build list of ranges for requests that still need data */
+    int i;
+    int num_ranges = 0;
+    for (i = 0; i < count; i++) {
+        read_req_t* req = &read_reqs[i];
+        if ((req->nread == 0) && (req->errcode == UNIFYFS_SUCCESS)) {
+            ranges[num_ranges].gfid   = (int32_t) req->gfid;
+            ranges[num_ranges].offset = req->offset;
+            ranges[num_ranges].length = req->length;
+            range_reqs[num_ranges] = i;
+            num_ranges++;
+        }
+    }
+    if (0 == num_ranges) {
+        goto node_local_exit;
+    }
+
+    /* get locations of node-local data for all ranges at once,
+     * on failure all requests are left for the server */
+    int num_exts = 0;
+    int num_done = 0;
+    int rc = invoke_client_log_extents_rpc(num_ranges, ranges,
+                                           UNIFYFS_MAX_LOG_EXTENTS, exts,
+                                           &num_exts, &num_done);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGDBG("node-local extent lookup failed, reading through server");
+        goto node_local_exit;
+    }
+
+    /* locations are grouped by range, in range order */
+    int e = 0;
+    int r;
+    for (r = 0; r < num_done; r++) {
+        while ((e < num_exts) && (exts[e].range_index < r)) {
+            e++;
+        }
+        int first = e;
+        while ((e < num_exts) && (exts[e].range_index == r)) {
+            e++;
+        }
+        if (e > first) {
+            read_req_t* req = &read_reqs[range_reqs[r]];
+            done[range_reqs[r]] =
+                (char) read_from_client_logs(req, exts + first, e - first);
+        }
+    }
+
+    /* split requests into those completed here and those
+     * left for the server */
+    for (i = 0; i < count; i++) {
+        read_req_t* req = &read_reqs[i];
+        if (done[i]) {
+            req->nread = req->length;
+            memcpy(&local_reqs[local_count], req, sizeof(read_req_t));
+            local_count++;
+        } else {
+            /* leave request for the server */
+            if (server_count != i) {
+                memcpy(&read_reqs[server_count], req, sizeof(read_req_t));
+            }
+            server_count++;
+        }
+    }
+
+    /* return to user the number of requests left for the server */
+    *out_count = server_count;
+
+node_local_exit:
+    free(ranges);
+    free(range_reqs);
+    free(done);
+    free(exts);
+}
+
 /*
  * get data for a list of read requests from the
  * delegator
@@ -972,7 +1305,7 @@ int unifyfs_gfid_read_reqs(read_req_t* in_reqs, int in_count)
     read_req_t* local_reqs = NULL;
 
     /* attempt to complete requests locally if enabled */
-    if (unifyfs_local_extents) {
+    if (unifyfs_local_extents || unifyfs_node_local_reads) {
         /* allocate space to make local and server copies of the requests,
          * each list will be at most in_count long */
         size_t reqs_size = 2 * in_count * sizeof(read_req_t);
@@ -987,11 +1320,23 @@ int unifyfs_gfid_read_reqs(read_req_t* in_reqs, int in_count)
         local_reqs = &reqs[0];
         read_reqs  = &reqs[in_count];
 
-        /* service reads from local extent info if we can, this copies
-         * completed requests from in_reqs into local_reqs, and it copies
-         * any requests that can't be completed locally into the read_reqs
-         * to be processed by the server */
-        service_local_reqs(in_reqs, in_count, local_reqs, read_reqs, &count);
+        if (unifyfs_local_extents) {
+            /* service reads from local extent info if we can, this copies
+             * completed requests from in_reqs into local_reqs, and it
+             * copies any requests that can't be completed locally into
+             * the read_reqs to be processed by the server */
+            service_local_reqs(in_reqs, in_count, local_reqs, read_reqs,
+                               &count);
+        } else {
+            memcpy(read_reqs, in_reqs, in_count * sizeof(read_req_t));
+        }
+
+        /* service remaining reads from logs of co-located clients */
+        if (unifyfs_node_local_reads && (count > 0)) {
+            int local_count = in_count - count;
+            service_node_local_reqs(read_reqs, count,
+                                    local_reqs + local_count, &count);
+        }
 
         /* bail early if we satisfied all requests locally */
         if (count == 0) {
@@ -1020,6 +1365,20 @@ int unifyfs_gfid_read_reqs(read_req_t* in_reqs, int in_count)
     /* order read request by increasing file id, then increasing offset */
     qsort(read_reqs, count, sizeof(read_req_t), compare_read_req);
 
+    /* if the server may write read data directly into our buffers,
+     * zero the unread portion of each buffer now, since replies may
+     * arrive in any order and holes are not filled later */
+    if (unifyfs_direct_read) {
+        for (i = 0; i < count; i++) {
+            read_req_t* req = &read_reqs[i];
+            if (req->errcode == UNIFYFS_SUCCESS &&
+                req->nread < req->length) {
+                memset(req->buf + req->nread, 0,
+                       req->length - req->nread);
+            }
+        }
+    }
+
     /* prepare our shared memory buffer for delegator */
     delegator_signal();
 
@@ -1042,8 +1401,25 @@ int unifyfs_gfid_read_reqs(read_req_t* in_reqs, int in_count)
 
         /* complete the array */
         unifyfs_Extent_vec_ref_t extents = unifyfs_Extent_vec_end(&builder);
-        unifyfs_ReadRequest_create_as_root(&builder, extents);
-        //unifyfs_ReadRequest_end_as_root(&builder);
+
+        /* add our buffer addresses so the server can place data
+         * directly into them */
+        flatbuffers_uint64_vec_ref_t bufs = 0;
+        if (unifyfs_direct_read) {
+            flatbuffers_uint64_vec_start(&builder);
+            for (i = 0; i < count; i++) {
+                flatbuffers_uint64_vec_push_create(&builder,
+                    (uint64_t)(uintptr_t)read_reqs[i].buf);
+            }
+            bufs = flatbuffers_uint64_vec_end(&builder);
+        }
+
+        unifyfs_ReadRequest_start_as_root(&builder);
+        unifyfs_ReadRequest_extents_add(&builder, extents);
+        if (bufs) {
+            unifyfs_ReadRequest_bufs_add(&builder, bufs);
+        }
+        unifyfs_ReadRequest_end_as_root(&builder);
 
         /* allocate our buffer to be sent */
         size_t size = 0;
@@ -1064,11 +1440,15 @@ int unifyfs_gfid_read_reqs(read_req_t* in_reqs, int in_count)
         int gfid      = read_reqs[0].gfid;
         size_t offset = read_reqs[0].offset;
         size_t length = read_reqs[0].length;
+        size_t buf    = 0;
+        if (unifyfs_direct_read) {
+            buf = (size_t)(uintptr_t)read_reqs[0].buf;
+        }
 
         LOGDBG("read: offset:%zu, len:%zu", offset, length);
 
         /* invoke single read rpc */
-        read_rc = invoke_client_read_rpc(gfid, offset, length);
+        read_rc = invoke_client_read_rpc(gfid, offset, length, buf);
     }
 
     /* bail out with error if we failed to even start the read */
@@ -1086,8 +1466,9 @@ int unifyfs_gfid_read_reqs(read_req_t* in_reqs, int in_count)
      * */
 
     /* spin waiting for read data to come back from the server,
-     * we process it in batches as it comes in, eventually the
-     * server will tell us it's sent us everything it can */
+     * we process it one segment at a time as it comes in while the
+     * server fills the next segment, eventually the server will
+     * tell us it's sent us everything it can */
     int done = 0;
     while (!done) {
         int tmp_rc = delegator_wait();
@@ -1100,6 +1481,7 @@ int unifyfs_gfid_read_reqs(read_req_t* in_reqs, int in_count)
                 rc = UNIFYFS_FAILURE;
             }
             delegator_signal();
+            delegator_advance(done);
         }
     }
 
@@ -1159,10 +1541,10 @@ int unifyfs_gfid_read_reqs(read_req_t* in_reqs, int in_count)
         }
     }
 
-    /* if we attempted to service requests from our local extent map,
-     * then we need to copy the resulting read requests from the local
-     * and server arrays back into the user's original array */
-    if (unifyfs_local_extents) {
+    /* if we attempted to service requests locally, then we need to
+     * copy the resulting read requests from the local and server
+     * arrays back into the user's original array */
+    if (NULL != reqs) {
         /* TODO: would be nice to copy these back into the same order
          * in which we received them. */
 
@@ -1219,20 +1601,21 @@ int unifyfs_gfid_from_fid(const int fid)
     return meta->gfid;
 }
 
-/* scan list of files and return fid corresponding to target gfid,
+/* look up fid corresponding to target gfid,
  * returns -1 if not found */
 int unifyfs_fid_from_gfid(int gfid)
 {
-    int i;
-    for (i = 0; i < unifyfs_max_files; i++) {
-        if (unifyfs_filelist[i].in_use &&
-            unifyfs_filemetas[i].gfid == gfid) {
-            /* found a file id that's in use and it matches
-             * the target fid, this is the one */
-            return i;
-        }
+    int fid = -1;
+
+    fid_map_node_t* node;
+    pthread_rwlock_rdlock(&fid_map_lock);
+    HASH_FIND(hh_gfid, fid_gfid_map, &gfid, sizeof(int), node);
+    if (node != NULL) {
+        fid = node->fid;
     }
-    return -1;
+    pthread_rwlock_unlock(&fid_map_lock);
+
+    return fid;
 }
 
 /* Given a fid, return the path.  */
@@ -1301,17 +1684,27 @@ off_t unifyfs_fid_logical_size(int fid)
     } else {
         /* invoke an rpc to ask the server what the file size is */
 
-        /* sync any writes to disk before requesting file size */
-        unifyfs_fid_sync(fid);
+        /* rather than syncing writes before requesting the file size,
+         * account for the unsynced writes of this process, which can
+         * only extend the size known to the server */
+        size_t unsynced_size = 0;
+        unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(fid);
+        if (meta->needs_sync) {
+            int overlap;
+            unifyfs_find_unsynced(meta, 0, 0, &overlap, &unsynced_size);
+        }
 
         /* get file size for this file */
         size_t filesize;
         int gfid = unifyfs_gfid_from_fid(fid);
-        int ret = invoke_client_filesize_rpc(gfid, &filesize);
+        int ret = unifyfs_get_global_file_size(gfid, &filesize);
         if (ret != UNIFYFS_SUCCESS) {
             /* failed to get file size */
             return (off_t)-1;
         }
+        if (unsynced_size > filesize) {
+            filesize = unsynced_size;
+        }
         return (off_t)filesize;
     }
 }
@@ -1333,7 +1726,7 @@ off_t unifyfs_gfid_filesize(int gfid)
         /* no fid for this gfid,
          * look it up with server rpc */
         size_t size;
-        int ret = invoke_client_filesize_rpc(gfid, &size);
+        int ret = unifyfs_get_global_file_size(gfid, &size);
         if (ret == UNIFYFS_SUCCESS) {
             /* got the file size successfully */
             filesize = size;
@@ -1367,6 +1760,140 @@ int unifyfs_fid_update_file_meta(int fid, unifyfs_file_attr_t* gfattr)
     return UNIFYFS_FAILURE;
 }
 
+/* current time in ns, used for attribute leases */
+static uint64_t attr_cache_now(void)
+{
+    struct timespec tp;
+    clock_gettime(CLOCK_MONOTONIC, &tp);
+    return ((uint64_t)tp.tv_sec * 1000000000) + (uint64_t)tp.tv_nsec;
+}
+
+/* return cache entry for gfid */
+static unifyfs_attr_cache_t* attr_cache_entry(int gfid)
+{
+    return &unifyfs_attr_cache[(unsigned int)gfid % unifyfs_max_files];
+}
+
+/* copy cached attributes of gfid into attr, returns 1 on a hit */
+static int attr_cache_get(int gfid, unifyfs_file_attr_t* attr)
+{
+    int hit = 0;
+    pthread_mutex_lock(&attr_cache_lock);
+    unifyfs_attr_cache_t* ent = attr_cache_entry(gfid);
+    if (ent->valid && (ent->attr.gfid == gfid) &&
+        (ent->laminated || (attr_cache_now() < ent->attr_expire))) {
+        *attr = ent->attr;
+        hit = 1;
+    }
+    pthread_mutex_unlock(&attr_cache_lock);
+    return hit;
+}
+
+/* record attributes fetched from the server */
+static void attr_cache_put(int gfid, unifyfs_file_attr_t* attr)
+{
+    if (!attr->is_laminated && (unifyfs_attr_lease <= 0)) {
+        /* we only cache attributes that can't change */
+        return;
+    }
+
+    pthread_mutex_lock(&attr_cache_lock);
+    unifyfs_attr_cache_t* ent = attr_cache_entry(gfid);
+    if (!ent->valid || (ent->attr.gfid != gfid)) {
+        /* evict any other file from this entry */
+        ent->size_valid = 0;
+    }
+    ent->valid       = 1;
+    ent->laminated   = attr->is_laminated;
+    ent->attr_expire = attr_cache_now() +
+                       ((uint64_t)unifyfs_attr_lease * 1000000);
+    ent->attr        = *attr;
+    ent->attr.gfid   = gfid;
+    pthread_mutex_unlock(&attr_cache_lock);
+}
+
+/* look up cached size of gfid, returns 1 on a hit */
+static int size_cache_get(int gfid, size_t* size)
+{
+    int hit = 0;
+    pthread_mutex_lock(&attr_cache_lock);
+    unifyfs_attr_cache_t* ent = attr_cache_entry(gfid);
+    if (ent->valid && (ent->attr.gfid == gfid)) {
+        if (ent->laminated) {
+            /* size of laminated file is in its attributes */
+            *size = (size_t) ent->attr.size;
+            hit = 1;
+        } else if (ent->size_valid &&
+                   (attr_cache_now() < ent->size_expire)) {
+            *size = ent->size;
+            hit = 1;
+        }
+    }
+    pthread_mutex_unlock(&attr_cache_lock);
+    return hit;
+}
+
+/* record size fetched from the server, only files that already have an
+ * entry are cached so the filename of the entry is known */
+static void size_cache_put(int gfid, size_t size)
+{
+    if (unifyfs_attr_lease <= 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&attr_cache_lock);
+    unifyfs_attr_cache_t* ent = attr_cache_entry(gfid);
+    if (ent->valid && (ent->attr.gfid == gfid) && !ent->laminated) {
+        ent->size_valid  = 1;
+        ent->size_expire = attr_cache_now() +
+                           ((uint64_t)unifyfs_attr_lease * 1000000);
+        ent->size        = size;
+    }
+    pthread_mutex_unlock(&attr_cache_lock);
+}
+
+/* drop cached attributes of gfid after we changed the file, or those
+ * of all files that are not laminated if gfid is -1 */
+void unifyfs_attr_cache_invalidate(int gfid)
+{
+    if (NULL == unifyfs_attr_cache) {
+        return;
+    }
+
+    pthread_mutex_lock(&attr_cache_lock);
+    if (gfid == -1) {
+        for (int i = 0; i < unifyfs_max_files; i++) {
+            unifyfs_attr_cache_t* ent = &unifyfs_attr_cache[i];
+            if (!ent->laminated) {
+                ent->valid      = 0;
+                ent->size_valid = 0;
+            }
+        }
+    } else {
+        unifyfs_attr_cache_t* ent = attr_cache_entry(gfid);
+        if (ent->attr.gfid == gfid) {
+            ent->valid      = 0;
+            ent->size_valid = 0;
+        }
+    }
+    pthread_mutex_unlock(&attr_cache_lock);
+}
+
+/* get the global size of a file that is not laminated,
+ * from the cache or from the server */
+int unifyfs_get_global_file_size(int gfid, size_t* size)
+{
+    if (size_cache_get(gfid, size)) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    int ret = invoke_client_filesize_rpc(gfid, size);
+    if (ret == UNIFYFS_SUCCESS) {
+        size_cache_put(gfid, *size);
+    }
+    return ret;
+}
+
 /*
  * Set the metadata values for a file (after optionally creating it).
  * The gfid for the file is in f_meta->gfid.
@@ -1396,6 +1923,9 @@ int unifyfs_set_global_file_meta(
 
     /* submit file attributes to global key/value store */
     int ret = invoke_client_metaset_rpc(create, gfattr);
+
+    /* cached attributes no longer match */
+    unifyfs_attr_cache_invalidate(gfid);
     return ret;
 }
 
@@ -1406,12 +1936,18 @@ int unifyfs_get_global_file_meta(int gfid, unifyfs_file_attr_t* gfattr)
         return UNIFYFS_FAILURE;
     }
 
+    /* use cached attributes if we have them */
+    if (attr_cache_get(gfid, gfattr)) {
+        return UNIFYFS_SUCCESS;
+    }
+
     /* attempt to lookup file attributes in key/value store */
     unifyfs_file_attr_t fmeta;
     int ret = invoke_client_metaget_rpc(gfid, &fmeta);
     if (ret == UNIFYFS_SUCCESS) {
         /* found it, copy attributes to output struct */
         *gfattr = fmeta;
+        attr_cache_put(gfid, &fmeta);
     }
     return ret;
 }
@@ -1529,6 +2065,9 @@ int unifyfs_fid_create_file(const char* path)
     meta->is_laminated = 0;
     meta->mode         = UNIFYFS_STAT_DEFAULT_FILE_MODE;
 
+    /* make file findable by its path and gfid */
+    unifyfs_fid_map_add(fid);
+
     if (unifyfs_flatten_writes) {
         /* Initialize our segment tree that will record our writes */
         rc = seg_tree_init(&meta->extents_sync);
@@ -1539,17 +2078,17 @@ int unifyfs_fid_create_file(const char* path)
     }
 
     /* Initialize our segment tree to track extents for all writes
-     * by this process, can be used to read back local data */
-    if (unifyfs_local_extents) {
-        rc = seg_tree_init(&meta->extents);
-        if (rc != 0) {
-            errno = rc;
-            fid = -1;
-        }
+     * by this process, used to read back local data and to release
+     * log space on truncate and unlink */
+    rc = seg_tree_init(&meta->extents);
+    if (rc != 0) {
+        errno = rc;
+        fid = -1;
     }
 
     /* PTHREAD_PROCESS_SHARED allows Process-Shared Synchronization */
     pthread_spin_init(&meta->fspinlock, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&meta->extents_lock, NULL);
 
     return fid;
 }
@@ -1633,6 +2172,21 @@ int unifyfs_fid_write(
     const void* buf,  /* buffer to be written */
     size_t count,     /* number of bytes to write */
     size_t* nwritten) /* returns number of bytes written */
+{
+    struct iovec iov;
+    iov.iov_base = (void*) buf;
+    iov.iov_len  = count;
+    return unifyfs_fid_writev(fid, pos, &iov, 1, nwritten);
+}
+
+/* write data from a vector of buffers into contiguous file space
+ * starting at offset pos */
+int unifyfs_fid_writev(
+    int fid,                 /* local file id to write to */
+    off_t pos,               /* starting position in file */
+    const struct iovec* iov, /* buffers to be written */
+    int iovcnt,              /* number of buffers */
+    size_t* nwritten)        /* returns number of bytes written */
 {
     int rc;
 
@@ -1640,6 +2194,10 @@ int unifyfs_fid_write(
     *nwritten = 0;
 
     /* short-circuit a 0-byte write */
+    size_t count = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        count += iov[i].iov_len;
+    }
     if (count == 0) {
         return UNIFYFS_SUCCESS;
     }
@@ -1650,7 +2208,7 @@ int unifyfs_fid_write(
     /* determine storage type to write file data */
     if (meta->storage == FILE_STORAGE_LOGIO) {
         /* file stored in logged i/o */
-        rc = unifyfs_fid_logio_write(fid, meta, pos, buf, count, nwritten);
+        rc = unifyfs_fid_logio_writev(fid, meta, pos, iov, iovcnt, nwritten);
         if (rc == UNIFYFS_SUCCESS) {
             /* write succeeded, remember that we have new data
              * that needs to be synced with the server */
@@ -1678,16 +2236,27 @@ int unifyfs_fid_truncate(int fid, off_t length)
 
     /* determine file storage type */
     if (meta->storage == FILE_STORAGE_LOGIO) {
+        /* sync pending writes first, so that the server drops their
+         * extents along with the rest before we release the log space */
+        int rc = unifyfs_fid_sync(fid);
+        if (rc != UNIFYFS_SUCCESS) {
+            return rc;
+        }
+
         /* invoke truncate rpc */
         int gfid = unifyfs_gfid_from_fid(fid);
-        int rc = invoke_client_truncate_rpc(gfid, length);
+        rc = invoke_client_truncate_rpc(gfid, length);
+        unifyfs_attr_cache_invalidate(gfid);
         if (rc != UNIFYFS_SUCCESS) {
             return rc;
         }
 
         /* truncate succeeded, update global size to
-         * reflect truncated size, note log size is not affected */
+         * reflect truncated size */
         meta->global_size = length;
+
+        /* release log space for our data past the new end of file */
+        fid_reclaim_log(meta, length);
     } else {
         /* unknown storage type */
         return EIO;
@@ -1705,10 +2274,8 @@ int unifyfs_fid_sync(int fid)
     /* sync any writes to disk */
     unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(fid);
     if (meta->needs_sync) {
-        /* TODO: no way to just sync data for this file,
-         * so we sync every file for now */
-        /* sync data with server */
-        ret = unifyfs_sync();
+        /* sync data for this file with server */
+        ret = unifyfs_sync_file(meta);
 
         /* just synced writes for this file */
         if (ret == UNIFYFS_SUCCESS) {
@@ -1719,6 +2286,40 @@ int unifyfs_fid_sync(int fid)
     return ret;
 }
 
+/* sync data for file id to server if needed before reading count bytes
+ * at pos, skips the sync when no unsynced write overlaps the range, or
+ * when the range can be read from local extents */
+int unifyfs_fid_sync_extent(int fid, off_t pos, size_t count)
+{
+    unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(fid);
+    if (!meta->needs_sync || (count == 0)) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    /* check whether we have unsynced writes within the range */
+    int overlap;
+    size_t unsynced_size;
+    size_t start = (size_t) pos;
+    size_t end   = start + count - 1;
+    unifyfs_find_unsynced(meta, start, end, &overlap, &unsynced_size);
+    if (!overlap) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    /* we read our own writes from the log when they cover the range */
+    if (unifyfs_local_extents) {
+        seg_tree_rdlock(&meta->extents);
+        struct seg_tree_node* first;
+        first = find_local_extents(&meta->extents, start, end + 1);
+        seg_tree_unlock(&meta->extents);
+        if (first != NULL) {
+            return UNIFYFS_SUCCESS;
+        }
+    }
+
+    return unifyfs_fid_sync(fid);
+}
+
 /* opens a new file id with specified path, access flags, and permissions,
  * fills outfid with file id and outpos with position for current file pointer,
  * returns UNIFYFS error code
@@ -1897,15 +2498,29 @@ int unifyfs_fid_unlink(int fid)
 {
     int rc;
 
+    /* sync pending writes first, so that none refer to the log space
+     * we release below once the server has deleted the file */
+    rc = unifyfs_fid_sync(fid);
+    if (rc != UNIFYFS_SUCCESS) {
+        return rc;
+    }
+
     /* invoke unlink rpc */
     int gfid = unifyfs_gfid_from_fid(fid);
     rc = invoke_client_unlink_rpc(gfid);
+    unifyfs_attr_cache_invalidate(gfid);
     if (rc != UNIFYFS_SUCCESS) {
         /* TODO: if item does not exist globally, but just locally,
          * we still want to delete item locally */
         return rc;
     }
 
+    /* release log space holding data for the file */
+    unifyfs_filemeta_t* meta = unifyfs_get_meta_from_fid(fid);
+    if (meta->storage == FILE_STORAGE_LOGIO) {
+        fid_reclaim_log(meta, 0);
+    }
+
     /* finalize the storage we're using for this file */
     rc = fid_store_free(fid);
     if (rc != UNIFYFS_SUCCESS) {
@@ -1920,6 +2535,7 @@ int unifyfs_fid_unlink(int fid)
      * release the file id itself */
 
     /* set this file id as not in use */
+    unifyfs_fid_map_remove(fid);
     unifyfs_filelist[fid].in_use = 0;
 
     /* add this id back to the free stack */
@@ -1960,6 +2576,10 @@ int unifyfs_fid_unlink(int fid)
  *  - array of index metadata to track physical offset
  *    of logical file data, of length unifyfs_max_index_entries,
  *    entries added during write operations
+ *
+ *  - when index buffers are flushed asynchronously, a second
+ *    count and index array, so writes can continue into one
+ *    while the other is flushed to the server
  */
 
 /* compute memory size of superblock in bytes,
@@ -1983,8 +2603,11 @@ static size_t get_superblock_size(void)
     sb_size += unifyfs_max_files * sizeof(unifyfs_filemeta_t);
 
     /* index region size */
-    sb_size += unifyfs_page_size;
-    sb_size += unifyfs_max_index_entries * sizeof(unifyfs_index_t);
+    sb_size += unifyfs_num_index_bufs * (unifyfs_page_size +
+        (unifyfs_max_index_entries * sizeof(unifyfs_index_t)));
+
+    /* attribute cache */
+    sb_size += unifyfs_max_files * sizeof(unifyfs_attr_cache_t);
 
     /* return number of bytes */
     return sb_size;
@@ -2024,13 +2647,22 @@ static void init_superblock_pointers(void* superblock)
     unifyfs_filemetas = (unifyfs_filemeta_t*)ptr;
     ptr += unifyfs_max_files * sizeof(unifyfs_filemeta_t);
 
-    /* record pointer to number of index entries */
-    unifyfs_indices.ptr_num_entries = (size_t*)ptr;
+    for (int i = 0; i < unifyfs_num_index_bufs; i++) {
+        /* record pointer to number of index entries */
+        unifyfs_index_bufs[i].ptr_num_entries = (size_t*)ptr;
+
+        /* pointer to array of index entries */
+        ptr += unifyfs_page_size;
+        unifyfs_index_bufs[i].index_entry = (unifyfs_index_t*)ptr;
+        ptr += unifyfs_max_index_entries * sizeof(unifyfs_index_t);
+    }
+
+    /* writes start out in the first index buffer */
+    unifyfs_indices = unifyfs_index_bufs[0];
 
-    /* pointer to array of index entries */
-    ptr += unifyfs_page_size;
-    unifyfs_indices.index_entry = (unifyfs_index_t*)ptr;
-    ptr += unifyfs_max_index_entries * sizeof(unifyfs_index_t);
+    /* cache of global file attributes */
+    unifyfs_attr_cache = (unifyfs_attr_cache_t*)ptr;
+    ptr += unifyfs_max_files * sizeof(unifyfs_attr_cache_t);
 
     /* compute size of memory we're using and check that
      * it matches what we allocated */
@@ -2053,7 +2685,13 @@ static int init_superblock_structures(void)
     unifyfs_stack_init(free_fid_stack, unifyfs_max_files);
 
     /* initialize count of key/value entries */
-    *(unifyfs_indices.ptr_num_entries) = 0;
+    for (int i = 0; i < unifyfs_num_index_bufs; i++) {
+        *(unifyfs_index_bufs[i].ptr_num_entries) = 0;
+    }
+
+    /* start with an empty attribute cache */
+    memset(unifyfs_attr_cache, 0,
+           unifyfs_max_files * sizeof(unifyfs_attr_cache_t));
 
     LOGDBG("Meta-stacks initialized!");
 
@@ -2079,6 +2717,17 @@ static int init_superblock_shm(size_t super_sz)
     void* addr = shm_ctx->addr;
     init_superblock_pointers(addr);
 
+    /* allocate nodes for the path and gfid lookup tables */
+    fid_map_nodes = (fid_map_node_t*)
+        calloc(unifyfs_max_files, sizeof(fid_map_node_t));
+    if (NULL == fid_map_nodes) {
+        LOGERR("failed to allocate file id lookup tables");
+        unifyfs_shm_free(&shm_super_ctx);
+        return ENOMEM;
+    }
+    fid_path_map = NULL;
+    fid_gfid_map = NULL;
+
     /* initialize structures in superblock if it's newly allocated,
      * we depend on shm_open setting all bytes to 0 to know that
      * it is not initialized */
@@ -2107,7 +2756,13 @@ static int init_superblock_shm(size_t super_sz)
          * try to rewrite the index using the trees, which point to invalid
          * memory at this point. */
         /* initialize count of key/value entries */
-        *(unifyfs_indices.ptr_num_entries) = 0;
+        for (int i = 0; i < unifyfs_num_index_bufs; i++) {
+            *(unifyfs_index_bufs[i].ptr_num_entries) = 0;
+        }
+
+        /* keep cached attributes of laminated files, leases of the
+         * others were measured by a clock of the earlier run */
+        unifyfs_attr_cache_invalidate(-1);
 
         int i;
         for (i = 0; i < unifyfs_max_files; i++) {
@@ -2122,10 +2777,13 @@ static int init_superblock_shm(size_t super_sz)
                 }
 
                 /* Reset our segment tree to track extents for all writes
-                 * by this process, can be used to read back local data */
-                if (unifyfs_local_extents) {
-                    seg_tree_init(&meta->extents);
-                }
+                 * by this process, along with its lock, which may have
+                 * been held by a thread of the earlier run */
+                seg_tree_init(&meta->extents);
+                pthread_mutex_init(&meta->extents_lock, NULL);
+
+                /* rebuild the lookup tables for this file */
+                unifyfs_fid_map_add(i);
             }
         }
     }
@@ -2266,6 +2924,39 @@ static int unifyfs_init(void)
             }
         }
 
+        /* Determine if the server should write read data directly
+         * into our read buffers rather than staging it in shmem */
+        unifyfs_direct_read = 0;
+        cfgval = client_cfg.client_direct_read;
+        if (cfgval != NULL) {
+            rc = configurator_bool_val(cfgval, &b);
+            if (rc == 0) {
+                unifyfs_direct_read = (bool)b;
+            }
+        }
+
+        /* Determine if we should read data written by other clients
+         * on this node directly from their logs */
+        unifyfs_node_local_reads = 0;
+        cfgval = client_cfg.client_node_local_reads;
+        if (cfgval != NULL) {
+            rc = configurator_bool_val(cfgval, &b);
+            if (rc == 0) {
+                unifyfs_node_local_reads = (bool)b;
+            }
+        }
+
+        /* Determine if we should read spilled log data through
+         * a mapping of the spill file rather than with pread */
+        unifyfs_spill_mmap = 0;
+        cfgval = client_cfg.logio_spill_mmap;
+        if (cfgval != NULL) {
+            rc = configurator_bool_val(cfgval, &b);
+            if (rc == 0) {
+                unifyfs_spill_mmap = (bool)b;
+            }
+        }
+
         /* define size of buffer used to cache key/value pairs for
          * data offsets before passing them to the server */
         unifyfs_index_buf_size = UNIFYFS_INDEX_BUF_SIZE;
@@ -2278,6 +2969,47 @@ static int unifyfs_init(void)
         }
         unifyfs_max_index_entries =
             unifyfs_index_buf_size / sizeof(unifyfs_index_t);
+        if (unifyfs_max_index_entries < WRITE_SEGMENT_RESERVE) {
+            /* a write could never fit in the index */
+            LOGERR("write_index_size=%zu must hold at least %d entries "
+                   "of %zu bytes", unifyfs_index_buf_size,
+                   WRITE_SEGMENT_RESERVE, sizeof(unifyfs_index_t));
+            return UNIFYFS_FAILURE;
+        }
+
+        /* Determine if full index buffers should be flushed to the
+         * server in the background, which needs a second buffer */
+        unifyfs_async_index = 0;
+        cfgval = client_cfg.client_async_index;
+        if (cfgval != NULL) {
+            rc = configurator_bool_val(cfgval, &b);
+            if (rc == 0) {
+                unifyfs_async_index = (bool)b;
+            }
+        }
+        unifyfs_num_index_bufs = (unifyfs_async_index ? 2 : 1);
+
+        /* Determine how long attributes of files that are not
+         * laminated may be cached, by default they are not */
+        unifyfs_attr_lease = 0;
+        cfgval = client_cfg.client_attr_lease;
+        if (cfgval != NULL) {
+            rc = configurator_int_val(cfgval, &l);
+            if (rc == 0) {
+                unifyfs_attr_lease = l;
+            }
+        }
+
+        /* Determine how long to wait for the server to deliver
+         * read data before giving up on a read */
+        unifyfs_read_timeout = UNIFYFS_READ_WAIT_TIMEOUT;
+        cfgval = client_cfg.client_read_timeout;
+        if (cfgval != NULL) {
+            rc = configurator_int_val(cfgval, &l);
+            if ((rc == 0) && (l > 0)) {
+                unifyfs_read_timeout = l;
+            }
+        }
 
         /* record the max fd for the system */
         /* RLIMIT_NOFILE specifies a value one greater than the maximum
@@ -2350,6 +3082,21 @@ static int unifyfs_init(void)
                    unifyfs_rc_enum_str(rc));
             return rc;
         }
+        if (unifyfs_spill_mmap) {
+            rc = unifyfs_logio_map_spill(logio_ctx);
+            if (rc != UNIFYFS_SUCCESS) {
+                LOGWARN("failed to map logio spill file");
+            }
+        }
+
+        /* start thread to flush full index buffers */
+        if (unifyfs_async_index) {
+            rc = unifyfs_index_flusher_start();
+            if (rc != UNIFYFS_SUCCESS) {
+                LOGERR("failed to start index flush thread");
+                return rc;
+            }
+        }
 
         /* remember that we've now initialized the library */
         unifyfs_initialized = 1;
@@ -2370,11 +3117,23 @@ static int unifyfs_finalize(void)
         return UNIFYFS_FAILURE;
     }
 
+    /* stop index flush thread, if unmount has not already */
+    if (unifyfs_async_index) {
+        unifyfs_index_flusher_stop();
+    }
+
     /* close spillover files */
     if (NULL != logio_ctx) {
         unifyfs_logio_close(logio_ctx);
         logio_ctx = NULL;
     }
+    int i;
+    for (i = 0; i < MAX_APP_CLIENTS; i++) {
+        if (NULL != peer_logio_ctx[i]) {
+            unifyfs_logio_close(peer_logio_ctx[i]);
+            peer_logio_ctx[i] = NULL;
+        }
+    }
     if (unifyfs_spillmetablock != -1) {
         close(unifyfs_spillmetablock);
         unifyfs_spillmetablock = -1;
@@ -2383,6 +3142,15 @@ static int unifyfs_finalize(void)
     /* detach from superblock shmem, but don't unlink the file so that
      * a later client can reattach. */
     unifyfs_shm_free(&shm_super_ctx);
+    unifyfs_attr_cache = NULL;
+
+    /* free file id lookup tables, their nodes live in one array */
+    HASH_CLEAR(hh_path, fid_path_map);
+    HASH_CLEAR(hh_gfid, fid_gfid_map);
+    if (fid_map_nodes != NULL) {
+        free(fid_map_nodes);
+        fid_map_nodes = NULL;
+    }
 
     /* unlink and detach from data receive shmem */
     unifyfs_shm_unlink(shm_recv_ctx);
@@ -2427,7 +3195,7 @@ void fill_client_mount_info(unifyfs_mount_in_t* in)
 /* Fill attach rpc input struct with client-side context info */
 void fill_client_attach_info(unifyfs_attach_in_t* in)
 {
-    size_t meta_offset = (char*)unifyfs_indices.ptr_num_entries -
+    size_t meta_offset = (char*)unifyfs_index_bufs[0].ptr_num_entries -
                          (char*)shm_super_ctx->addr;
     size_t meta_size   = unifyfs_max_index_entries
                          * sizeof(unifyfs_index_t);
@@ -2441,6 +3209,7 @@ void fill_client_attach_info(unifyfs_attach_in_t* in)
     in->logio_mem_size    = logio_ctx->shmem->size;
     in->logio_spill_size  = logio_ctx->spill_sz;
     in->logio_spill_dir   = strdup(client_cfg.logio_spill_dir);
+    in->client_pid        = (int32_t) getpid();
 }
 
 /**
@@ -2603,6 +3372,11 @@ int unifyfs_unmount(void)
      * tear down connection to server
      ************************/
 
+    /* stop index flush thread, after any pending flush completes */
+    if (unifyfs_async_index) {
+        unifyfs_index_flusher_stop();
+    }
+
     /* invoke unmount rpc to tell server we're disconnecting */
     LOGDBG("calling unmount");
     rc = invoke_client_unmount_rpc();
@@ -334,6 +334,69 @@ release_add:
     return rc;
 }
 
+/*
+ * Remove the [start, end] range from the tree.  Entries that lie entirely
+ * within the range are deleted, and entries that partially overlap it are
+ * trimmed (or split in two) so that only their non-overlapping portions
+ * remain.  Returns 0 on success, nonzero otherwise.
+ */
+int seg_tree_remove(struct seg_tree* seg_tree, unsigned long start,
+    unsigned long end)
+{
+    int rc = 0;
+    struct seg_tree_node* overlap;
+    struct seg_tree_node* head;
+    struct seg_tree_node* tail;
+
+    seg_tree_wrlock(seg_tree);
+
+    while ((overlap = seg_tree_find_nolock(seg_tree, start, end))) {
+        /* Keep any leading portion that comes before the range */
+        head = NULL;
+        if (overlap->start < start) {
+            head = seg_tree_node_alloc(overlap->start, start - 1,
+                overlap->ptr);
+            if (!head) {
+                rc = ENOMEM;
+                break;
+            }
+        }
+
+        /* Keep any trailing portion that comes after the range */
+        tail = NULL;
+        if (overlap->end > end) {
+            tail = seg_tree_node_alloc(end + 1, overlap->end,
+                overlap->ptr + (end + 1 - overlap->start));
+            if (!tail) {
+                free(head);
+                rc = ENOMEM;
+                break;
+            }
+        }
+
+        RB_REMOVE(inttree, &seg_tree->head, overlap);
+        free(overlap);
+        seg_tree->count--;
+
+        if (head != NULL) {
+            RB_INSERT(inttree, &seg_tree->head, head);
+            seg_tree->count++;
+        }
+        if (tail != NULL) {
+            RB_INSERT(inttree, &seg_tree->head, tail);
+            seg_tree->count++;
+        }
+    }
+
+    /* Recompute max ending offset, which may have been removed */
+    struct seg_tree_node* last = RB_MAX(inttree, &seg_tree->head);
+    seg_tree->max = (last != NULL) ? last->end : 0;
+
+    seg_tree_unlock(seg_tree);
+
+    return rc;
+}
+
 /*
  * Search tree for an entry that overlaps with given range of [start, end].
  * Returns the first overlapping entry if found, which is the overlapping entry
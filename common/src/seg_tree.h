@@ -37,6 +37,14 @@ void seg_tree_destroy(struct seg_tree* seg_tree);
 int seg_tree_add(struct seg_tree* seg_tree, unsigned long start,
     unsigned long end, unsigned long ptr);
 
+/*
+ * Remove the [start, end] range from the tree, trimming or splitting any
+ * entries that partially overlap it.  Returns 0 on success, nonzero
+ * otherwise.
+ */
+int seg_tree_remove(struct seg_tree* seg_tree, unsigned long start,
+    unsigned long end);
+
 /*
  * Find the first seg_tree_node that falls in a [start, end] range.
  */
@@ -15,7 +15,6 @@
 #include "unifyfs_const.h"
 #include "slotmap.h"
 
-#include <assert.h>
 #include <stdbool.h> // bool
 #include <stdint.h>  // uint8_t
 #include <stdio.h>
@@ -29,25 +28,6 @@
 #define BYTE_BIT_TO_SLOT(byte, bit) (((byte) * 8) + (bit))
 #define BYTE_VAL_BIT(byte_val, bit) ((byte_val) & (uint8_t)(1 << (bit)))
 
-/* Set given byte-bit in use map */
-static inline
-void set_usemap_byte_bit(uint8_t* usemap, size_t byte, int bit)
-{
-    uint8_t byte_val = usemap[byte];
-    byte_val |= (uint8_t)(1 << bit);
-    usemap[byte] = byte_val;
-}
-
-/* Clear given byte-bit in use map */
-static inline
-void clear_usemap_byte_bit(uint8_t* usemap, size_t byte, int bit)
-{
-    uint8_t byte_val = usemap[byte];
-    uint8_t byte_mask = (uint8_t)0xFF - (uint8_t)(1 << bit);
-    byte_val &= byte_mask;
-    usemap[byte] = byte_val;
-}
-
 /* Check use map for slot used */
 static inline
 int check_slot(uint8_t* usemap, size_t slot)
@@ -61,22 +41,75 @@ int check_slot(uint8_t* usemap, size_t slot)
     return 0;
 }
 
-/* Update use map to use slot */
+/* Set (or clear) the use map bits for a range of consecutive slots,
+ * whole bytes in the middle of the range are filled with memset() */
 static inline
-void use_slot(uint8_t* usemap, size_t slot)
+void set_slot_range(uint8_t* usemap, size_t start, size_t num_slots,
+                    int used)
 {
-    size_t byte = SLOT_BYTE(slot);
-    int bit = SLOT_BIT(slot);
-    set_usemap_byte_bit(usemap, byte, bit);
+    size_t slot = start;
+    size_t end = start + num_slots;
+
+    /* leading bits up to the first byte boundary */
+    while ((slot < end) && SLOT_BIT(slot)) {
+        uint8_t mask = (uint8_t)(1 << SLOT_BIT(slot));
+        if (used) {
+            usemap[SLOT_BYTE(slot)] |= mask;
+        } else {
+            usemap[SLOT_BYTE(slot)] &= (uint8_t)~mask;
+        }
+        slot++;
+    }
+
+    /* whole bytes */
+    size_t nbytes = SLOT_BYTE(end - slot);
+    if (nbytes) {
+        memset(usemap + SLOT_BYTE(slot), (used ? 0xFF : 0), nbytes);
+        slot += BYTE_BIT_TO_SLOT(nbytes, 0);
+    }
+
+    /* trailing bits */
+    while (slot < end) {
+        uint8_t mask = (uint8_t)(1 << SLOT_BIT(slot));
+        if (used) {
+            usemap[SLOT_BYTE(slot)] |= mask;
+        } else {
+            usemap[SLOT_BYTE(slot)] &= (uint8_t)~mask;
+        }
+        slot++;
+    }
 }
 
-/* Update use map to release slot */
+/* Count leading zero bits of a non-zero word */
 static inline
-void release_slot(uint8_t* usemap, size_t slot)
+int word_clz(uint64_t word)
 {
-    size_t byte = SLOT_BYTE(slot);
-    int bit = SLOT_BIT(slot);
-    clear_usemap_byte_bit(usemap, byte, bit);
+#if defined(__GNUC__)
+    return __builtin_clzll(word);
+#else
+    int n = 0;
+    while (!(word & ((uint64_t)1 << 63))) {
+        word <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/* Count trailing zero bits of a non-zero word */
+static inline
+int word_ctz(uint64_t word)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int n = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        n++;
+    }
+    return n;
+#endif
 }
 
 /* Return bytes necessary to hold use map for given number of slots */
@@ -102,6 +135,34 @@ uint8_t* get_use_map(slot_map* smap)
     return usemap;
 }
 
+/* Return the 64 slots of the use map starting at slot (word * 64) as a
+ * word, where bit i is set if slot (word * 64) + i is used. Slots past
+ * the end of the map are reported as used. The use map has no alignment
+ * or padding guarantees, so the word is assembled from its bytes. */
+static inline
+uint64_t get_map_word(uint8_t* usemap, size_t total_slots, size_t word)
+{
+    size_t first_byte = word * sizeof(uint64_t);
+    size_t map_bytes = slot_map_bytes(total_slots);
+    size_t nbytes = map_bytes - first_byte;
+    if (nbytes > sizeof(uint64_t)) {
+        nbytes = sizeof(uint64_t);
+    }
+
+    uint64_t val = 0;
+    for (size_t i = 0; i < nbytes; i++) {
+        val |= ((uint64_t)usemap[first_byte + i]) << (8 * i);
+    }
+
+    size_t first_slot = word * 64;
+    if ((first_slot + 64) > total_slots) {
+        /* mark nonexistent slots as used */
+        size_t valid = total_slots - first_slot;
+        val |= ~(uint64_t)0 << valid;
+    }
+    return val;
+}
+
 /* Return number of free slots */
 static inline
 size_t get_free_slots(slot_map* smap)
@@ -157,6 +218,7 @@ int slotmap_clear(slot_map* smap)
 
     /* set used to zero */
     smap->used_slots = 0;
+    smap->free_hint = 0;
 
     /* zero-out use map */
     uint8_t* usemap = get_use_map(smap);
@@ -165,39 +227,6 @@ int slotmap_clear(slot_map* smap)
     return UNIFYFS_SUCCESS;
 }
 
-static inline
-size_t find_consecutive_zero_bits(uint8_t byte_val,
-                                  size_t num_bits,
-                                  int* start_bit)
-{
-    size_t max_free = 0;
-    int free_start = 0;
-    for (int bit = 0; bit < 8; bit++) {
-        /* starting at current bit, count consecutive zero bits */
-        int run_start = bit;
-        size_t run_max = 0;
-        while (!BYTE_VAL_BIT(byte_val, bit)) {
-            run_max++;
-            bit++;
-            if (bit == 8) {
-                break;
-            }
-        }
-        if (run_max > max_free) {
-            max_free = run_max;
-            free_start = run_start;
-        }
-    }
-    if (NULL != start_bit) {
-        if (max_free >= num_bits) {
-            *start_bit = free_start;
-        } else {
-            *start_bit = -1; /* did not find enough bits */
-        }
-    }
-    return max_free;
-}
-
 /**
  * Reserve consecutive slots in the slot_map.
  *
@@ -219,84 +248,83 @@ ssize_t slotmap_reserve(slot_map* smap,
         return (ssize_t)-1;
     }
 
-    /* need this many usemap bytes for requested slots */
-    size_t slot_bytes = slot_map_bytes(num_slots);
-
-    /* these will be set if we find a spot for the reservation */
-    size_t start_slot;
+    /* search for a run of free slots a word at a time, starting at
+     * the hint since all slots before it are in use. Full words are
+     * skipped (or counted as free) with a single comparison, while
+     * partially used words are handled with ctz/clz and a few shifts
+     * rather than by testing each bit. */
+    uint8_t* usemap = get_use_map(smap);
+    size_t total = smap->total_slots;
+    size_t num_words = (total + 63) / 64;
+    size_t run_start = 0;
+    size_t run_len = 0;
     int found_start = 0;
+    for (size_t w = smap->free_hint / 64; w < num_words; w++) {
+        uint64_t word = get_map_word(usemap, total, w);
 
-    /* search for contiguous free slots */
-    size_t search_start = 0;
-    if (slot_bytes > 1) {
-        /* skip past (likely) used slots */
-        search_start = SLOT_BYTE(smap->used_slots);
-    }
-    uint8_t* usemap = get_use_map(smap);
-    size_t map_bytes = slot_map_bytes(smap->total_slots);
-    for (size_t byte_ndx = search_start; byte_ndx < map_bytes; byte_ndx++) {
-        uint8_t byte_val = usemap[byte_ndx];
-        if (byte_val == UINT8_MAX) {
-            /* current byte is completely occupied */
+        if (word == UINT64_MAX) {
+            /* all slots in word are used */
+            run_len = 0;
             continue;
-        } else if ((slot_bytes > 1) &&
-                   ((byte_ndx + slot_bytes) <= map_bytes)) {
-            /* look for slot_bytes consecutive zero bytes */
-            size_t run_start = byte_ndx;
-            size_t run_count = 0;
-            while (0 == usemap[byte_ndx]) {
-                run_count++;
-                byte_ndx++;
-                if (run_count == slot_bytes) {
-                    /* success */
-                    start_slot = BYTE_BIT_TO_SLOT(run_start, 0);
-                    found_start = 1;
-                    break;
-                }
+        } else if (word == 0) {
+            /* all slots in word are free */
+            if (0 == run_len) {
+                run_start = w * 64;
             }
-        } else {
-            /* need at most 8 bits, spanning at most two bytes */
-            int bit_in_byte;
-            size_t free_bits = find_consecutive_zero_bits(byte_val, num_slots,
-                                                          &bit_in_byte);
-            if (free_bits >= num_slots) {
-                /* success, can reserve all slots in this byte of use map */
-                assert(bit_in_byte != -1);
-                start_slot = BYTE_BIT_TO_SLOT(byte_ndx, bit_in_byte);
+            run_len += 64;
+            if (run_len >= num_slots) {
                 found_start = 1;
-            } else if ((byte_ndx + 1) < map_bytes) {
-                /* check if free bits are at the end of the byte */
-                find_consecutive_zero_bits(byte_val, free_bits, &bit_in_byte);
-                assert(bit_in_byte != -1);
-                if (bit_in_byte == (8 - free_bits)) {
-                    /* free bits are at tail end of byte,
-                     * check next byte for remaining needed slots */
-                    int bit_in_byte2;
-                    size_t have_bits = free_bits;
-                    size_t need_bits = num_slots - have_bits;
-                    byte_val = usemap[byte_ndx + 1];
-                    free_bits = find_consecutive_zero_bits(byte_val, need_bits,
-                                                           &bit_in_byte2);
-                    if ((free_bits >= need_bits) && (bit_in_byte2 == 0)) {
-                        /* success, has enough free bits at start of byte */
-                        start_slot = BYTE_BIT_TO_SLOT(byte_ndx, bit_in_byte);
-                        found_start = 1;
-                    }
-                }
+                break;
             }
+            continue;
         }
-        if (found_start) {
+
+        /* free slots at the bottom of the word extend the current run */
+        int low_free = word_ctz(word);
+        if (0 == run_len) {
+            run_start = w * 64;
+        }
+        run_len += low_free;
+        if (run_len >= num_slots) {
+            found_start = 1;
             break;
         }
+
+        if (num_slots < 64) {
+            /* look for a run within the word, after folding the free
+             * mask onto itself only bits that start a run of at least
+             * num_slots free slots are left set */
+            uint64_t runs = ~word;
+            size_t have = 1;
+            while ((have < num_slots) && runs) {
+                size_t shift = have;
+                if (shift > (num_slots - have)) {
+                    shift = num_slots - have;
+                }
+                runs &= runs >> shift;
+                have += shift;
+            }
+            if (runs) {
+                run_start = (w * 64) + word_ctz(runs);
+                found_start = 1;
+                break;
+            }
+        }
+
+        /* free slots at the top of the word start a new run */
+        int high_free = word_clz(word);
+        run_start = (w * 64) + (64 - high_free);
+        run_len = high_free;
     }
 
     if (found_start) {
         /* success, reserve bits in consecutive slots */
-        for (size_t i = 0; i < num_slots; i++) {
-            use_slot(usemap, start_slot + i);
-        }
+        set_slot_range(usemap, run_start, num_slots, 1);
         smap->used_slots += num_slots;
-        return (ssize_t)start_slot;
+        if (run_start == smap->free_hint) {
+            smap->free_hint = run_start + num_slots;
+        }
+        return (ssize_t)run_start;
     }
 
     /* did not find enough consecutive free slots */
@@ -328,10 +356,11 @@ int slotmap_release(slot_map* smap,
     }
 
     /* release the slots */
-    for (size_t i = 0; i < num_slots; i++) {
-        release_slot(usemap, start_index + i);
-    }
+    set_slot_range(usemap, start_index, num_slots, 0);
     smap->used_slots -= num_slots;
+    if (start_index < smap->free_hint) {
+        smap->free_hint = start_index;
+    }
 
     return UNIFYFS_SUCCESS;
 }
@@ -353,6 +382,7 @@ void slotmap_print(slot_map* smap)
     fprintf(stderr, "# Slot Map:\n");
     fprintf(stderr, "#   total slots - %zu\n", smap->total_slots);
     fprintf(stderr, "#    used slots - %zu\n", smap->used_slots);
+    fprintf(stderr, "#     free hint - %zu\n", smap->free_hint);
 
     for (size_t i = 0; i < smap->total_slots; i++) {
         if (i % 64 == 0) {
@@ -25,6 +25,7 @@ extern "C" {
 typedef struct slot_map {
     size_t total_slots;
     size_t used_slots;
+    size_t free_hint; /* all slots below this index are in use */
 } slot_map;
 
 /* The slot usage bitmap immediately follows the structure in memory.
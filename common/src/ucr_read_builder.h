@@ -42,19 +42,21 @@ __flatbuffers_build_struct(flatbuffers_, unifyfs_Extent, 24, 8, unifyfs_Extent_i
 static const flatbuffers_voffset_t __unifyfs_ReadRequest_required[] = { 0 };
 typedef flatbuffers_ref_t unifyfs_ReadRequest_ref_t;
 static unifyfs_ReadRequest_ref_t unifyfs_ReadRequest_clone(flatbuffers_builder_t *B, unifyfs_ReadRequest_table_t t);
-__flatbuffers_build_table(flatbuffers_, unifyfs_ReadRequest, 1)
+__flatbuffers_build_table(flatbuffers_, unifyfs_ReadRequest, 2)
 
-#define __unifyfs_ReadRequest_formal_args , unifyfs_Extent_vec_ref_t v0
-#define __unifyfs_ReadRequest_call_args , v0
+#define __unifyfs_ReadRequest_formal_args , unifyfs_Extent_vec_ref_t v0, flatbuffers_uint64_vec_ref_t v1
+#define __unifyfs_ReadRequest_call_args , v0, v1
 static inline unifyfs_ReadRequest_ref_t unifyfs_ReadRequest_create(flatbuffers_builder_t *B __unifyfs_ReadRequest_formal_args);
 __flatbuffers_build_table_prolog(flatbuffers_, unifyfs_ReadRequest, unifyfs_ReadRequest_identifier, unifyfs_ReadRequest_type_identifier)
 
 __flatbuffers_build_vector_field(0, flatbuffers_, unifyfs_ReadRequest_extents, unifyfs_Extent, unifyfs_Extent_t, unifyfs_ReadRequest)
+__flatbuffers_build_vector_field(1, flatbuffers_, unifyfs_ReadRequest_bufs, flatbuffers_uint64, uint64_t, unifyfs_ReadRequest)
 
 static inline unifyfs_ReadRequest_ref_t unifyfs_ReadRequest_create(flatbuffers_builder_t *B __unifyfs_ReadRequest_formal_args)
 {
     if (unifyfs_ReadRequest_start(B)
-        || unifyfs_ReadRequest_extents_add(B, v0)) {
+        || unifyfs_ReadRequest_extents_add(B, v0)
+        || unifyfs_ReadRequest_bufs_add(B, v1)) {
         return 0;
     }
     return unifyfs_ReadRequest_end(B);
@@ -64,7 +66,8 @@ static unifyfs_ReadRequest_ref_t unifyfs_ReadRequest_clone(flatbuffers_builder_t
 {
     __flatbuffers_memoize_begin(B, t);
     if (unifyfs_ReadRequest_start(B)
-        || unifyfs_ReadRequest_extents_pick(B, t)) {
+        || unifyfs_ReadRequest_extents_pick(B, t)
+        || unifyfs_ReadRequest_bufs_pick(B, t)) {
         return 0;
     }
     __flatbuffers_memoize_end(B, t, unifyfs_ReadRequest_end(B));
@@ -69,6 +69,7 @@ __flatbuffers_offset_vec_at(unifyfs_ReadRequest_table_t, vec, i, 0)
 __flatbuffers_table_as_root(unifyfs_ReadRequest)
 
 __flatbuffers_define_vector_field(0, unifyfs_ReadRequest, extents, unifyfs_Extent_vec_t, 0)
+__flatbuffers_define_vector_field(1, unifyfs_ReadRequest, bufs, flatbuffers_uint64_vec_t, 0)
 
 #include "flatcc/flatcc_epilogue.h"
 #endif /* UCR_READ_READER_H */
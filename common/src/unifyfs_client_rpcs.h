@@ -27,7 +27,8 @@ MERCURY_GEN_PROC(unifyfs_attach_in_t,
                  ((hg_size_t)(meta_size))
                  ((hg_size_t)(logio_mem_size))
                  ((hg_size_t)(logio_spill_size))
-                 ((hg_const_string_t)(logio_spill_dir)))
+                 ((hg_const_string_t)(logio_spill_dir))
+                 ((int32_t)(client_pid)))
 MERCURY_GEN_PROC(unifyfs_attach_out_t,
                  ((int32_t)(ret)))
 DECLARE_MARGO_RPC_HANDLER(unifyfs_attach_rpc)
@@ -102,12 +103,17 @@ DECLARE_MARGO_RPC_HANDLER(unifyfs_metaget_rpc)
 
 /* unifyfs_sync_rpc (client => server)
  *
- * given app_id and client_id as input, read all write extents
+ * given app_id and client_id as input, read write extents
  * from client index in shared memory and insert corresponding
- * key/value pairs into our global metadata */
+ * key/value pairs into our global metadata. If gfid is not -1,
+ * only the leading extents of the index that belong to that
+ * file are read. The client may have two index buffers, index_buf
+ * selects which one to read. */
 MERCURY_GEN_PROC(unifyfs_sync_in_t,
                  ((int32_t)(app_id))
-                 ((int32_t)(client_id)))
+                 ((int32_t)(client_id))
+                 ((int32_t)(gfid))
+                 ((int32_t)(index_buf)))
 MERCURY_GEN_PROC(unifyfs_sync_out_t, ((int32_t)(ret)))
 DECLARE_MARGO_RPC_HANDLER(unifyfs_sync_rpc)
 
@@ -163,21 +169,23 @@ DECLARE_MARGO_RPC_HANDLER(unifyfs_laminate_rpc)
 
 /* unifyfs_read_rpc (client => server)
  *
- * given an app_id, client_id, global file id, an offset, and a length,
- * initiate read request for data */
+ * given an app_id, client_id, global file id, an offset, a length,
+ * and the address of the client read buffer (zero if the server should
+ * not place data directly into it), initiate read request for data */
 MERCURY_GEN_PROC(unifyfs_read_in_t,
                  ((int32_t)(app_id))
                  ((int32_t)(client_id))
                  ((int32_t)(gfid))
                  ((hg_size_t)(offset))
-                 ((hg_size_t)(length)))
+                 ((hg_size_t)(length))
+                 ((hg_size_t)(buf)))
 MERCURY_GEN_PROC(unifyfs_read_out_t, ((int32_t)(ret)))
 DECLARE_MARGO_RPC_HANDLER(unifyfs_read_rpc)
 
 /* unifyfs_mread_rpc (client => server)
  *
  * given an app_id, client_id, and count of read requests,
- * followed by list of (gfid, offset, length) tuples,
+ * followed by list of (gfid, offset, length, buf) tuples,
  * initiate read requests for data */
 MERCURY_GEN_PROC(unifyfs_mread_in_t,
                  ((int32_t)(app_id))
@@ -188,6 +196,49 @@ MERCURY_GEN_PROC(unifyfs_mread_in_t,
 MERCURY_GEN_PROC(unifyfs_mread_out_t, ((int32_t)(ret)))
 DECLARE_MARGO_RPC_HANDLER(unifyfs_mread_rpc)
 
+/* file range to look up node-local data for */
+typedef struct {
+    size_t offset;         /* file offset */
+    size_t length;         /* range length */
+    int32_t gfid;          /* global file id */
+} unifyfs_log_range_t;
+
+/* location of file data held in the write log of a client
+ * attached to the same server */
+typedef struct {
+    size_t offset;         /* file offset */
+    size_t length;         /* extent length */
+    size_t log_offset;     /* data offset within client log */
+    size_t log_mem_size;   /* size of client logio shmem region */
+    size_t log_spill_size; /* size of client logio spill file */
+    uint32_t log_attach_id; /* changes each time the log owner attaches */
+    int32_t log_app_id;    /* app id of client that wrote the data */
+    int32_t log_client_id; /* client id of client that wrote the data */
+    int32_t range_index;   /* index of range this extent belongs to */
+} unifyfs_log_extent_t;
+
+/* unifyfs_log_extents_rpc (client => server)
+ *
+ * given an app_id, client_id, and a list of file ranges, return the
+ * locations of data within the ranges that is held in the logs of
+ * clients attached to the same server, the server pulls the ranges
+ * from range_bulk and pushes the locations (grouped by range and
+ * sorted by file offset) to extent_bulk, which holds up to max_extents
+ * entries, num_ranges_done is the number of leading ranges for which
+ * all locations were returned */
+MERCURY_GEN_PROC(unifyfs_log_extents_in_t,
+                 ((int32_t)(app_id))
+                 ((int32_t)(client_id))
+                 ((int32_t)(num_ranges))
+                 ((int32_t)(max_extents))
+                 ((hg_bulk_t)(range_bulk))
+                 ((hg_bulk_t)(extent_bulk)))
+MERCURY_GEN_PROC(unifyfs_log_extents_out_t,
+                 ((int32_t)(ret))
+                 ((int32_t)(num_extents))
+                 ((int32_t)(num_ranges_done)))
+DECLARE_MARGO_RPC_HANDLER(unifyfs_log_extents_rpc)
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -72,8 +72,13 @@
     UNIFYFS_CFG(client, max_files, INT, UNIFYFS_MAX_FILES, "client max file count", NULL) \
     UNIFYFS_CFG(client, flatten_writes, BOOL, on, "flatten writes", NULL) \
     UNIFYFS_CFG(client, local_extents, BOOL, off, "track extents to service reads of local data", NULL) \
+    UNIFYFS_CFG(client, direct_read, BOOL, off, "server writes read data directly into application buffers", NULL) \
+    UNIFYFS_CFG(client, node_local_reads, BOOL, off, "read data written by clients on the same node directly from their logs", NULL) \
     UNIFYFS_CFG(client, recv_data_size, INT, UNIFYFS_DATA_RECV_SIZE, "shared memory segment size in bytes for receiving data from server", NULL) \
     UNIFYFS_CFG(client, write_index_size, INT, UNIFYFS_INDEX_BUF_SIZE, "write metadata index buffer size", NULL) \
+    UNIFYFS_CFG(client, async_index, BOOL, off, "flush full write metadata index buffers to the server in the background", NULL) \
+    UNIFYFS_CFG(client, attr_lease, INT, 0, "milliseconds to cache attributes of files that are not laminated", NULL) \
+    UNIFYFS_CFG(client, read_timeout, INT, UNIFYFS_READ_WAIT_TIMEOUT, "seconds to wait for the server to deliver read data", NULL) \
     UNIFYFS_CFG(client, cwd, STRING, NULLSTRING, "current working directory", NULL) \
     UNIFYFS_CFG_CLI(log, verbosity, INT, 0, "log verbosity level", NULL, 'v', "specify logging verbosity level") \
     UNIFYFS_CFG_CLI(log, file, STRING, unifyfsd.log, "log file name", NULL, 'l', "specify log file name") \
@@ -82,15 +87,22 @@
     UNIFYFS_CFG(logio, shmem_size, INT, UNIFYFS_LOGIO_SHMEM_SIZE, "log-based I/O shared memory region size", NULL) \
     UNIFYFS_CFG(logio, spill_size, INT, UNIFYFS_LOGIO_SPILL_SIZE, "log-based I/O spillover file size", NULL) \
     UNIFYFS_CFG(logio, spill_dir, STRING, NULLSTRING, "spillover directory", configurator_directory_check) \
+    UNIFYFS_CFG(logio, spill_mmap, BOOL, off, "map spillover files to read spilled data", NULL) \
+    UNIFYFS_CFG(logio, spill_prealloc, BOOL, off, "allocate spillover file blocks when the file is created", NULL) \
     UNIFYFS_CFG(margo, tcp, BOOL, on, "use TCP for server-server margo RPCs", NULL) \
     UNIFYFS_CFG(meta, db_name, STRING, META_DEFAULT_DB_NAME, "metadata database name", NULL) \
     UNIFYFS_CFG(meta, db_path, STRING, RUNDIR, "metadata database path", configurator_directory_check) \
+    UNIFYFS_CFG(meta, extent_store, STRING, leveldb, "file extent metadata store (leveldb | memory)", NULL) \
     UNIFYFS_CFG(meta, server_ratio, INT, META_DEFAULT_SERVER_RATIO, "metadata server ratio", NULL) \
     UNIFYFS_CFG(meta, range_size, INT, META_DEFAULT_RANGE_SZ, "metadata range size", NULL) \
+    UNIFYFS_CFG(meta, stripe_extents, BOOL, off, "stripe file extents across metadata servers by range", NULL) \
     UNIFYFS_CFG_CLI(runstate, dir, STRING, RUNDIR, "runstate file directory", configurator_directory_check, 'R', "specify full path to directory to contain server runstate file") \
     UNIFYFS_CFG_CLI(server, hostfile, STRING, NULLSTRING, "server hostfile name", NULL, 'H', "specify full path to server hostfile") \
     UNIFYFS_CFG_CLI(sharedfs, dir, STRING, NULLSTRING, "shared file system directory", configurator_directory_check, 'S', "specify full path to directory to contain server shared files") \
     UNIFYFS_CFG_CLI(server, init_timeout, INT, UNIFYFS_DEFAULT_INIT_TIMEOUT, "timeout of waiting for server initialization", NULL, 't', "timeout in seconds to wait for servers to be ready for clients") \
+    UNIFYFS_CFG(server, rm_threads, INT, 0, "number of request manager threads (0 = one per core)", NULL) \
+    UNIFYFS_CFG(server, client_timeout, INT, UNIFYFS_CLIENT_WAIT_TIMEOUT, "seconds to wait for a client to consume read data", NULL) \
+    UNIFYFS_CFG(server, bulk_pool_size, INT, UNIFYFS_BULK_POOL_SIZE, "cap in bytes on registered buffers for server-to-server read responses", NULL) \
 
 
 #ifdef __cplusplus
@@ -52,15 +52,15 @@
 // Server - Request Manager
 #define MAX_META_PER_SEND (4 * KIB)  /* max read request count per server */
 #define REQ_BUF_LEN (MAX_META_PER_SEND * 64) /* chunk read reqs buffer size */
-#define SHM_WAIT_INTERVAL 1000       /* unit: ns */
+#define SHM_WAIT_SPIN_COUNT 10000    /* shmem state polls before blocking */
 #define RM_MAX_ACTIVE_REQUESTS 64    /* number of concurrent read requests */
+#define UNIFYFS_CLIENT_WAIT_TIMEOUT 600 /* secs to wait for client to drain */
+#define RM_RESPONSE_WINDOW_SIZE (16 * MIB) /* bulk pull size for responses */
+#define RM_MAX_INFLIGHT_WINDOWS 4    /* pulled or unhandled windows per response */
 
 // Server - Service Manager
-#define LARGE_BURSTY_DATA (512 * MIB)
-#define MAX_BURSTY_INTERVAL 10000 /* unit: us */
-#define MIN_SLEEP_INTERVAL 100    /* unit: us */
-#define SLEEP_INTERVAL 500        /* unit: us */
-#define SLEEP_SLICE_PER_UNIT 50   /* unit: us */
+#define SM_MAX_INFLIGHT_RESPONSES 64 /* concurrent chunk read responses */
+#define UNIFYFS_BULK_POOL_SIZE (256 * MIB) /* registered response buffers */
 
 // Server - General
 #define MAX_NUM_APPS 64    /* max # apps supported by a single server */
@@ -74,8 +74,10 @@
 #define UNIFYFS_MAX_FILEDESCS UNIFYFS_MAX_FILES
 #define UNIFYFS_STREAM_BUFSIZE MIB
 #define UNIFYFS_DATA_RECV_SIZE (32 * MIB)
+#define UNIFYFS_READ_WAIT_TIMEOUT 300 /* secs to wait for server read data */
 #define UNIFYFS_INDEX_BUF_SIZE  (20 * MIB)
 #define UNIFYFS_MAX_READ_CNT KIB
+#define UNIFYFS_MAX_LOG_EXTENTS (4 * KIB) /* node-local extents per lookup */
 
 // Log-based I/O
 #define UNIFYFS_LOGIO_CHUNK_SIZE (4 * MIB)
@@ -12,9 +12,12 @@
  * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
  */
 
+#include <config.h>
+
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -30,6 +33,13 @@
 #define LOGIO_SHMEM_FMTSTR "logio_mem.%d.%d"
 #define LOGIO_SPILL_FMTSTR "%s/logio_spill.%d.%d"
 
+/* number of threads carrying out spill file I/O */
+#define LOGIO_SPILL_IO_THREADS 4
+
+/* spill file transfers are split into pieces of at most this size,
+ * so that a large transfer is carried out by several threads */
+#define LOGIO_SPILL_IO_SIZE (1024 * 1024)
+
 
 /* log-based I/O header - first page of shmem region or spill file */
 typedef struct log_header {
@@ -101,9 +111,266 @@ void get_log_sizes(off_t log_offset,
     }
 }
 
-/* open (or create) spill file at path and set its size */
+/* a set of spill file operations that are waited on together */
+typedef struct spill_io_batch {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int pending;             /* number of queued operations not done yet */
+} spill_io_batch;
+
+/* a pread() or pwrite() of a range of the spill file */
+typedef struct spill_io_op {
+    struct spill_io_op* next;
+    spill_io_batch* batch;
+    int    fd;
+    int    is_write;
+    char*  buf;
+    size_t len;
+    off_t  off;
+    size_t ndone;            /* [out] bytes transferred */
+    int    err;              /* [out] errno of failed transfer, or 0 */
+} spill_io_op;
+
+/* spill file I/O engine, a pool of threads that carries out queued
+ * spill operations so that many of them are in flight at once */
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    spill_io_op* head;
+    spill_io_op* tail;
+    int started;             /* have the I/O threads been started? */
+    int nthreads;            /* number of running I/O threads */
+    int atfork;              /* is the fork handler registered? */
+} spill_io = {
+    PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+    NULL, NULL, 0, 0, 0
+};
+
+/* transfer the full range of the operation, stopping short only
+ * on error or end of file */
+static void do_spill_io(spill_io_op* op)
+{
+    op->ndone = 0;
+    op->err = 0;
+    while (op->ndone < op->len) {
+        char* buf = op->buf + op->ndone;
+        size_t len = op->len - op->ndone;
+        off_t off = op->off + (off_t)op->ndone;
+        ssize_t rc;
+        if (op->is_write) {
+            rc = pwrite(op->fd, buf, len, off);
+        } else {
+            rc = pread(op->fd, buf, len, off);
+        }
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            op->err = errno;
+            LOGERR("%s(spillfile) failed: %s",
+                   (op->is_write ? "pwrite" : "pread"), strerror(op->err));
+            break;
+        } else if (rc == 0) {
+            break;
+        }
+        op->ndone += (size_t)rc;
+    }
+}
+
+static void* spill_io_thread(void* arg)
+{
+    (void) arg;
+    while (1) {
+        pthread_mutex_lock(&spill_io.lock);
+        while (NULL == spill_io.head) {
+            pthread_cond_wait(&spill_io.cond, &spill_io.lock);
+        }
+        spill_io_op* op = spill_io.head;
+        spill_io.head = op->next;
+        if (NULL == spill_io.head) {
+            spill_io.tail = NULL;
+        }
+        pthread_mutex_unlock(&spill_io.lock);
+
+        do_spill_io(op);
+
+        spill_io_batch* batch = op->batch;
+        pthread_mutex_lock(&(batch->lock));
+        batch->pending--;
+        if (0 == batch->pending) {
+            pthread_cond_signal(&(batch->cond));
+        }
+        pthread_mutex_unlock(&(batch->lock));
+    }
+    return NULL;
+}
+
+/* the I/O threads do not exist in a child process, so reset the
+ * engine there to start new ones on first use */
+static void spill_io_atfork_child(void)
+{
+    pthread_mutex_init(&spill_io.lock, NULL);
+    pthread_cond_init(&spill_io.cond, NULL);
+    spill_io.head = NULL;
+    spill_io.tail = NULL;
+    spill_io.started = 0;
+    spill_io.nthreads = 0;
+}
+
+/* start the spill I/O threads, if none can be started the spill
+ * operations are carried out by the caller, assumes the engine
+ * lock is held */
+static void start_spill_io(void)
+{
+    spill_io.started = 1;
+    if (!spill_io.atfork) {
+        int rc = pthread_atfork(NULL, NULL, spill_io_atfork_child);
+        if (rc != 0) {
+            LOGWARN("failed to register spill I/O fork handler: %s",
+                    strerror(rc));
+            return;
+        }
+        spill_io.atfork = 1;
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int i;
+    for (i = 0; i < LOGIO_SPILL_IO_THREADS; i++) {
+        pthread_t tid;
+        int rc = pthread_create(&tid, &attr, spill_io_thread, NULL);
+        if (rc != 0) {
+            LOGWARN("failed to start spill I/O thread: %s", strerror(rc));
+            break;
+        }
+        spill_io.nthreads++;
+    }
+    pthread_attr_destroy(&attr);
+}
+
+/* carry out the given spill operations and wait for all of them,
+ * the calling thread runs the first one while the I/O threads
+ * take the rest */
+static void run_spill_ops(spill_io_op* ops,
+                          size_t num_ops)
+{
+    size_t i;
+    if (0 == num_ops) {
+        return;
+    }
+
+    int nthreads = 0;
+    if (num_ops > 1) {
+        pthread_mutex_lock(&spill_io.lock);
+        if (!spill_io.started) {
+            start_spill_io();
+        }
+        nthreads = spill_io.nthreads;
+        pthread_mutex_unlock(&spill_io.lock);
+    }
+    if (0 == nthreads) {
+        for (i = 0; i < num_ops; i++) {
+            do_spill_io(&ops[i]);
+        }
+        return;
+    }
+
+    spill_io_batch batch;
+    pthread_mutex_init(&(batch.lock), NULL);
+    pthread_cond_init(&(batch.cond), NULL);
+    batch.pending = (int)(num_ops - 1);
+
+    pthread_mutex_lock(&spill_io.lock);
+    for (i = 1; i < num_ops; i++) {
+        spill_io_op* op = &ops[i];
+        op->batch = &batch;
+        op->next = NULL;
+        if (NULL == spill_io.tail) {
+            spill_io.head = op;
+        } else {
+            spill_io.tail->next = op;
+        }
+        spill_io.tail = op;
+    }
+    pthread_cond_broadcast(&spill_io.cond);
+    pthread_mutex_unlock(&spill_io.lock);
+
+    do_spill_io(&ops[0]);
+
+    pthread_mutex_lock(&(batch.lock));
+    while (batch.pending > 0) {
+        pthread_cond_wait(&(batch.cond), &(batch.lock));
+    }
+    pthread_mutex_unlock(&(batch.lock));
+    pthread_cond_destroy(&(batch.cond));
+    pthread_mutex_destroy(&(batch.lock));
+}
+
+/* number of spill operations used to transfer the given size */
+static inline
+size_t spill_io_pieces(size_t nbytes)
+{
+    return bytes_to_chunks(nbytes, LOGIO_SPILL_IO_SIZE);
+}
+
+/* fill spill operations for a transfer of the given range, returns
+ * the number of operations used */
+static size_t fill_spill_ops(spill_io_op* ops,
+                             int fd,
+                             int is_write,
+                             char* buf,
+                             size_t nbytes,
+                             off_t offset)
+{
+    size_t n = 0;
+    while (nbytes > 0) {
+        size_t len = nbytes;
+        if (len > LOGIO_SPILL_IO_SIZE) {
+            len = LOGIO_SPILL_IO_SIZE;
+        }
+        spill_io_op* op = &ops[n++];
+        memset(op, 0, sizeof(*op));
+        op->fd = fd;
+        op->is_write = is_write;
+        op->buf = buf;
+        op->len = len;
+        op->off = offset;
+        buf += len;
+        offset += (off_t)len;
+        nbytes -= len;
+    }
+    return n;
+}
+
+/* bytes transferred by a set of operations covering one contiguous
+ * range, which stops at the first short operation. If nothing was
+ * transferred, err is set to the error of the first failed operation. */
+static size_t spill_ops_done(spill_io_op* ops,
+                             size_t num_ops,
+                             int* err)
+{
+    size_t i;
+    size_t ndone = 0;
+    *err = 0;
+    for (i = 0; i < num_ops; i++) {
+        ndone += ops[i].ndone;
+        if (ops[i].ndone != ops[i].len) {
+            if (0 == ndone) {
+                *err = ops[i].err;
+            }
+            break;
+        }
+    }
+    return ndone;
+}
+
+/* open (or create) spill file at path and set its size, when prealloc
+ * is set the blocks of a new file are also allocated */
 static int get_spillfile(const char* path,
-                         const size_t spill_sz)
+                         const size_t spill_sz,
+                         const int prealloc)
 {
     /* try to create the spill file */
     mode_t perms = unifyfs_getmode(0640);
@@ -118,10 +385,29 @@ static int get_spillfile(const char* path,
         }
     } else {
         /* new spillover block created, set its size */
-        int rc = ftruncate(spill_fd, (off_t)spill_sz);
-        if (rc < 0) {
-            int err = errno;
-            LOGERR("ftruncate() failed: %s", strerror(err));
+        int rc = -1;
+#ifdef HAVE_POSIX_FALLOCATE
+        if (prealloc) {
+            /* allocate its blocks up front, so that writes to the spill
+             * file do not change its metadata and fail for lack of
+             * space, at the cost of using spill_sz of disk per client */
+            rc = posix_fallocate(spill_fd, 0, (off_t)spill_sz);
+            if (rc != 0) {
+                LOGWARN("posix_fallocate() failed: %s", strerror(rc));
+                rc = -1;
+            }
+        }
+#else
+        if (prealloc) {
+            LOGWARN("spillover preallocation is not supported");
+        }
+#endif
+        if (rc != 0) {
+            rc = ftruncate(spill_fd, (off_t)spill_sz);
+            if (rc < 0) {
+                int err = errno;
+                LOGERR("ftruncate() failed: %s", strerror(err));
+            }
         }
     }
     return spill_fd;
@@ -132,21 +418,25 @@ static void* map_spillfile(int spill_fd, int mmap_prot)
 {
     size_t pgsz = get_page_size();
     void* addr = mmap(NULL, pgsz, mmap_prot, MAP_SHARED, spill_fd, 0);
-    if (NULL == addr) {
+    if (MAP_FAILED == addr) {
         int err = errno;
         LOGERR("mmap(fd=%d, sz=%zu, MAP_SHARED) failed - %s",
                spill_fd, pgsz, strerror(err));
+        return NULL;
     }
     return addr;
 }
 
-/* Initialize logio context for server */
-int unifyfs_logio_init_server(const int app_id,
-                              const int client_id,
-                              const size_t mem_size,
-                              const size_t spill_size,
-                              const char* spill_dir,
-                              logio_context** pctx)
+/* attach to the log of the given client, the server creates the spill
+ * file if the client has not yet, while peer clients that only read
+ * from the log open an existing spill file read-only */
+static int attach_log(const int app_id,
+                      const int client_id,
+                      const size_t mem_size,
+                      const size_t spill_size,
+                      const char* spill_dir,
+                      const int read_only,
+                      logio_context** pctx)
 {
     if (NULL == pctx) {
         return EINVAL;
@@ -178,7 +468,13 @@ int unifyfs_logio_init_server(const int app_id,
         char spillfile[UNIFYFS_MAX_FILENAME];
         snprintf(spillfile, sizeof(spillfile), LOGIO_SPILL_FMTSTR,
                  spill_dir, app_id, client_id);
-        spill_fd = get_spillfile(spillfile, spill_size);
+        if (read_only) {
+            spill_fd = open(spillfile, O_RDONLY);
+        } else {
+            /* the client normally creates the file, so leave its
+             * blocks unallocated if the server gets here first */
+            spill_fd = get_spillfile(spillfile, spill_size, 0);
+        }
         if (spill_fd < 0) {
             LOGERR("Failed to open logio spill file!");
             return UNIFYFS_FAILURE;
@@ -202,11 +498,36 @@ int unifyfs_logio_init_server(const int app_id,
     ctx->spill_hdr = spill_mapping;
     ctx->spill_fd = spill_fd;
     ctx->spill_sz = spill_size;
+    pthread_mutex_init(&(ctx->dirty_lock), NULL);
     *pctx = ctx;
 
     return UNIFYFS_SUCCESS;
 }
 
+/* Initialize logio context for server */
+int unifyfs_logio_init_server(const int app_id,
+                              const int client_id,
+                              const size_t mem_size,
+                              const size_t spill_size,
+                              const char* spill_dir,
+                              logio_context** pctx)
+{
+    return attach_log(app_id, client_id, mem_size, spill_size, spill_dir,
+                      0, pctx);
+}
+
+/* Attach to the log of a co-located client for reading */
+int unifyfs_logio_attach_peer(const int app_id,
+                              const int client_id,
+                              const size_t mem_size,
+                              const size_t spill_size,
+                              const char* spill_dir,
+                              logio_context** pctx)
+{
+    return attach_log(app_id, client_id, mem_size, spill_size, spill_dir,
+                      1, pctx);
+}
+
 
 /* initialize the log header page for given log region and size
  * (note: intended for client use only) */
@@ -244,6 +565,42 @@ static int init_log_header(char* log_region,
     return UNIFYFS_SUCCESS;
 }
 
+/* Open chunk of a writer thread, small allocations made by the thread
+ * are carved from it. The live byte count of the chunk includes the
+ * unused remainder until the thread moves on to a new chunk. */
+typedef struct logio_arena {
+    logio_context* ctx;
+    off_t  offset;        /* log offset of next free byte in open chunk */
+    size_t remain;        /* free bytes remaining in open chunk */
+} logio_arena;
+
+static int update_chunk_refs(logio_context* ctx,
+                             off_t log_offset,
+                             size_t nbytes,
+                             int add);
+
+/* drop the unused remainder of the arena's open chunk */
+static void close_arena(logio_arena* arena)
+{
+    if (arena->remain > 0) {
+        update_chunk_refs(arena->ctx, arena->offset, arena->remain, 0);
+        arena->remain = 0;
+    }
+}
+
+/* thread-specific data destructor for exiting writer threads */
+static void free_arena(void* arg)
+{
+    logio_arena* arena = (logio_arena*) arg;
+    if (NULL != arena) {
+        logio_context* ctx = arena->ctx;
+        pthread_mutex_lock(&(ctx->alloc_lock));
+        close_arena(arena);
+        pthread_mutex_unlock(&(ctx->alloc_lock));
+        free(arena);
+    }
+}
+
 /* Initialize logio for client */
 int unifyfs_logio_init_client(const int app_id,
                               const int client_id,
@@ -333,8 +690,19 @@ int unifyfs_logio_init_client(const int app_id,
         snprintf(spillfile, sizeof(spillfile), LOGIO_SPILL_FMTSTR,
                  cfgval, app_id, client_id);
 
+        /* should the spill file blocks be allocated up front? */
+        int prealloc = 0;
+        cfgval = client_cfg->logio_spill_prealloc;
+        if (cfgval != NULL) {
+            bool b;
+            rc = configurator_bool_val(cfgval, &b);
+            if (rc == 0) {
+                prealloc = (int)b;
+            }
+        }
+
         /* create the spill over file */
-        spill_fd = get_spillfile(spillfile, spill_size);
+        spill_fd = get_spillfile(spillfile, spill_size, prealloc);
         if (spill_fd < 0) {
             LOGERR("Failed to open logio spill file!");
             return UNIFYFS_FAILURE;
@@ -366,11 +734,66 @@ int unifyfs_logio_init_client(const int app_id,
     ctx->spill_hdr = spill_mapping;
     ctx->spill_fd = spill_fd;
     ctx->spill_sz = spill_size;
+    pthread_mutex_init(&(ctx->dirty_lock), NULL);
+
+    /* allocate live byte counts for each chunk, so that we know
+     * when chunks can be returned to the log */
+    if (NULL != shm_ctx) {
+        slot_map* chunkmap = log_header_to_chunkmap(shm_ctx->addr);
+        ctx->mem_chunks = chunkmap->total_slots;
+    }
+    ctx->num_chunks = ctx->mem_chunks;
+    if (NULL != spill_mapping) {
+        slot_map* chunkmap = log_header_to_chunkmap(spill_mapping);
+        ctx->num_chunks += chunkmap->total_slots;
+    }
+    if (ctx->num_chunks) {
+        ctx->chunk_refs = (size_t*) calloc(ctx->num_chunks, sizeof(size_t));
+        if (NULL == ctx->chunk_refs) {
+            LOGERR("Failed to allocate logio chunk reference counts!");
+            pthread_mutex_destroy(&(ctx->dirty_lock));
+            free(ctx);
+            return ENOMEM;
+        }
+        rc = pthread_key_create(&(ctx->arena_key), free_arena);
+        if (rc != 0) {
+            LOGERR("Failed to create logio arena key!");
+            free(ctx->chunk_refs);
+            pthread_mutex_destroy(&(ctx->dirty_lock));
+            free(ctx);
+            return rc;
+        }
+        pthread_mutex_init(&(ctx->alloc_lock), NULL);
+    }
     *pctx = ctx;
 
     return UNIFYFS_SUCCESS;
 }
 
+/* Map the whole spill file for reads */
+int unifyfs_logio_map_spill(logio_context* ctx)
+{
+    if (NULL == ctx) {
+        return EINVAL;
+    }
+
+    if ((0 == ctx->spill_sz) || (-1 == ctx->spill_fd) ||
+        (NULL != ctx->spill_map)) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    void* addr = mmap(NULL, ctx->spill_sz, PROT_READ, MAP_SHARED,
+                      ctx->spill_fd, 0);
+    if (MAP_FAILED == addr) {
+        int err = errno;
+        LOGERR("mmap(fd=%d, sz=%zu, MAP_SHARED) failed - %s",
+               ctx->spill_fd, ctx->spill_sz, strerror(err));
+        return err;
+    }
+    ctx->spill_map = (char*) addr;
+    return UNIFYFS_SUCCESS;
+}
+
 /* Close logio context */
 int unifyfs_logio_close(logio_context* ctx)
 {
@@ -388,6 +811,16 @@ int unifyfs_logio_close(logio_context* ctx)
     }
 
     if (ctx->spill_sz) {
+        if (NULL != ctx->spill_map) {
+            /* unmap spill file */
+            rc = munmap(ctx->spill_map, ctx->spill_sz);
+            if (rc != 0) {
+                int err = errno;
+                LOGERR("Failed to unmap logio spill file (errno=%s)",
+                       strerror(err));
+            }
+            ctx->spill_map = NULL;
+        }
         if (NULL != ctx->spill_hdr) {
             /* unmap log header page */
             rc = munmap(ctx->spill_hdr, get_page_size());
@@ -411,26 +844,29 @@ int unifyfs_logio_close(logio_context* ctx)
     }
 
     /* free the context struct */
+    if (NULL != ctx->chunk_refs) {
+        /* deleting the key does not run destructors, so only the arena
+         * of the calling thread is freed */
+        logio_arena* arena = pthread_getspecific(ctx->arena_key);
+        if (NULL != arena) {
+            pthread_setspecific(ctx->arena_key, NULL);
+            free(arena);
+        }
+        pthread_key_delete(ctx->arena_key);
+        pthread_mutex_destroy(&(ctx->alloc_lock));
+        free(ctx->chunk_refs);
+    }
+    pthread_mutex_destroy(&(ctx->dirty_lock));
     free(ctx);
 
     return UNIFYFS_SUCCESS;
 }
 
-/* Allocate write space from logio context */
-int unifyfs_logio_alloc(logio_context* ctx,
-                        const size_t nbytes,
-                        off_t* log_offset)
+/* Reserve whole chunks for write space from logio context */
+static int alloc_log_chunks(logio_context* ctx,
+                            const size_t nbytes,
+                            off_t* log_offset)
 {
-    if ((NULL == ctx) ||
-        ((nbytes > 0) && (NULL == log_offset))) {
-        return EINVAL;
-    }
-
-    if (0 == nbytes) {
-        LOGWARN("zero bytes allocated from log!");
-        return UNIFYFS_SUCCESS;
-    }
-
     size_t chunk_sz = 0;
     size_t allocated_bytes = 0;
     size_t needed_bytes = nbytes;
@@ -477,12 +913,22 @@ int unifyfs_logio_alloc(logio_context* ctx,
         if (log_end_chunks > 0) {
             res_chunks = log_end_chunks;
             res_slot = slotmap_reserve(chunkmap, res_chunks);
+            if ((-1 != res_slot) &&
+                ((res_slot + res_chunks) != chunkmap->total_slots)) {
+                /* free chunks found earlier in the log, not at the end */
+                int rc = slotmap_release(chunkmap, res_slot, res_chunks);
+                if (rc != UNIFYFS_SUCCESS) {
+                    LOGERR("slotmap_release() for logio shmem failed");
+                }
+                res_slot = -1;
+            }
             if (-1 != res_slot) {
-                /* reserved all chunks at end of shmem log */
-                allocated_bytes = res_chunks * chunk_sz;
-                needed_bytes -= allocated_bytes;
+                /* reserved all chunks at end of shmem log, which also
+                 * covers any shmem bytes past the last full chunk */
                 res_off = (off_t)(res_slot * chunk_sz);
-                mem_allocation = allocated_bytes;
+                allocated_bytes = shmem_hdr->data_sz - (size_t)res_off;
+                needed_bytes -= allocated_bytes;
+                mem_allocation = res_chunks * chunk_sz;
                 mem_res_slot = res_slot;
                 mem_res_nchk = res_chunks;
                 mem_res_at_end = 1;
@@ -545,6 +991,7 @@ int unifyfs_logio_alloc(logio_context* ctx,
                     res_slot = slotmap_reserve(chunkmap, res_chunks);
                     if (-1 != res_slot) {
                         /* success, full reservation in spill */
+                        allocated_bytes = res_chunks * chunk_sz;
                         spill_hdr->reserved_sz += allocated_bytes;
                         spill_hdr->max_reserved_slot =
                             (res_slot + res_chunks) - 1;
@@ -582,6 +1029,199 @@ int unifyfs_logio_alloc(logio_context* ctx,
     return ENOSPC;
 }
 
+/* locate chunk holding the given log offset, sets index of the chunk
+ * (shmem chunks come first, then spill chunks) and the log offsets at
+ * which the chunk begins and ends */
+static int log_offset_to_chunk(logio_context* ctx,
+                               off_t log_offset,
+                               size_t* chunk_ndx,
+                               off_t* chunk_start,
+                               off_t* chunk_end)
+{
+    off_t mem_size = 0;
+    if (NULL != ctx->shmem) {
+        log_header* shmem_hdr = (log_header*) ctx->shmem->addr;
+        mem_size = (off_t) shmem_hdr->data_sz;
+        if ((log_offset < mem_size) && (ctx->mem_chunks > 0)) {
+            /* any bytes past the last full chunk of shmem belong to the
+             * last chunk, since allocations spanning into spill use them */
+            size_t chunk_sz = shmem_hdr->chunk_sz;
+            size_t ndx = (size_t)log_offset / chunk_sz;
+            if (ndx >= ctx->mem_chunks) {
+                ndx = ctx->mem_chunks - 1;
+            }
+            *chunk_ndx = ndx;
+            *chunk_start = (off_t)(ndx * chunk_sz);
+            if (ndx == (ctx->mem_chunks - 1)) {
+                *chunk_end = mem_size;
+            } else {
+                *chunk_end = (off_t)((ndx + 1) * chunk_sz);
+            }
+            return UNIFYFS_SUCCESS;
+        }
+    }
+
+    if ((NULL != ctx->spill_hdr) && (log_offset >= mem_size)) {
+        log_header* spill_hdr = (log_header*) ctx->spill_hdr;
+        size_t chunk_sz = spill_hdr->chunk_sz;
+        size_t slot = (size_t)(log_offset - mem_size) / chunk_sz;
+        size_t ndx = ctx->mem_chunks + slot;
+        if (ndx < ctx->num_chunks) {
+            *chunk_ndx = ndx;
+            *chunk_start = mem_size + (off_t)(slot * chunk_sz);
+            *chunk_end = *chunk_start + (off_t)chunk_sz;
+            return UNIFYFS_SUCCESS;
+        }
+    }
+
+    LOGERR("log offset %zu is outside of log", (size_t)log_offset);
+    return EINVAL;
+}
+
+/* return chunk with given index to the log */
+static void release_chunk(logio_context* ctx,
+                          size_t chunk_ndx)
+{
+    log_header* hdr;
+    size_t slot;
+    if (chunk_ndx < ctx->mem_chunks) {
+        hdr = (log_header*) ctx->shmem->addr;
+        slot = chunk_ndx;
+    } else {
+        hdr = (log_header*) ctx->spill_hdr;
+        slot = chunk_ndx - ctx->mem_chunks;
+    }
+    slot_map* chunkmap = log_header_to_chunkmap(hdr);
+    int rc = slotmap_release(chunkmap, slot, 1);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("slotmap_release() for logio chunk %zu failed", chunk_ndx);
+    } else {
+        hdr->reserved_sz -= hdr->chunk_sz;
+    }
+}
+
+/* add (or drop) references to the chunks holding the given log range,
+ * chunks are released once they no longer hold any live bytes, a chunk
+ * asked to drop more bytes than it holds is left allocated since its
+ * count can no longer be trusted */
+static int update_chunk_refs(logio_context* ctx,
+                             off_t log_offset,
+                             size_t nbytes,
+                             int add)
+{
+    int ret = UNIFYFS_SUCCESS;
+    while (nbytes > 0) {
+        size_t ndx;
+        off_t chunk_start, chunk_end;
+        int rc = log_offset_to_chunk(ctx, log_offset, &ndx,
+                                     &chunk_start, &chunk_end);
+        if (rc != UNIFYFS_SUCCESS) {
+            return rc;
+        }
+
+        size_t n = (size_t)(chunk_end - log_offset);
+        if (n > nbytes) {
+            n = nbytes;
+        }
+
+        if (add) {
+            ctx->chunk_refs[ndx] += n;
+        } else {
+            if (ctx->chunk_refs[ndx] < n) {
+                LOGERR("releasing %zu bytes from chunk %zu holding %zu",
+                       n, ndx, ctx->chunk_refs[ndx]);
+                ret = EINVAL;
+            } else {
+                ctx->chunk_refs[ndx] -= n;
+                if (0 == ctx->chunk_refs[ndx]) {
+                    release_chunk(ctx, ndx);
+                }
+            }
+        }
+
+        log_offset += (off_t)n;
+        nbytes -= n;
+    }
+    return ret;
+}
+
+/* Allocate write space from logio context */
+int unifyfs_logio_alloc(logio_context* ctx,
+                        const size_t nbytes,
+                        off_t* log_offset)
+{
+    if ((NULL == ctx) ||
+        ((nbytes > 0) && (NULL == log_offset))) {
+        return EINVAL;
+    }
+
+    if (0 == nbytes) {
+        LOGWARN("zero bytes allocated from log!");
+        return UNIFYFS_SUCCESS;
+    }
+
+    size_t chunk_sz = 0;
+    if (NULL != ctx->shmem) {
+        chunk_sz = ((log_header*) ctx->shmem->addr)->chunk_sz;
+    } else if (NULL != ctx->spill_hdr) {
+        chunk_sz = ((log_header*) ctx->spill_hdr)->chunk_sz;
+    }
+
+    if (NULL == ctx->chunk_refs) {
+        LOGERR("logio context does not own its log");
+        return EINVAL;
+    }
+
+    int rc;
+    if (nbytes >= chunk_sz) {
+        /* large allocations get their own chunks */
+        pthread_mutex_lock(&(ctx->alloc_lock));
+        rc = alloc_log_chunks(ctx, nbytes, log_offset);
+        if (rc == UNIFYFS_SUCCESS) {
+            update_chunk_refs(ctx, *log_offset, nbytes, 1);
+        }
+        pthread_mutex_unlock(&(ctx->alloc_lock));
+        return rc;
+    }
+
+    /* pack small allocations into the open chunk of this thread, so
+     * that consecutive small writes share a chunk rather than consuming
+     * one each, and threads do not contend for the same chunk */
+    logio_arena* arena = pthread_getspecific(ctx->arena_key);
+    if (NULL == arena) {
+        arena = (logio_arena*) calloc(1, sizeof(logio_arena));
+        if (NULL == arena) {
+            return ENOMEM;
+        }
+        arena->ctx = ctx;
+        pthread_setspecific(ctx->arena_key, arena);
+    }
+
+    if (arena->remain < nbytes) {
+        /* open chunk is full, reserve a new one (a single chunk is
+         * always contiguous within either shmem or spill) */
+        off_t chunk_off;
+        pthread_mutex_lock(&(ctx->alloc_lock));
+        close_arena(arena);
+        rc = alloc_log_chunks(ctx, chunk_sz, &chunk_off);
+        if (rc == UNIFYFS_SUCCESS) {
+            update_chunk_refs(ctx, chunk_off, chunk_sz, 1);
+        }
+        pthread_mutex_unlock(&(ctx->alloc_lock));
+        if (rc != UNIFYFS_SUCCESS) {
+            return rc;
+        }
+        arena->offset = chunk_off;
+        arena->remain = chunk_sz;
+    }
+
+    /* bytes of the open chunk are already counted as live */
+    *log_offset = arena->offset;
+    arena->offset += (off_t) nbytes;
+    arena->remain -= nbytes;
+    return UNIFYFS_SUCCESS;
+}
+
 /* Release previously allocated write space from logio context */
 int unifyfs_logio_free(logio_context* ctx,
                        const off_t log_offset,
@@ -596,49 +1236,155 @@ int unifyfs_logio_free(logio_context* ctx,
         return UNIFYFS_SUCCESS;
     }
 
-    log_header* shmem_hdr = NULL;
-    log_header* spill_hdr = NULL;
-    slot_map* chunkmap;
+    if (NULL == ctx->chunk_refs) {
+        LOGERR("logio context does not own its log");
+        return EINVAL;
+    }
 
-    off_t mem_size = 0;
-    if (NULL != ctx->shmem) {
-        shmem_hdr = (log_header*) ctx->shmem->addr;
-        mem_size = (off_t) shmem_hdr->data_sz;
+    /* drop references to the chunks holding the released bytes, which
+     * returns chunks to the log once none of their bytes are live */
+    pthread_mutex_lock(&(ctx->alloc_lock));
+    int rc = update_chunk_refs(ctx, log_offset, nbytes, 0);
+    pthread_mutex_unlock(&(ctx->alloc_lock));
+    return rc;
+}
+
+/* Read data for a batch of log reads */
+int unifyfs_logio_read_batch(logio_read_req* reqs,
+                             int num_reqs)
+{
+    int i;
+    if ((num_reqs > 0) && (NULL == reqs)) {
+        return EINVAL;
     }
 
-    /* determine chunk allocations based on log offset */
-    size_t sz_in_mem = 0;
-    size_t sz_in_spill = 0;
-    off_t spill_offset = 0;
-    get_log_sizes(log_offset, nbytes, mem_size,
-                  &sz_in_mem, &sz_in_spill, &spill_offset);
+    /* copy the shmem part of each read and count the spill
+     * operations needed for the rest */
+    size_t num_ops = 0;
+    for (i = 0; i < num_reqs; i++) {
+        logio_read_req* req = &reqs[i];
+        logio_context* ctx = req->ctx;
+        req->nread = 0;
+        req->rc = UNIFYFS_SUCCESS;
+        if ((NULL == ctx) ||
+            ((req->nbytes > 0) && (NULL == req->buf))) {
+            req->rc = EINVAL;
+            continue;
+        }
+        if (0 == req->nbytes) {
+            LOGWARN("zero bytes read from log!");
+            continue;
+        }
 
-    int rc = UNIFYFS_SUCCESS;
-    size_t chunk_sz, chunk_slot, num_chunks;
-    if (sz_in_mem > 0) {
-        /* release shared memory chunks */
-        chunk_sz = shmem_hdr->chunk_sz;
-        chunk_slot = log_offset / chunk_sz;
-        num_chunks = bytes_to_chunks(sz_in_mem, chunk_sz);
-        chunkmap = log_header_to_chunkmap(shmem_hdr);
-        rc = slotmap_release(chunkmap, chunk_slot, num_chunks);
-        if (rc != UNIFYFS_SUCCESS) {
-            LOGERR("slotmap_release() for logio shmem failed");
+        log_header* shmem_hdr = NULL;
+        off_t mem_size = 0;
+        if (NULL != ctx->shmem) {
+            shmem_hdr = (log_header*) ctx->shmem->addr;
+            mem_size = (off_t) shmem_hdr->data_sz;
+        }
+
+        size_t sz_in_mem = 0;
+        size_t sz_in_spill = 0;
+        off_t spill_offset = 0;
+        get_log_sizes(req->log_offset, req->nbytes, mem_size,
+                      &sz_in_mem, &sz_in_spill, &spill_offset);
+        if (sz_in_mem > 0) {
+            /* read data from shared memory */
+            char* shmem_data = (char*)(ctx->shmem->addr) +
+                               shmem_hdr->data_offset;
+            char* log_ptr = shmem_data + req->log_offset;
+            memcpy(req->buf, log_ptr, sz_in_mem);
+            req->nread = sz_in_mem;
+        }
+        if (sz_in_spill > 0) {
+            if (NULL == ctx->spill_hdr) {
+                LOGERR("log offset %zu is outside of log",
+                       (size_t)req->log_offset);
+                req->rc = EINVAL;
+            } else if (NULL != ctx->spill_map) {
+                /* copy data from the spill file mapping, stopping
+                 * at the end of the file like pread() */
+                log_header* spill_hdr = (log_header*) ctx->spill_hdr;
+                spill_offset += spill_hdr->data_offset;
+                if ((size_t)spill_offset >= ctx->spill_sz) {
+                    sz_in_spill = 0;
+                } else if ((spill_offset + sz_in_spill) > ctx->spill_sz) {
+                    sz_in_spill = ctx->spill_sz - (size_t)spill_offset;
+                }
+                memcpy(req->buf + sz_in_mem,
+                       ctx->spill_map + spill_offset, sz_in_spill);
+                req->nread += sz_in_spill;
+            } else {
+                num_ops += spill_io_pieces(sz_in_spill);
+            }
         }
     }
-    if (sz_in_spill > 0) {
-        /* release spill chunks */
-        spill_hdr = (log_header*) ctx->spill_hdr;
-        chunk_sz = spill_hdr->chunk_sz;
-        chunk_slot = spill_offset / chunk_sz;
-        num_chunks = bytes_to_chunks(sz_in_spill, chunk_sz);
-        chunkmap = log_header_to_chunkmap(spill_hdr);
-        rc = slotmap_release(chunkmap, chunk_slot, num_chunks);
-        if (rc != UNIFYFS_SUCCESS) {
-            LOGERR("slotmap_release() for logio spill failed");
+    if (0 == num_ops) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    spill_io_op* ops = (spill_io_op*) calloc(num_ops, sizeof(spill_io_op));
+    if (NULL == ops) {
+        LOGERR("failed to allocate spill read operations");
+        return ENOMEM;
+    }
+
+    /* issue the spill reads of all requests together */
+    size_t n = 0;
+    for (i = 0; i < num_reqs; i++) {
+        logio_read_req* req = &reqs[i];
+        if ((UNIFYFS_SUCCESS != req->rc) || (0 == req->nbytes) ||
+            (NULL != req->ctx->spill_map)) {
+            continue;
+        }
+        logio_context* ctx = req->ctx;
+        off_t mem_size = 0;
+        if (NULL != ctx->shmem) {
+            mem_size = (off_t)((log_header*) ctx->shmem->addr)->data_sz;
+        }
+
+        size_t sz_in_mem = 0;
+        size_t sz_in_spill = 0;
+        off_t spill_offset = 0;
+        get_log_sizes(req->log_offset, req->nbytes, mem_size,
+                      &sz_in_mem, &sz_in_spill, &spill_offset);
+        if (sz_in_spill > 0) {
+            log_header* spill_hdr = (log_header*) ctx->spill_hdr;
+            spill_offset += spill_hdr->data_offset;
+            n += fill_spill_ops(ops + n, ctx->spill_fd, 0,
+                                req->buf + sz_in_mem, sz_in_spill,
+                                spill_offset);
         }
     }
-    return rc;
+    assert(n == num_ops);
+    run_spill_ops(ops, num_ops);
+
+    /* tally the bytes read for each request */
+    n = 0;
+    for (i = 0; i < num_reqs; i++) {
+        logio_read_req* req = &reqs[i];
+        if ((UNIFYFS_SUCCESS != req->rc) || (0 == req->nbytes) ||
+            (NULL != req->ctx->spill_map)) {
+            continue;
+        }
+        size_t sz_in_spill = req->nbytes - req->nread;
+        if (sz_in_spill > 0) {
+            size_t req_ops = spill_io_pieces(sz_in_spill);
+            int err;
+            req->nread += spill_ops_done(ops + n, req_ops, &err);
+            if (0 == req->nread) {
+                req->rc = err;
+            }
+            n += req_ops;
+        }
+        if ((req->nread > 0) && (req->nread != req->nbytes)) {
+            LOGDBG("partial log read: %zu of %zu bytes",
+                   req->nread, req->nbytes);
+        }
+    }
+    free(ops);
+
+    return UNIFYFS_SUCCESS;
 }
 
 /* Read data from logio context */
@@ -657,61 +1403,40 @@ int unifyfs_logio_read(logio_context* ctx,
         *obytes = 0;
     }
 
-    if (0 == nbytes) {
-        LOGWARN("zero bytes read from log!");
-        return UNIFYFS_SUCCESS;
+    logio_read_req req;
+    req.ctx        = ctx;
+    req.log_offset = log_offset;
+    req.nbytes     = nbytes;
+    req.buf        = obuf;
+    int rc = unifyfs_logio_read_batch(&req, 1);
+    if (rc != UNIFYFS_SUCCESS) {
+        return rc;
     }
-
-    log_header* shmem_hdr = NULL;
-    off_t mem_size = 0;
-    if (NULL != ctx->shmem) {
-        shmem_hdr = (log_header*) ctx->shmem->addr;
-        mem_size = (off_t) shmem_hdr->data_sz;
-    }
-
-    /* prepare read operations based on log offset */
-    size_t nread = 0;
-    size_t sz_in_mem = 0;
-    size_t sz_in_spill = 0;
-    off_t spill_offset = 0;
-    get_log_sizes(log_offset, nbytes, mem_size,
-                  &sz_in_mem, &sz_in_spill, &spill_offset);
-
-    /* do reads */
-    int err_rc = 0;
-    if (sz_in_mem > 0) {
-        /* read data from shared memory */
-        char* shmem_data = (char*)(ctx->shmem->addr) + shmem_hdr->data_offset;
-        char* log_ptr = shmem_data + log_offset;
-        memcpy(obuf, log_ptr, sz_in_mem);
-        nread += sz_in_mem;
-    }
-    if (sz_in_spill > 0) {
-        log_header* spill_hdr = (log_header*) ctx->spill_hdr;
-        spill_offset += spill_hdr->data_offset;
-
-        /* read data from spillover file */
-        ssize_t rc = pread(ctx->spill_fd, (obuf + sz_in_mem),
-                           sz_in_spill, spill_offset);
-        if (-1 == rc) {
-            err_rc = errno;
-            LOGERR("pread(spillfile) failed: %s", strerror(err_rc));
-        } else {
-            nread += rc;
-        }
+    if ((req.rc == UNIFYFS_SUCCESS) && (NULL != obytes)) {
+        *obytes = req.nread;
     }
+    return req.rc;
+}
 
-    if (nread) {
-        if (nread != nbytes) {
-            LOGDBG("partial log read: %zu of %zu bytes", nread, nbytes);
+/* add written range of spill file to the range to flush on sync */
+static void mark_spill_dirty(logio_context* ctx,
+                             off_t offset,
+                             size_t nbytes)
+{
+    off_t end = offset + (off_t)nbytes;
+    pthread_mutex_lock(&(ctx->dirty_lock));
+    if (ctx->dirty_end == ctx->dirty_start) {
+        ctx->dirty_start = offset;
+        ctx->dirty_end = end;
+    } else {
+        if (offset < ctx->dirty_start) {
+            ctx->dirty_start = offset;
         }
-        if (NULL != obytes) {
-            *obytes = nread;
+        if (end > ctx->dirty_end) {
+            ctx->dirty_end = end;
         }
-        return UNIFYFS_SUCCESS;
-    } else {
-        return err_rc;
     }
+    pthread_mutex_unlock(&(ctx->dirty_lock));
 }
 
 /* Write data to logio context */
@@ -763,15 +1488,38 @@ int unifyfs_logio_write(logio_context* ctx,
         log_header* spill_hdr = (log_header*) ctx->spill_hdr;
         spill_offset += spill_hdr->data_offset;
 
-        /* write data to spillover file */
-        ssize_t rc = pwrite(ctx->spill_fd, (ibuf + sz_in_mem),
-                            sz_in_spill, spill_offset);
-        if (-1 == rc) {
-            err_rc = errno;
-            LOGERR("pwrite(spillfile) failed: %s", strerror(err_rc));
+        /* write data to spillover file, large writes are split
+         * across the spill I/O threads */
+        char* spill_buf = (char*)(ibuf + sz_in_mem);
+        spill_io_op one_op;
+        spill_io_op* ops = NULL;
+        size_t num_ops = spill_io_pieces(sz_in_spill);
+        if (num_ops > 1) {
+            ops = (spill_io_op*) calloc(num_ops, sizeof(spill_io_op));
+        }
+        if (NULL != ops) {
+            fill_spill_ops(ops, ctx->spill_fd, 1, spill_buf,
+                           sz_in_spill, spill_offset);
         } else {
-            nwrite += rc;
+            /* write it all from this thread */
+            ops = &one_op;
+            num_ops = 1;
+            memset(ops, 0, sizeof(*ops));
+            ops->fd = ctx->spill_fd;
+            ops->is_write = 1;
+            ops->buf = spill_buf;
+            ops->len = sz_in_spill;
+            ops->off = spill_offset;
+        }
+        run_spill_ops(ops, num_ops);
+        size_t spill_nwrite = spill_ops_done(ops, num_ops, &err_rc);
+        if (ops != &one_op) {
+            free(ops);
+        }
+        if (spill_nwrite > 0) {
+            mark_spill_dirty(ctx, spill_offset, spill_nwrite);
         }
+        nwrite += spill_nwrite;
     }
 
     /* update output parameter if we wrote anything */
@@ -794,12 +1542,39 @@ int unifyfs_logio_write(logio_context* ctx,
 int unifyfs_logio_sync(logio_context* ctx)
 {
     if ((ctx->spill_sz) && (-1 != ctx->spill_fd)) {
-        /* fsync spill file */
-        int rc = fsync(ctx->spill_fd);
+        /* the log header page of the spill file is updated through
+         * its mapping, flush it along with the data */
+        if (NULL != ctx->spill_hdr) {
+            int rc = msync(ctx->spill_hdr, get_page_size(), MS_SYNC);
+            if (rc != 0) {
+                int err = errno;
+                LOGERR("Failed to msync logio spill header (errno=%s)",
+                       strerror(err));
+                return err;
+            }
+        }
+
+        /* take the range written since the last sync, a write that
+         * lands while we flush is added to a new range */
+        pthread_mutex_lock(&(ctx->dirty_lock));
+        off_t start = ctx->dirty_start;
+        off_t end = ctx->dirty_end;
+        ctx->dirty_start = 0;
+        ctx->dirty_end = 0;
+        pthread_mutex_unlock(&(ctx->dirty_lock));
+        if (start == end) {
+            return UNIFYFS_SUCCESS;
+        }
+
+        /* flush spill file data, its size does not change after
+         * creation so the file metadata need not be flushed */
+        int rc = fdatasync(ctx->spill_fd);
         if (rc != 0) {
             int err = errno;
-            LOGERR("Failed to fsync logio spill file (errno=%s)",
+            LOGERR("Failed to fdatasync logio spill file (errno=%s)",
                    strerror(err));
+            /* keep the range so the next sync tries it again */
+            mark_spill_dirty(ctx, start, (size_t)(end - start));
             return err;
         }
     }
@@ -15,6 +15,7 @@
 #ifndef UNIFYFS_LOGIO_H
 #define UNIFYFS_LOGIO_H
 
+#include <pthread.h>
 #include <sys/types.h>
 
 #include "unifyfs_configurator.h"
@@ -30,8 +31,29 @@ typedef struct logio_context {
     void*  spill_hdr;     /* mmap() address for spillover file log header */
     size_t spill_sz;      /* size of spillover file */
     int    spill_fd;      /* spillover file descriptor */
+    char*  spill_map;     /* read-only mmap() of whole spillover file,
+                           * used for spill reads when set */
+    size_t* chunk_refs;   /* live bytes per chunk (writer only), indexed
+                           * by shmem chunks followed by spill chunks */
+    size_t mem_chunks;    /* number of shmem chunks */
+    size_t num_chunks;    /* total number of shmem and spill chunks */
+    pthread_mutex_t alloc_lock; /* guards chunk reservations and refs */
+    pthread_key_t arena_key;    /* per-thread open chunk for small allocs */
+    pthread_mutex_t dirty_lock; /* guards spill dirty range */
+    off_t  dirty_start;   /* spill file offset of first unsynced byte */
+    off_t  dirty_end;     /* spill file offset past last unsynced byte */
 } logio_context;
 
+/* a log read that is part of a batch of reads */
+typedef struct logio_read_req {
+    logio_context* ctx;   /* logio context holding the data */
+    off_t  log_offset;    /* log offset to read from */
+    size_t nbytes;        /* number of bytes to read */
+    char*  buf;           /* destination data buffer */
+    size_t nread;         /* [out] number of bytes actually read */
+    int    rc;            /* [out] UNIFYFS_SUCCESS, or error code */
+} logio_read_req;
+
 /**
  * Initialize logio context for server.
  *
@@ -50,6 +72,26 @@ int unifyfs_logio_init_server(const int app_id,
                               const char* spill_dir,
                               logio_context** ctx);
 
+/**
+ * Attach to the log of another client on the same node, so that data
+ * it wrote can be read directly. The log must already exist, and the
+ * context may only be used for reads.
+ *
+ * @param app_id application id of the log owner
+ * @param client_id client id of the log owner
+ * @param mem_sz shared memory region size of the log
+ * @param spill_sz spillfile size of the log
+ * @param spill_dir path to spillfile parent directory
+ * @param[out] ctx address of logio context pointer, set to new context
+ * @return UNIFYFS_SUCCESS, or error code
+ */
+int unifyfs_logio_attach_peer(const int app_id,
+                              const int client_id,
+                              const size_t mem_sz,
+                              const size_t spill_sz,
+                              const char* spill_dir,
+                              logio_context** ctx);
+
 /**
  * Initialize logio context for client.
  *
@@ -64,6 +106,17 @@ int unifyfs_logio_init_client(const int app_id,
                               const unifyfs_cfg_t* client_cfg,
                               logio_context** ctx);
 
+/**
+ * Map the whole spillover file of the logio context read-only, so
+ * that spill data is read by copying from the mapping rather than
+ * with pread(). This suits logs that are mostly read, e.g. those
+ * holding laminated files. Does nothing for a log without spill file.
+ *
+ * @param ctx pointer to logio context
+ * @return UNIFYFS_SUCCESS, or error code
+ */
+int unifyfs_logio_map_spill(logio_context* ctx);
+
 /**
  * Close logio context.
  *
@@ -73,7 +126,9 @@ int unifyfs_logio_init_client(const int app_id,
 int unifyfs_logio_close(logio_context* ctx);
 
 /**
- * Allocate write space from logio context.
+ * Allocate write space from logio context. Allocations smaller than
+ * the chunk size are packed into an open chunk owned by the calling
+ * thread, so concurrent writers only contend when reserving chunks.
  *
  * @param ctx pointer to logio context
  * @param nbytes size of allocation in bytes
@@ -85,7 +140,9 @@ int unifyfs_logio_alloc(logio_context* ctx,
                         off_t* log_offset);
 
 /**
- * Release previously allocated write space from logio context.
+ * Release previously allocated write space from logio context. Chunks
+ * are returned to the log once none of their bytes remain allocated.
+ * Only the client that owns the log may release space.
  *
  * @param ctx pointer to logio context
  * @param log_offset log offset of allocation to release
@@ -112,6 +169,19 @@ int unifyfs_logio_read(logio_context* ctx,
                        char* buf,
                        size_t* obytes);
 
+/**
+ * Read data for a batch of log reads. The spill file reads of all
+ * requests are issued together and carried out concurrently, and the
+ * call returns once every read has completed. The result of each read
+ * is set in its request.
+ *
+ * @param reqs array of read requests
+ * @param num_reqs number of read requests
+ * @return UNIFYFS_SUCCESS, or error code if the batch could not be issued
+ */
+int unifyfs_logio_read_batch(logio_read_req* reqs,
+                             int num_reqs);
+
 /**
  * Write data to logio context at given log offset.
  *
@@ -129,7 +199,8 @@ int unifyfs_logio_write(logio_context* ctx,
                         size_t* obytes);
 
 /**
- * Sync any spill data to disk for given logio context.
+ * Sync any spill data to disk for given logio context. The spill file
+ * data is only flushed if some was written since the last sync.
  *
  * @param ctx pointer to logio context
  * @return UNIFYFS_SUCCESS, or error code
@@ -15,11 +15,15 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
+#include <linux/futex.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 
 #include "unifyfs_const.h"
@@ -167,3 +171,88 @@ int unifyfs_shm_unlink(shm_context* ctx)
 
     return UNIFYFS_SUCCESS;
 }
+
+/* Sets state of a shared memory data segment. Stores made to the
+ * segment before the state change are visible to the process that
+ * observes the new state. Any process blocked waiting on the state
+ * is woken. */
+void unifyfs_shm_segment_signal(shm_data_segment* seg,
+                                shm_data_state_e state)
+{
+    int* futex = (int*)&(seg->state);
+    __atomic_store_n(futex, (int)state, __ATOMIC_SEQ_CST);
+
+    /* only enter the kernel if someone is blocked, waiters register
+     * before their final check of the state so we can't miss them */
+    if (__atomic_load_n(&(seg->waiters), __ATOMIC_SEQ_CST) > 0) {
+        syscall(SYS_futex, futex, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+}
+
+/* check whether segment state satisfies wait condition,
+ * returns observed state in cur */
+static int segment_state_reached(shm_data_segment* seg,
+                                 shm_data_state_e state,
+                                 int equal,
+                                 int* cur)
+{
+    *cur = __atomic_load_n((int*)&(seg->state), __ATOMIC_ACQUIRE);
+    if (equal) {
+        return (*cur == (int)state);
+    }
+    return (*cur != (int)state);
+}
+
+/* Waits for state of a shared memory data segment to become equal
+ * (or not equal) to the given state. Spins for SHM_WAIT_SPIN_COUNT
+ * checks so that short waits return quickly, then blocks on a futex.
+ * Returns UNIFYFS_SUCCESS, or UNIFYFS_ERROR_SHMEM on timeout. */
+int unifyfs_shm_segment_wait(shm_data_segment* seg,
+                             shm_data_state_e state,
+                             int equal,
+                             long timeout_ms)
+{
+    int cur;
+    int* futex = (int*)&(seg->state);
+
+    /* spin for a while */
+    for (int i = 0; i < SHM_WAIT_SPIN_COUNT; i++) {
+        if (segment_state_reached(seg, state, equal, &cur)) {
+            return UNIFYFS_SUCCESS;
+        }
+    }
+
+    /* compute time at which we give up */
+    struct timespec now, deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec  += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    /* block until state changes */
+    int rc = (int)UNIFYFS_SUCCESS;
+    __atomic_add_fetch(&(seg->waiters), 1, __ATOMIC_SEQ_CST);
+    while (!segment_state_reached(seg, state, equal, &cur)) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        struct timespec remain;
+        remain.tv_sec  = deadline.tv_sec - now.tv_sec;
+        remain.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+        if (remain.tv_nsec < 0) {
+            remain.tv_sec--;
+            remain.tv_nsec += 1000000000;
+        }
+        if (remain.tv_sec < 0) {
+            rc = (int)UNIFYFS_ERROR_SHMEM;
+            break;
+        }
+
+        /* sleeps only if state still has the value we observed */
+        syscall(SYS_futex, futex, FUTEX_WAIT, cur, &remain, NULL, 0);
+    }
+    __atomic_sub_fetch(&(seg->waiters), 1, __ATOMIC_SEQ_CST);
+
+    return rc;
+}
@@ -36,37 +36,67 @@ extern "C" {
 
 /* Header for read-request reply in client shared memory region.
  * The associated data payload immediately follows the header in
- * the shmem region.
+ * the shmem region, unless the data was written directly into
+ * the client read buffer.
  *   offset  - offset within file
  *   length  - data size
  *   gfid    - global file id
- *   errcode - read error code (zero on success) */
+ *   errcode - read error code (zero on success)
+ *   direct  - data was placed in client buffer (no payload follows) */
 typedef struct shm_data_meta {
     size_t offset;
     size_t length;
     int gfid;
     int errcode;
+    int direct;
 } shm_data_meta;
 
-/* State values for client shared memory region */
+/* State values for client shared memory region segment */
 typedef enum {
     SHMEM_REGION_EMPTY = 0,        // set by client to indicate drain complete
     SHMEM_REGION_DATA_READY = 1,   // set by server to initiate client drain
     SHMEM_REGION_DATA_COMPLETE = 2 // set by server when done writing data
 } shm_data_state_e;
 
-/* Header for client shared memory region.
- *   sync     - for synchronizing updates/access by server threads
- *   meta_cnt - number of shm_data_meta (i.e., read replies) currently in shmem
- *   bytes    - total bytes of shmem region in use (shm_data_meta + payloads)
- *   state    - region state variable used for client-server coordination */
- typedef struct shm_data_header {
-    pthread_mutex_t sync;
+/* Number of segments the client shared memory data region is divided
+ * into. The server fills one segment while the client drains another,
+ * segments are used in round-robin order. */
+#define SHMEM_DATA_SEGMENTS 2
+
+/* Header for a segment of client shared memory region.
+ *   meta_cnt - number of shm_data_meta (i.e., read replies) in segment
+ *   bytes    - total bytes of segment in use (shm_data_meta + payloads)
+ *   state    - segment state variable used for client-server coordination,
+ *              also used as a futex to block waiting for state changes
+ *   waiters  - number of processes blocked on the state futex */
+typedef struct shm_data_segment {
     volatile size_t meta_cnt;
     volatile size_t bytes;
     volatile shm_data_state_e state;
+    volatile int waiters;
+} shm_data_segment;
+
+/* Header for client shared memory region.
+ *   sync     - for synchronizing updates/access by server threads
+ *   seg_size - size in bytes of each data segment
+ *   prod_seg - index of segment the server is filling
+ *   cons_seg - index of segment the client is draining
+ *   segs     - per-segment state, segment data follows the header */
+typedef struct shm_data_header {
+    pthread_mutex_t sync;
+    size_t seg_size;
+    volatile size_t prod_seg;
+    volatile size_t cons_seg;
+    shm_data_segment segs[SHMEM_DATA_SEGMENTS];
 } shm_data_header;
 
+/* Return pointer to start of data for the given segment */
+static inline
+char* shm_data_segment_buf(shm_data_header* hdr, size_t seg)
+{
+    return ((char*)hdr) + sizeof(shm_data_header) + (seg * hdr->seg_size);
+}
+
 /* Context structure for maintaining state on an active
  * shared memory region */
 typedef struct shm_context {
@@ -99,6 +129,30 @@ int unifyfs_shm_free(shm_context** pctx);
  */
 int unifyfs_shm_unlink(shm_context* ctx);
 
+/**
+ * Set the state of a shared memory data segment, and wake any
+ * process waiting on the segment state.
+ * @param seg segment header
+ * @param state new segment state
+ */
+void unifyfs_shm_segment_signal(shm_data_segment* seg,
+                                shm_data_state_e state);
+
+/**
+ * Wait for the state of a shared memory data segment to change.
+ * Polls the state for a short time, then blocks until signaled.
+ * @param seg segment header
+ * @param state segment state to compare against
+ * @param equal if nonzero wait until state is equal to given state,
+ *              otherwise wait until it is not equal
+ * @param timeout_ms maximum time to wait in milliseconds
+ * @return UNIFYFS_SUCCESS, or UNIFYFS_ERROR_SHMEM on timeout
+ */
+int unifyfs_shm_segment_wait(shm_data_segment* seg,
+                             shm_data_state_e state,
+                             int equal,
+                             long timeout_ms);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
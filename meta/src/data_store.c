@@ -50,6 +50,7 @@
 #ifdef      MYSQLDB_SUPPORT
 #include "ds_mysql.h"
 #endif
+#include "ds_memdb.h"
 
 
 /**
@@ -68,6 +69,8 @@ struct mdhim_store_t *mdhim_db_init(int type) {
 	store->db_handle = NULL;
 	store->db_stats = NULL;
 	store->mdhim_store_stats = NULL;
+	store->batch_next = NULL;
+	store->batch_ranges = NULL;
 	store->mdhim_store_stats_lock = malloc(sizeof(pthread_rwlock_t));
 	if (pthread_rwlock_init(store->mdhim_store_stats_lock, NULL) != 0) {	
 		free(store->mdhim_store_stats_lock);
@@ -87,6 +90,8 @@ struct mdhim_store_t *mdhim_db_init(int type) {
 		store->del = mdhim_leveldb_del;
 		store->commit = mdhim_leveldb_commit;
 		store->close = mdhim_leveldb_close;
+		store->batch_next = mdhim_leveldb_batch_next;
+		store->batch_ranges = leveldb_batch_ranges;
 		break;
 
 #endif
@@ -102,6 +107,8 @@ struct mdhim_store_t *mdhim_db_init(int type) {
 		store->del = mdhim_leveldb_del;
 		store->commit = mdhim_leveldb_commit;
 		store->close = mdhim_leveldb_close;
+		store->batch_next = mdhim_leveldb_batch_next;
+		store->batch_ranges = leveldb_batch_ranges;
 		break;
 #endif
 
@@ -119,6 +126,19 @@ struct mdhim_store_t *mdhim_db_init(int type) {
 		break;
 #endif
 
+	case MEMDB:
+		store->open = mdhim_memdb_open;
+		store->put = mdhim_memdb_put;
+		store->batch_put = mdhim_memdb_batch_put;
+		store->get = mdhim_memdb_get;
+		store->get_next = mdhim_memdb_get_next;
+		store->get_prev = mdhim_memdb_get_prev;
+		store->del = mdhim_memdb_del;
+		store->commit = mdhim_memdb_commit;
+		store->close = mdhim_memdb_close;
+		store->batch_next = mdhim_memdb_batch_next;
+		store->batch_ranges = mdhim_memdb_batch_ranges;
+		break;
 
 	default:
 		free(store);
@@ -44,6 +44,7 @@
 #define LEVELDB 1 //LEVELDB storage method
 #define MYSQLDB 3
 #define ROCKSDB 4 //RocksDB
+#define MEMDB 5 //In-memory store for UnifyFS file extents
 /* mdhim_store_t flags */
 #define MDHIM_CREATE 1 //Implies read/write 
 #define MDHIM_RDONLY 2
@@ -72,6 +73,15 @@ typedef int (*mdhim_store_get_prev_fn_t)(void *db_handle, void **key,
 typedef int (*mdhim_store_del_fn_t)(void *db_handle, void *key, int key_len);
 typedef int (*mdhim_store_commit_fn_t)(void *db_handle);
 typedef int (*mdhim_store_close_fn_t)(void *db_handle, void *db_stats);
+typedef int (*mdhim_store_batch_next_fn_t)(void *db_handle, char **keys,
+					   int *key_lens, char **data,
+					   int32_t *data_lens, int tot_records,
+					   int *num_records);
+typedef int (*mdhim_store_batch_ranges_fn_t)(void *db_handle, char **keys,
+					     int32_t *key_lens,
+					     char ***out_keys, int32_t **out_key_lens,
+					     char ***out_vals, int32_t **out_val_lens,
+					     int num_ranges, int *out_records_cnt);
 
 //Used for storing stats in a hash table
 struct mdhim_stat;
@@ -129,6 +139,8 @@ struct mdhim_store_t {
 	mdhim_store_del_fn_t del;
 	mdhim_store_commit_fn_t commit;
 	mdhim_store_close_fn_t close;
+	mdhim_store_batch_next_fn_t batch_next;
+	mdhim_store_batch_ranges_fn_t batch_ranges;
 	
 	//Login credentials
 	char *db_user;
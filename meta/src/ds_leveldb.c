@@ -482,7 +482,8 @@ int mdhim_leveldb_batch_put(void *dbh, void **keys, int32_t *key_lens,
  * @param data_len     out  pointer to length of the value data 
  * @param mstore_opts  in   additional options for the data store layer 
  * 
- * @return MDHIM_SUCCESS on success or MDHIM_DB_ERROR on failure
+ * @return MDHIM_SUCCESS on success, MDHIM_DB_NOTFOUND if the key is
+ *         missing, or MDHIM_DB_ERROR on failure
  */
 int mdhim_leveldb_get(void *dbh, void *key, int key_len, void **data, int32_t *data_len) {
 /*
@@ -506,7 +507,9 @@ int mdhim_leveldb_get(void *dbh, void *key, int key_len, void **data, int32_t *d
 	}
 
 	if (!ldb_data_len) {
-		ret = MDHIM_DB_ERROR;
+		//Key not found
+		free(ldb_data);
+		ret = MDHIM_DB_NOTFOUND;
 		return ret;
 	}
 
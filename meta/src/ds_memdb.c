@@ -0,0 +1,662 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ds_memdb.h"
+#include "tree.h"
+
+/* a single extent record, ordered by (gfid, offset) */
+struct memdb_node {
+    RB_ENTRY(memdb_node) entry;
+    unifyfs_key_t key;
+    unifyfs_val_t val;
+};
+
+RB_HEAD(memdb_tree, memdb_node);
+
+struct mdhim_memdb_t {
+    struct memdb_tree head;
+    pthread_rwlock_t rwlock;
+    unsigned long count; /* number of records in the tree */
+};
+
+static int memdb_node_compare(struct memdb_node* a, struct memdb_node* b)
+{
+    return unifyfs_key_compare(&a->key, &b->key);
+}
+
+RB_GENERATE_STATIC(memdb_tree, memdb_node, entry, memdb_node_compare)
+
+/* only UnifyFS extent keys and values are stored */
+static int memdb_check_kv(int32_t key_len, int32_t data_len)
+{
+    if ((key_len != (int32_t)UNIFYFS_KEY_SZ) ||
+        (data_len != (int32_t)UNIFYFS_VAL_SZ)) {
+        return MDHIM_DB_ERROR;
+    }
+    return MDHIM_SUCCESS;
+}
+
+/* find the record with the given key, or NULL if there is none */
+static struct memdb_node* memdb_find(struct mdhim_memdb_t* db,
+                                     unifyfs_key_t* key)
+{
+    struct memdb_node tmp;
+    tmp.key = *key;
+    return RB_FIND(memdb_tree, &db->head, &tmp);
+}
+
+/* find the first record with key >= the given key, or NULL */
+static struct memdb_node* memdb_nfind(struct mdhim_memdb_t* db,
+                                      unifyfs_key_t* key)
+{
+    struct memdb_node tmp;
+    tmp.key = *key;
+    return RB_NFIND(memdb_tree, &db->head, &tmp);
+}
+
+/* insert or overwrite a record, caller must hold the write lock */
+static int memdb_insert(struct mdhim_memdb_t* db,
+                        unifyfs_key_t* key, unifyfs_val_t* val)
+{
+    struct memdb_node* node = memdb_find(db, key);
+    if (NULL != node) {
+        node->val = *val;
+        return MDHIM_SUCCESS;
+    }
+
+    node = malloc(sizeof(*node));
+    if (NULL == node) {
+        return MDHIM_DB_ERROR;
+    }
+    node->key = *key;
+    node->val = *val;
+    RB_INSERT(memdb_tree, &db->head, node);
+    db->count++;
+    return MDHIM_SUCCESS;
+}
+
+/* return allocated copies of the key and value of the given record */
+static void memdb_copy_out(struct memdb_node* node,
+                           void** key, int* key_len,
+                           void** data, int32_t* data_len)
+{
+    *key = malloc(UNIFYFS_KEY_SZ);
+    *data = malloc(UNIFYFS_VAL_SZ);
+    if ((NULL == *key) || (NULL == *data)) {
+        free(*key);
+        free(*data);
+        *key = NULL;
+        *data = NULL;
+        *key_len = 0;
+        *data_len = 0;
+        return;
+    }
+    memcpy(*key, &node->key, UNIFYFS_KEY_SZ);
+    memcpy(*data, &node->val, UNIFYFS_VAL_SZ);
+    *key_len = UNIFYFS_KEY_SZ;
+    *data_len = UNIFYFS_VAL_SZ;
+}
+
+/* append a (possibly clipped) copy of an extent to the range output
+ * arrays, growing them as needed */
+static int memdb_add_range_kv(char*** out_keys, int32_t** out_keys_len,
+                              char*** out_vals, int32_t** out_vals_len,
+                              int* cnt, int* cap,
+                              struct memdb_node* node,
+                              size_t start, size_t end)
+{
+    if (*cnt == *cap) {
+        int new_cap = (*cap > 0) ? (*cap * 2) : 8;
+        char** keys = realloc(*out_keys, new_cap * sizeof(char*));
+        char** vals = realloc(*out_vals, new_cap * sizeof(char*));
+        int32_t* klens = realloc(*out_keys_len, new_cap * sizeof(int32_t));
+        int32_t* vlens = realloc(*out_vals_len, new_cap * sizeof(int32_t));
+        if (NULL != keys) {
+            *out_keys = keys;
+        }
+        if (NULL != vals) {
+            *out_vals = vals;
+        }
+        if (NULL != klens) {
+            *out_keys_len = klens;
+        }
+        if (NULL != vlens) {
+            *out_vals_len = vlens;
+        }
+        if ((NULL == keys) || (NULL == vals) ||
+            (NULL == klens) || (NULL == vlens)) {
+            return MDHIM_DB_ERROR;
+        }
+        *cap = new_cap;
+    }
+
+    unifyfs_key_t* key = malloc(UNIFYFS_KEY_SZ);
+    unifyfs_val_t* val = malloc(UNIFYFS_VAL_SZ);
+    if ((NULL == key) || (NULL == val)) {
+        free(key);
+        free(val);
+        return MDHIM_DB_ERROR;
+    }
+
+    /* clip extent to [start, end] */
+    *key = node->key;
+    *val = node->val;
+    key->offset = start;
+    val->addr = node->val.addr + (start - node->key.offset);
+    val->len = end - start + 1;
+
+    (*out_keys)[*cnt] = (char*) key;
+    (*out_keys_len)[*cnt] = UNIFYFS_KEY_SZ;
+    (*out_vals)[*cnt] = (char*) val;
+    (*out_vals_len)[*cnt] = UNIFYFS_VAL_SZ;
+    (*cnt)++;
+    return MDHIM_SUCCESS;
+}
+
+/* add all extents of the file that overlap [start_key, end_key] to the
+ * output arrays. As with the LevelDB store, only the extent immediately
+ * preceding the start offset is considered for a partial overlap, since
+ * extents are split at slice boundaries when they are inserted */
+static int memdb_process_range(struct mdhim_memdb_t* db,
+                               unifyfs_key_t* start_key,
+                               unifyfs_key_t* end_key,
+                               char*** out_keys, int32_t** out_keys_len,
+                               char*** out_vals, int32_t** out_vals_len,
+                               int* cnt, int* cap)
+{
+    int rc;
+    int gfid = start_key->gfid;
+    size_t start_off = start_key->offset;
+    size_t end_off = end_key->offset;
+    struct memdb_node* node;
+
+    if (end_off < start_off) {
+        return MDHIM_SUCCESS;
+    }
+
+    node = memdb_nfind(db, start_key);
+    if ((NULL == node) || (node->key.gfid != gfid) ||
+        (node->key.offset != start_off)) {
+        /* check whether the preceding extent covers the start offset */
+        struct memdb_node* prev;
+        if (NULL == node) {
+            prev = RB_MAX(memdb_tree, &db->head);
+        } else {
+            prev = RB_PREV(memdb_tree, &db->head, node);
+        }
+        if ((NULL != prev) && (prev->key.gfid == gfid)) {
+            size_t prev_end = prev->key.offset + prev->val.len - 1;
+            if (start_off <= prev_end) {
+                size_t tmp_end = (end_off < prev_end) ? end_off : prev_end;
+                rc = memdb_add_range_kv(out_keys, out_keys_len,
+                                        out_vals, out_vals_len,
+                                        cnt, cap, prev, start_off, tmp_end);
+                if ((rc != MDHIM_SUCCESS) || (end_off <= prev_end)) {
+                    return rc;
+                }
+            }
+        }
+    }
+
+    /* add extents that start within the range */
+    while ((NULL != node) && (node->key.gfid == gfid) &&
+           (node->key.offset <= end_off)) {
+        size_t curr_end = node->key.offset + node->val.len - 1;
+        size_t tmp_end = (end_off < curr_end) ? end_off : curr_end;
+        rc = memdb_add_range_kv(out_keys, out_keys_len,
+                                out_vals, out_vals_len,
+                                cnt, cap, node, node->key.offset, tmp_end);
+        if ((rc != MDHIM_SUCCESS) || (end_off <= curr_end)) {
+            return rc;
+        }
+        node = RB_NEXT(memdb_tree, &db->head, node);
+    }
+
+    return MDHIM_SUCCESS;
+}
+
+/**
+ * mdhim_memdb_open
+ * Creates an empty in-memory extent store
+ *
+ * @param dbh         [out] pointer to the store handle
+ * @param dbs         [out] pointer to the stats store handle (always NULL)
+ * @param path        [in]  unused, nothing is persisted
+ * @param flags       [in]  unused
+ * @param key_type    [in]  must be MDHIM_UNIFYFS_KEY
+ * @param opts        [in]  unused
+ * @return MDHIM_SUCCESS on success or MDHIM_DB_ERROR on failure
+ */
+int mdhim_memdb_open(void **dbh, void **dbs, char *path,
+                     int flags, int key_type,
+                     struct mdhim_options_t *opts)
+{
+    struct mdhim_memdb_t* db;
+
+    *dbh = NULL;
+    *dbs = NULL;
+
+    if (key_type != MDHIM_UNIFYFS_KEY) {
+        mlog(MDHIM_SERVER_CRIT, "Memory data store only supports "
+             "UnifyFS extent keys");
+        return MDHIM_DB_ERROR;
+    }
+
+    db = malloc(sizeof(*db));
+    if (NULL == db) {
+        return MDHIM_DB_ERROR;
+    }
+    RB_INIT(&db->head);
+    db->count = 0;
+    if (pthread_rwlock_init(&db->rwlock, NULL) != 0) {
+        free(db);
+        return MDHIM_DB_ERROR;
+    }
+
+    *dbh = db;
+    return MDHIM_SUCCESS;
+}
+
+/**
+ * mdhim_memdb_put
+ * Stores a single extent, replacing any extent with the same key
+ *
+ * @param dbh      in   pointer to the store handle
+ * @param key      in   pointer to the key to store
+ * @param key_len  in   length of the key
+ * @param data     in   pointer to the value to store
+ * @param data_len in   length of the value
+ * @return MDHIM_SUCCESS on success or MDHIM_DB_ERROR on failure
+ */
+int mdhim_memdb_put(void *dbh, void *key, int key_len,
+                    void *data, int32_t data_len)
+{
+    struct mdhim_memdb_t* db = (struct mdhim_memdb_t*) dbh;
+    int rc;
+
+    if (NULL == db) {
+        /* no stats store, nothing to persist */
+        return MDHIM_SUCCESS;
+    }
+
+    rc = memdb_check_kv(key_len, data_len);
+    if (rc != MDHIM_SUCCESS) {
+        return rc;
+    }
+
+    pthread_rwlock_wrlock(&db->rwlock);
+    rc = memdb_insert(db, (unifyfs_key_t*) key, (unifyfs_val_t*) data);
+    pthread_rwlock_unlock(&db->rwlock);
+    return rc;
+}
+
+/**
+ * mdhim_memdb_batch_put
+ * Stores multiple extents under a single lock acquisition
+ *
+ * @param dbh         in   pointer to the store handle
+ * @param keys        in   array of keys to store
+ * @param key_lens    in   array of key lengths
+ * @param data        in   array of values to store
+ * @param data_lens   in   array of value lengths
+ * @param num_records in   number of records to store
+ * @return MDHIM_SUCCESS on success or MDHIM_DB_ERROR on failure
+ */
+int mdhim_memdb_batch_put(void *dbh, void **keys, int32_t *key_lens,
+                          void **data, int32_t *data_lens, int num_records)
+{
+    struct mdhim_memdb_t* db = (struct mdhim_memdb_t*) dbh;
+    int i;
+    int ret = MDHIM_SUCCESS;
+
+    pthread_rwlock_wrlock(&db->rwlock);
+    for (i = 0; i < num_records; i++) {
+        int rc = memdb_check_kv(key_lens[i], data_lens[i]);
+        if (rc == MDHIM_SUCCESS) {
+            rc = memdb_insert(db, (unifyfs_key_t*) keys[i],
+                              (unifyfs_val_t*) data[i]);
+        }
+        if (rc != MDHIM_SUCCESS) {
+            ret = rc;
+        }
+    }
+    pthread_rwlock_unlock(&db->rwlock);
+    return ret;
+}
+
+/**
+ * mdhim_memdb_get
+ * Gets the value of a single key
+ *
+ * @param dbh      in   pointer to the store handle
+ * @param key      in   pointer to the key to look up
+ * @param key_len  in   length of the key
+ * @param data     out  pointer to allocated copy of the value
+ * @param data_len out  length of the value
+ * @return MDHIM_SUCCESS on success, MDHIM_DB_NOTFOUND if the key is
+ *         missing, or MDHIM_DB_ERROR on failure
+ */
+int mdhim_memdb_get(void *dbh, void *key, int key_len,
+                    void **data, int32_t *data_len)
+{
+    struct mdhim_memdb_t* db = (struct mdhim_memdb_t*) dbh;
+    struct memdb_node* node;
+    int ret = MDHIM_DB_ERROR;
+
+    *data = NULL;
+    *data_len = 0;
+    if ((NULL == db) || (key_len != (int)UNIFYFS_KEY_SZ)) {
+        return MDHIM_DB_ERROR;
+    }
+
+    pthread_rwlock_rdlock(&db->rwlock);
+    node = memdb_find(db, (unifyfs_key_t*) key);
+    if (NULL == node) {
+        ret = MDHIM_DB_NOTFOUND;
+    } else {
+        *data = malloc(UNIFYFS_VAL_SZ);
+        if (NULL != *data) {
+            memcpy(*data, &node->val, UNIFYFS_VAL_SZ);
+            *data_len = UNIFYFS_VAL_SZ;
+            ret = MDHIM_SUCCESS;
+        }
+    }
+    pthread_rwlock_unlock(&db->rwlock);
+    return ret;
+}
+
+/**
+ * mdhim_memdb_get_next
+ * Gets the record following the given key, or the first record if
+ * no key is given. On success, *key is replaced by an allocated copy
+ * of the returned record's key.
+ *
+ * @param dbh      in     pointer to the store handle
+ * @param key      in/out pointer to the key to start from
+ * @param key_len  in/out length of the key
+ * @param data     out    pointer to allocated copy of the value
+ * @param data_len out    length of the value
+ * @return MDHIM_SUCCESS on success or MDHIM_DB_ERROR on failure
+ */
+int mdhim_memdb_get_next(void *dbh, void **key, int *key_len,
+                         void **data, int32_t *data_len)
+{
+    struct mdhim_memdb_t* db = (struct mdhim_memdb_t*) dbh;
+    struct memdb_node* node;
+    void* old_key = *key;
+    int old_key_len = *key_len;
+    int ret = MDHIM_DB_ERROR;
+
+    *key = NULL;
+    *key_len = 0;
+    *data = NULL;
+    *data_len = 0;
+    if (NULL == db) {
+        return MDHIM_DB_ERROR;
+    }
+
+    pthread_rwlock_rdlock(&db->rwlock);
+    if ((NULL == old_key) || (old_key_len == 0)) {
+        node = RB_MIN(memdb_tree, &db->head);
+    } else {
+        node = memdb_nfind(db, (unifyfs_key_t*) old_key);
+        if ((NULL != node) &&
+            (unifyfs_key_compare(&node->key,
+                                 (unifyfs_key_t*) old_key) == 0)) {
+            node = RB_NEXT(memdb_tree, &db->head, node);
+        }
+    }
+    if (NULL != node) {
+        memdb_copy_out(node, key, key_len, data, data_len);
+        if (NULL != *data) {
+            ret = MDHIM_SUCCESS;
+        }
+    }
+    pthread_rwlock_unlock(&db->rwlock);
+    return ret;
+}
+
+/**
+ * mdhim_memdb_get_prev
+ * Gets the record preceding the given key, or the last record if
+ * no key is given. On success, *key is replaced by an allocated copy
+ * of the returned record's key.
+ *
+ * @param dbh      in     pointer to the store handle
+ * @param key      in/out pointer to the key to start from
+ * @param key_len  in/out length of the key
+ * @param data     out    pointer to allocated copy of the value
+ * @param data_len out    length of the value
+ * @return MDHIM_SUCCESS on success or MDHIM_DB_ERROR on failure
+ */
+int mdhim_memdb_get_prev(void *dbh, void **key, int *key_len,
+                         void **data, int32_t *data_len)
+{
+    struct mdhim_memdb_t* db = (struct mdhim_memdb_t*) dbh;
+    struct memdb_node* node;
+    void* old_key = *key;
+    int old_key_len = *key_len;
+    int ret = MDHIM_DB_ERROR;
+
+    *key = NULL;
+    *key_len = 0;
+    *data = NULL;
+    *data_len = 0;
+    if (NULL == db) {
+        return MDHIM_DB_ERROR;
+    }
+
+    pthread_rwlock_rdlock(&db->rwlock);
+    if ((NULL == old_key) || (old_key_len == 0)) {
+        node = RB_MAX(memdb_tree, &db->head);
+    } else {
+        node = memdb_nfind(db, (unifyfs_key_t*) old_key);
+        if (NULL == node) {
+            node = RB_MAX(memdb_tree, &db->head);
+        } else {
+            node = RB_PREV(memdb_tree, &db->head, node);
+        }
+    }
+    if (NULL != node) {
+        memdb_copy_out(node, key, key_len, data, data_len);
+        if (NULL != *data) {
+            ret = MDHIM_SUCCESS;
+        }
+    }
+    pthread_rwlock_unlock(&db->rwlock);
+    return ret;
+}
+
+/**
+ * mdhim_memdb_del
+ * Deletes the record with the given key
+ *
+ * @param dbh      in   pointer to the store handle
+ * @param key      in   pointer to the key to delete
+ * @param key_len  in   length of the key
+ * @return MDHIM_SUCCESS on success or MDHIM_DB_ERROR on failure
+ */
+int mdhim_memdb_del(void *dbh, void *key, int key_len)
+{
+    struct mdhim_memdb_t* db = (struct mdhim_memdb_t*) dbh;
+    struct memdb_node* node;
+
+    if ((NULL == db) || (key_len != (int)UNIFYFS_KEY_SZ)) {
+        return MDHIM_DB_ERROR;
+    }
+
+    pthread_rwlock_wrlock(&db->rwlock);
+    node = memdb_find(db, (unifyfs_key_t*) key);
+    if (NULL != node) {
+        RB_REMOVE(memdb_tree, &db->head, node);
+        db->count--;
+        free(node);
+    }
+    pthread_rwlock_unlock(&db->rwlock);
+
+    /* deleting a missing key is not an error, as with LevelDB */
+    return MDHIM_SUCCESS;
+}
+
+/**
+ * mdhim_memdb_commit
+ * Nothing to do, records are visible as soon as they are stored
+ *
+ * @param dbh      in   pointer to the store handle
+ * @return MDHIM_SUCCESS
+ */
+int mdhim_memdb_commit(void *dbh)
+{
+    return MDHIM_SUCCESS;
+}
+
+/**
+ * mdhim_memdb_close
+ * Frees all records and the store handle
+ *
+ * @param dbh      in   pointer to the store handle
+ * @param dbs      in   pointer to the stats store handle (unused)
+ * @return MDHIM_SUCCESS
+ */
+int mdhim_memdb_close(void *dbh, void *dbs)
+{
+    struct mdhim_memdb_t* db = (struct mdhim_memdb_t*) dbh;
+    struct memdb_node* node;
+    struct memdb_node* tmp;
+
+    if (NULL == db) {
+        return MDHIM_SUCCESS;
+    }
+
+    pthread_rwlock_wrlock(&db->rwlock);
+    RB_FOREACH_SAFE(node, memdb_tree, &db->head, tmp) {
+        RB_REMOVE(memdb_tree, &db->head, node);
+        free(node);
+    }
+    db->count = 0;
+    pthread_rwlock_unlock(&db->rwlock);
+    pthread_rwlock_destroy(&db->rwlock);
+    free(db);
+
+    return MDHIM_SUCCESS;
+}
+
+/**
+ * mdhim_memdb_batch_next
+ * Gets up to tot_records records starting at (and including) key[0]
+ *
+ * @param dbh         in   pointer to the store handle
+ * @param key         in/out array of returned keys, key[0] is the start key
+ * @param key_len     in/out array of returned key lengths
+ * @param data        out  array of returned values
+ * @param data_len    out  array of returned value lengths
+ * @param tot_records in   maximum number of records to return
+ * @param num_records out  number of records returned
+ * @return MDHIM_SUCCESS on success or MDHIM_DB_ERROR on failure
+ */
+int mdhim_memdb_batch_next(void *dbh, char **key, int *key_len,
+                           char **data, int32_t *data_len,
+                           int tot_records, int *num_records)
+{
+    struct mdhim_memdb_t* db = (struct mdhim_memdb_t*) dbh;
+    struct memdb_node* node;
+    int cursor = 0;
+
+    if ((NULL == key[0]) || (key_len[0] == 0)) {
+        /* matches the LevelDB store, which returns nothing here */
+        return MDHIM_SUCCESS;
+    }
+
+    pthread_rwlock_rdlock(&db->rwlock);
+    node = memdb_nfind(db, (unifyfs_key_t*) key[0]);
+    while ((NULL != node) && (cursor != tot_records)) {
+        memdb_copy_out(node, (void**) &key[cursor], &key_len[cursor],
+                       (void**) &data[cursor], &data_len[cursor]);
+        if (NULL == data[cursor]) {
+            pthread_rwlock_unlock(&db->rwlock);
+            return MDHIM_DB_ERROR;
+        }
+        (*num_records)++;
+        cursor++;
+        node = RB_NEXT(memdb_tree, &db->head, node);
+    }
+    pthread_rwlock_unlock(&db->rwlock);
+
+    return MDHIM_SUCCESS;
+}
+
+/**
+ * mdhim_memdb_batch_ranges
+ * Gets the extents that overlap each of the given key ranges
+ *
+ * @param dbh             in   pointer to the store handle
+ * @param key             in   array of start/end key pairs
+ * @param key_len         in   array of key lengths
+ * @param out_keys        out  array of returned keys
+ * @param out_keys_len    out  array of returned key lengths
+ * @param out_vals        out  array of returned values
+ * @param out_vals_len    out  array of returned value lengths
+ * @param num_ranges      in   number of start/end key pairs
+ * @param out_records_cnt out  number of returned key-value pairs
+ * @return MDHIM_SUCCESS on success or MDHIM_DB_ERROR on failure
+ */
+int mdhim_memdb_batch_ranges(void *dbh, char **key, int32_t *key_len,
+                             char ***out_keys, int32_t **out_keys_len,
+                             char ***out_vals, int32_t **out_vals_len,
+                             int num_ranges, int *out_records_cnt)
+{
+    struct mdhim_memdb_t* db = (struct mdhim_memdb_t*) dbh;
+    int i;
+    int ret = MDHIM_SUCCESS;
+    int cnt = 0;
+    int cap = (num_ranges > 0) ? num_ranges : 1;
+
+    *out_keys = (char**) calloc(cap, sizeof(char*));
+    *out_keys_len = (int32_t*) calloc(cap, sizeof(int32_t));
+    *out_vals = (char**) calloc(cap, sizeof(char*));
+    *out_vals_len = (int32_t*) calloc(cap, sizeof(int32_t));
+    *out_records_cnt = 0;
+    if ((NULL == *out_keys) || (NULL == *out_keys_len) ||
+        (NULL == *out_vals) || (NULL == *out_vals_len)) {
+        return MDHIM_DB_ERROR;
+    }
+
+    pthread_rwlock_rdlock(&db->rwlock);
+    for (i = 0; i < num_ranges; i++) {
+        int start_ndx = 2 * i;
+        int end_ndx = start_ndx + 1;
+        if ((key_len[start_ndx] != (int32_t)UNIFYFS_KEY_SZ) ||
+            (key_len[end_ndx] != (int32_t)UNIFYFS_KEY_SZ)) {
+            ret = MDHIM_DB_ERROR;
+            break;
+        }
+        int rc = memdb_process_range(db,
+                                     (unifyfs_key_t*) key[start_ndx],
+                                     (unifyfs_key_t*) key[end_ndx],
+                                     out_keys, out_keys_len,
+                                     out_vals, out_vals_len,
+                                     &cnt, &cap);
+        if (rc != MDHIM_SUCCESS) {
+            ret = rc;
+            break;
+        }
+    }
+    pthread_rwlock_unlock(&db->rwlock);
+
+    *out_records_cnt = cnt;
+    return ret;
+}
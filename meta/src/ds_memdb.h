@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+/*
+ * In-memory data store for UnifyFS file extents (MDHIM_UNIFYFS_KEY).
+ *
+ * File extent metadata only needs to live as long as the job, so this
+ * store keeps the extents in a red-black tree ordered by (gfid, offset)
+ * rather than in LevelDB. It provides the same ordering and range query
+ * semantics as the LevelDB store, without iterator creation and without
+ * going through the LevelDB comparator for each key.
+ */
+
+#ifndef __MEMDB_H
+#define __MEMDB_H
+
+#include "mdhim.h"
+#include "partitioner.h"
+#include "data_store.h"
+
+#include "unifyfs_metadata.h"
+
+int mdhim_memdb_open(void **dbh, void **dbs, char *path,
+                     int flags, int key_type,
+                     struct mdhim_options_t *opts);
+int mdhim_memdb_put(void *dbh, void *key, int key_len,
+                    void *data, int32_t data_len);
+int mdhim_memdb_batch_put(void *dbh, void **keys, int32_t *key_lens,
+                          void **data, int32_t *data_lens, int num_records);
+int mdhim_memdb_get(void *dbh, void *key, int key_len,
+                    void **data, int32_t *data_len);
+int mdhim_memdb_get_next(void *dbh, void **key, int *key_len,
+                         void **data, int32_t *data_len);
+int mdhim_memdb_get_prev(void *dbh, void **key, int *key_len,
+                         void **data, int32_t *data_len);
+int mdhim_memdb_del(void *dbh, void *key, int key_len);
+int mdhim_memdb_commit(void *dbh);
+int mdhim_memdb_close(void *dbh, void *dbs);
+int mdhim_memdb_batch_next(void *dbh, char **key, int *key_len,
+                           char **data, int32_t *data_len,
+                           int tot_records, int *num_records);
+int mdhim_memdb_batch_ranges(void *dbh, char **key, int32_t *key_len,
+                             char ***out_keys, int32_t **out_keys_len,
+                             char ***out_vals, int32_t **out_vals_len,
+                             int num_ranges, int *out_records_cnt);
+
+#endif
@@ -93,6 +93,15 @@ struct index_t {
         //Maximum size of a slice. A range server may serve several slices.
 	uint64_t mdhim_max_recs_per_slice; 
 
+	/* If set, MDHIM_UNIFYFS_KEY records are striped across range servers
+	   by (gfid, offset slice) instead of by gfid alone */
+	int unifyfs_stripe_extents;
+
+	/* If set, a put keeps the larger of the stored and the new value
+	   (values are uint64_t). Used for running maximums such as the
+	   UnifyFS file size high-water mark */
+	int value_merge_max;
+
 	//This communicator is for range servers only to talk to each other
 	MPI_Comm rs_comm;   
 	/* The rank of the range server master that will broadcast stat data to all clients
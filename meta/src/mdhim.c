@@ -228,6 +228,9 @@ struct mdhim_t *mdhimInit(void *appComm, struct mdhim_options_t *opts) {
 		     md->mdhim_rank);
 		return NULL;
 	}
+	if (opts->db_key_type == MDHIM_UNIFYFS_KEY) {
+		primary_index->unifyfs_stripe_extents = opts->unifyfs_stripe_extents;
+	}
 	md->primary_index = primary_index;
 	
 	//Set the local receive queue to NULL - used for sending and receiving to/from ourselves
@@ -57,6 +57,7 @@ extern "C"
 #define MDHIM_SUCCESS 0
 #define MDHIM_ERROR -1
 #define MDHIM_DB_ERROR -2
+#define MDHIM_DB_NOTFOUND -3
 
 #define SECONDARY_GLOBAL_INFO 1
 #define SECONDARY_LOCAL_INFO 2
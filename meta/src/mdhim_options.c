@@ -77,6 +77,7 @@ struct mdhim_options_t *mdhim_options_init()
 	opts->db_paths = NULL;
 	opts->num_paths = 0;
 	opts->num_wthreads = 1;
+	opts->unifyfs_stripe_extents = 0;
 
 	set_manifest_path(opts, "./");
 	return opts;
@@ -216,6 +217,11 @@ void mdhim_options_set_num_worker_threads(mdhim_options_t* opts, int num_wthread
 	}
 };
 
+void mdhim_options_set_unifyfs_stripe_extents(mdhim_options_t* opts, int stripe)
+{
+	opts->unifyfs_stripe_extents = stripe;
+};
+
 void mdhim_options_destroy(mdhim_options_t *opts) {
 	int i;
 
@@ -92,6 +92,10 @@ typedef struct mdhim_options_t {
         //Maximum size of a slice. A ranger server may server several slices.
         uint64_t max_recs_per_slice; 
 
+	//Stripe MDHIM_UNIFYFS_KEY records across range servers by offset slice
+	//rather than placing all records of a file on a single range server
+	int unifyfs_stripe_extents;
+
 	//Number of worker threads per range server
 	int num_wthreads;
 
@@ -119,6 +123,7 @@ void mdhim_options_set_value_append(struct mdhim_options_t* opts, int append);
 void mdhim_options_set_server_factor(struct mdhim_options_t* opts, int server_factor);
 void mdhim_options_set_max_recs_per_slice(struct mdhim_options_t* opts, uint64_t max_recs_per_slice);
 void mdhim_options_set_num_worker_threads(struct mdhim_options_t* opts, int num_wthreads);
+void mdhim_options_set_unifyfs_stripe_extents(struct mdhim_options_t* opts, int stripe);
 void set_manifest_path(mdhim_options_t* opts, char *path);
 void mdhim_options_destroy(struct mdhim_options_t *opts);
 #ifdef __cplusplus
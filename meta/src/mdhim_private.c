@@ -353,8 +353,26 @@ struct mdhim_bgetrm_t *_bget_records(struct mdhim_t *md, struct index_t *index,
 	   If there is not a bulk message in the array for the range server the key belongs to, 
 	   then it is created.  Otherwise, the data is added to the existing message in the array.*/
 	for (i = 0; i < num_keys && i < MAX_BULK_OPS; i++) {
+		int striped_range = (op == MDHIM_RANGE_BGET) &&
+			index->unifyfs_stripe_extents && ((i + 1) < num_keys);
+
 		//Get the range server this key will be sent to
-		if ((op == MDHIM_GET_EQ || op == MDHIM_GET_PRIMARY_EQ || op == MDHIM_RANGE_BGET) &&
+		if (striped_range) {
+			/* Range queries come as (start, end) key pairs. With
+			   striped extents a range may cover slices on several
+			   range servers, so send the pair to each of them and
+			   let the responses be merged by the caller */
+			rl = get_range_servers_from_unifyfs_range(md, index,
+								  keys[i],
+								  keys[i + 1]);
+			if (rl == NULL) {
+				mlog(MDHIM_CLIENT_CRIT, "MDHIM Rank: %d - "
+				     "Error while determining range servers in mdhimBget",
+				     md->mdhim_rank);
+				free(bgm_list);
+				return NULL;
+			}
+		} else if ((op == MDHIM_GET_EQ || op == MDHIM_GET_PRIMARY_EQ || op == MDHIM_RANGE_BGET) &&
 		    index->type != LOCAL_INDEX &&
 		    (rl = get_range_servers(md, index, keys[i], key_lens[i])) == NULL) {
 			mlog(MDHIM_CLIENT_CRIT, "MDHIM Rank: %d - "
@@ -409,10 +427,20 @@ struct mdhim_bgetrm_t *_bget_records(struct mdhim_t *md, struct index_t *index,
 			bgm->key_lens[bgm->num_keys] = key_lens[i];
 
 			bgm->num_keys++;	
+			if (striped_range) {
+				//Add the end key of the range as well
+				bgm->keys[bgm->num_keys] = keys[i + 1];
+				bgm->key_lens[bgm->num_keys] = key_lens[i + 1];
+				bgm->num_keys++;
+			}
 			rlp = rl;
 			rl = rl->next;
 			free(rlp);
 		}
+		if (striped_range) {
+			//The end key of the range has already been placed
+			i++;
+		}
 		gettimeofday(&localgetcpyend, NULL);
 		localgetcpytime += 1000000 * (localgetcpyend.tv_sec - \
 			localgetcpystart.tv_sec) + localgetcpyend.tv_usec - \
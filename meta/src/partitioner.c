@@ -285,6 +285,35 @@ int is_float_key(int type) {
 	return ret;
 }
 
+/**
+ * get_unifyfs_stripe_slice
+ *
+ * gets the slice number for a (gfid, offset) pair when file extents
+ * are striped across range servers. The slice is taken modulo the
+ * number of range servers, so it names the server directly and any
+ * num_rangesrvs consecutive offset slices of a file cover every server
+ * @param index     the index the key belongs to
+ * @param gfid      global file id
+ * @param offset    file offset
+ * @return the slice number, in [0, num_rangesrvs)
+ */
+static int get_unifyfs_stripe_slice(struct index_t *index, int gfid,
+				    size_t offset) {
+	uint64_t nsrvs, slice;
+
+	nsrvs = (uint64_t) index->num_rangesrvs;
+	if (nsrvs == 0) {
+		return 0;
+	}
+
+	/* (gfid + offset / range_size) % num_rangesrvs, reduced term by
+	 * term so that the sum cannot wrap */
+	slice = ((uint64_t)(uint32_t) gfid) % nsrvs;
+	slice += ((uint64_t) offset / index->mdhim_max_recs_per_slice) % nsrvs;
+
+	return (int) (slice % nsrvs);
+}
+
 /**
  * get_slice_num
  *
@@ -389,6 +418,16 @@ int get_slice_num(struct mdhim_t *md, struct index_t *index, void *key, int key_
 
 		break;
     case MDHIM_UNIFYFS_KEY:
+        if (index->unifyfs_stripe_extents) {
+            /* The gfid selects the starting slice of the file, and each
+             * offset slice of the file advances to the next slice. Since
+             * consecutive slices are served by consecutive range servers,
+             * the extents of a shared file are spread round-robin across
+             * all range servers */
+            return get_unifyfs_stripe_slice(index, UNIFYFS_KEY_FID(key),
+                                            UNIFYFS_KEY_OFF(key));
+        }
+
         /* Use only the gfid portion of the key, which ensures all extents
          * for the same file hash to the same server */
         key_num = (uint64_t) UNIFYFS_KEY_FID(key);
@@ -463,6 +502,68 @@ rangesrv_list *get_range_servers(struct mdhim_t *md, struct index_t *index,
 	return rl;
 }
 
+/**
+ * get_range_servers_from_unifyfs_range
+ *
+ * gets the list of range servers that hold extents of the given file
+ * range when extents are striped across range servers
+ * @param md         main MDHIM struct
+ * @param index      the index to query
+ * @param start_key  key holding the gfid and start offset of the range
+ * @param end_key    key holding the gfid and end offset of the range
+ * @return the list of range servers or NULL on error
+ */
+rangesrv_list *get_range_servers_from_unifyfs_range(struct mdhim_t *md,
+						    struct index_t *index,
+						    void *start_key,
+						    void *end_key) {
+	rangesrv_info *ret_rp;
+	rangesrv_list *rl;
+	uint64_t start_slice, end_slice, num_slices, i;
+	int gfid;
+
+	gfid = UNIFYFS_KEY_FID(start_key);
+	start_slice = (uint64_t) UNIFYFS_KEY_OFF(start_key) /
+		index->mdhim_max_recs_per_slice;
+	end_slice = (uint64_t) UNIFYFS_KEY_OFF(end_key) /
+		index->mdhim_max_recs_per_slice;
+	if (end_slice < start_slice) {
+		end_slice = start_slice;
+	}
+
+	/* slices map round-robin to range servers, so there is no need to
+	 * visit more slices than there are range servers */
+	num_slices = end_slice - start_slice + 1;
+	if (num_slices > index->num_rangesrvs) {
+		num_slices = index->num_rangesrvs;
+	}
+
+	rl = NULL;
+	for (i = 0; i < num_slices; i++) {
+		size_t off = (size_t) ((start_slice + i) *
+				       index->mdhim_max_recs_per_slice);
+		int slice_num = get_unifyfs_stripe_slice(index, gfid, off);
+
+		ret_rp = get_range_server_by_slice(md, index, slice_num);
+		if (!ret_rp) {
+			mlog(MDHIM_CLIENT_CRIT, "Rank: %d - Did not get a valid"
+			     " range server for slice %d",
+			     md->mdhim_rank, slice_num);
+			while (rl) {
+				rangesrv_list *rlp = rl;
+				rl = rl->next;
+				free(rlp);
+			}
+			return NULL;
+		}
+
+		/* _add_to_rangesrv_list ignores duplicate servers */
+		_add_to_rangesrv_list(&rl, ret_rp);
+	}
+
+	return rl;
+}
+
 struct mdhim_stat *get_next_slice_stat(struct mdhim_t *md, struct index_t *index, 
 				       int slice_num) {
 	struct mdhim_stat *stat, *tmp, *next_slice;
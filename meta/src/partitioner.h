@@ -107,6 +107,10 @@ rangesrv_list *get_range_servers_from_stats(struct mdhim_t *md, struct index_t *
 					    void *key, int key_len, int op);
 rangesrv_list *get_range_servers_from_range(struct mdhim_t *md, struct index_t *index, 
 					    void *start_key, void *end_key, int key_len);
+rangesrv_list *get_range_servers_from_unifyfs_range(struct mdhim_t *md,
+						    struct index_t *index,
+						    void *start_key,
+						    void *end_key);
 
 void* copy_unifyfs_key(void* key, uint32_t key_len);
 
@@ -85,6 +85,53 @@ double starttime=0;
 
 int putflag = 1;
 
+/* serializes the get-then-put of indexes that keep a running maximum,
+   so concurrent workers cannot lower a stored value */
+static pthread_mutex_t merge_max_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * merge_max_value
+ * For indexes that keep a running maximum, replaces the value to be put
+ * with the stored value if the stored value is larger
+ *
+ * @param index     the index the record belongs to
+ * @param key       pointer to the key of the record
+ * @param key_len   length of the key
+ * @param value     pointer to the value to be put (updated in place)
+ * @param value_len length of the value
+ * @return MDHIM_SUCCESS, or the error from reading the stored value, in
+ *         which case the value must not be put
+ */
+static int merge_max_value(struct index_t *index, void *key, int32_t key_len,
+			   void *value, int32_t value_len) {
+	void *old_value = NULL;
+	int32_t old_value_len = 0;
+	int ret;
+
+	if (value_len != sizeof(uint64_t)) {
+		return MDHIM_SUCCESS;
+	}
+
+	ret = index->mdhim_store->get(index->mdhim_store->db_handle,
+				      key, key_len, &old_value,
+				      &old_value_len);
+	if (ret == MDHIM_DB_NOTFOUND) {
+		//No stored value, keep the new one
+		free(old_value);
+		return MDHIM_SUCCESS;
+	} else if (ret != MDHIM_SUCCESS) {
+		free(old_value);
+		return ret;
+	}
+
+	if (old_value && old_value_len == value_len &&
+	    *(uint64_t *)old_value > *(uint64_t *)value) {
+		*(uint64_t *)value = *(uint64_t *)old_value;
+	}
+	free(old_value);
+	return MDHIM_SUCCESS;
+}
+
 int unifyfs_compare(const char* a, const char* b) {
 	int rc;
 	unifyfs_key_t *keya = (unifyfs_key_t *)a;
@@ -376,8 +423,23 @@ int range_server_put(struct mdhim_t *md, struct mdhim_putm_t *im, int source) {
 	}
 	free(value);
 	free(value_len);
+
+	if (index->value_merge_max) {
+		pthread_mutex_lock(&merge_max_lock);
+		ret = merge_max_value(index, im->key, im->key_len,
+				      new_value, new_value_len);
+		if (ret != MDHIM_SUCCESS) {
+			//Do not risk lowering the stored maximum
+			mlog(MDHIM_SERVER_CRIT, "Rank: %d - Error getting "
+			     "stored value to merge", md->mdhim_rank);
+			error = ret;
+		}
+	}
+
         //Put the record in the database
-	if ((ret = 
+	if (error != MDHIM_SUCCESS) {
+		//Skip the put
+	} else if ((ret = 
 	     index->mdhim_store->put(index->mdhim_store->db_handle, 
 				     im->key, im->key_len, new_value, 
 				     new_value_len)) != MDHIM_SUCCESS) {
@@ -388,6 +450,10 @@ int range_server_put(struct mdhim_t *md, struct mdhim_putm_t *im, int source) {
 		inserted = 1;
 	}
 
+	if (index->value_merge_max) {
+		pthread_mutex_unlock(&merge_max_lock);
+	}
+
 	if (!exists && error == MDHIM_SUCCESS) {
 		gettimeofday(&stat_start, NULL);
 		update_stat(md, index, im->key, im->key_len);
@@ -516,8 +582,27 @@ int range_server_bput(struct mdhim_t *md, struct mdhim_bputm_t *bim, int source)
 				- odbgetstart.tv_sec) + odbgetend.tv_usec - odbgetstart.tv_usec;
 	}
 
+	if (index->value_merge_max) {
+		pthread_mutex_lock(&merge_max_lock);
+		for (i = 0; i < bim->num_keys && i < MAX_BULK_OPS; i++) {
+			ret = merge_max_value(index, bim->keys[i],
+					      bim->key_lens[i], new_values[i],
+					      new_value_lens[i]);
+			if (ret != MDHIM_SUCCESS) {
+				//Do not risk lowering a stored maximum
+				mlog(MDHIM_SERVER_CRIT, "Rank: %d - Error "
+				     "getting stored value to merge",
+				     md->mdhim_rank);
+				error = ret;
+				break;
+			}
+		}
+	}
+
 	//Put the record in the database
-	if ((ret = 
+	if (error != MDHIM_SUCCESS) {
+		//Skip the put
+	} else if ((ret = 
 	     index->mdhim_store->batch_put(index->mdhim_store->db_handle, 
 					   bim->keys, bim->key_lens, new_values, 
 					   new_value_lens, bim->num_keys)) != MDHIM_SUCCESS) {
@@ -528,6 +613,10 @@ int range_server_bput(struct mdhim_t *md, struct mdhim_bputm_t *bim, int source)
 		num_put = bim->num_keys;
 	}
 
+	if (index->value_merge_max) {
+		pthread_mutex_unlock(&merge_max_lock);
+	}
+
 	gettimeofday(&stat_start, NULL);
 	for (i = 0; i < bim->num_keys && i < MAX_BULK_OPS; i++) {
 		//Update the stats if this key didn't exist before
@@ -775,7 +864,7 @@ int range_server_bget(struct mdhim_t *md, struct mdhim_bgetm_t *bgm, int source)
 		int32_t *ret_key_lens;
 		int num_ranges = bgm->num_keys / 2;
 		int out_record_cnt = 0;
-		leveldb_batch_ranges(index->mdhim_store->db_handle,
+		index->mdhim_store->batch_ranges(index->mdhim_store->db_handle,
                                     (char **)bgm->keys, bgm->key_lens,
                                     (char ***)&ret_keys, &ret_key_lens,
                                     (char ***)&values, &value_lens,
@@ -1113,7 +1202,7 @@ int range_server_bget_op(struct mdhim_t *md, struct mdhim_bgetm_t *bgm, int sour
 		*get_key_len = bgm->key_lens[0];
 		key_lens[0] = *get_key_len;
 
-		error = mdhim_leveldb_batch_next(index->mdhim_store->db_handle,
+		error = index->mdhim_store->batch_next(index->mdhim_store->db_handle,
                                                  (char **)keys, key_lens,
                                                  (char **)values, value_lens,
                                                  bgm->num_keys * bgm->num_recs,
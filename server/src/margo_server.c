@@ -199,6 +199,10 @@ static void register_client_server_rpcs(margo_instance_id mid)
     MARGO_REGISTER(mid, "unifyfs_mread_rpc",
                    unifyfs_mread_in_t, unifyfs_mread_out_t,
                    unifyfs_mread_rpc);
+
+    MARGO_REGISTER(mid, "unifyfs_log_extents_rpc",
+                   unifyfs_log_extents_in_t, unifyfs_log_extents_out_t,
+                   unifyfs_log_extents_rpc);
 }
 
 /* margo_server_rpc_init
@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include <abt.h>
+
+#include "unifyfs_global.h"
+#include "unifyfs_bulk_pool.h"
+
+/* smallest size class is 64 KiB, largest is 1 GiB */
+#define BULK_POOL_MIN_SHIFT 16
+#define BULK_POOL_MAX_SHIFT 30
+#define BULK_POOL_CLASSES (BULK_POOL_MAX_SHIFT - BULK_POOL_MIN_SHIFT + 1)
+
+/* a ULT waiting for buffers to be returned, freed by whichever of the
+ * waiter and the waker is done with it last */
+typedef struct bulk_pool_waiter {
+    ABT_eventual ev;               /* set once by the waker */
+    int refs;                      /* waiter and waker references */
+    struct bulk_pool_waiter* next; /* next waiting ULT */
+} bulk_pool_waiter_t;
+
+/* the buffers of one use */
+typedef struct {
+    size_t max_bytes;                  /* cap on pooled bytes */
+    size_t used_bytes;                 /* bytes of buffers in use */
+    size_t free_bytes;                 /* bytes of pooled buffers free */
+    bulk_buf_t* free_bufs[BULK_POOL_CLASSES]; /* free buffers by class */
+    bulk_pool_waiter_t* waiters;       /* ULTs waiting for buffers */
+} bulk_subpool_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;               /* signaled when buffers return */
+    margo_instance_id mid;             /* instance used to register */
+    bulk_subpool_t uses[BULK_POOL_NUM_USES];
+} bulk_pool_t;
+
+static bulk_pool_t pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .mid  = MARGO_INSTANCE_NULL,
+};
+
+/* size class for the given size, or -1 if too large to pool */
+static int size_to_class(size_t size)
+{
+    int cls;
+    for (cls = 0; cls < BULK_POOL_CLASSES; cls++) {
+        if (size <= ((size_t)1 << (cls + BULK_POOL_MIN_SHIFT))) {
+            return cls;
+        }
+    }
+    return -1;
+}
+
+static inline size_t class_size(int cls)
+{
+    return (size_t)1 << (cls + BULK_POOL_MIN_SHIFT);
+}
+
+/* allocate and register a buffer of the given size */
+static bulk_buf_t* alloc_bulk_buf(size_t size,
+                                  bulk_pool_use_e use,
+                                  int cls)
+{
+    bulk_buf_t* buf = (bulk_buf_t*) calloc(1, sizeof(bulk_buf_t));
+    if (NULL == buf) {
+        return NULL;
+    }
+    buf->addr = malloc(size);
+    if (NULL == buf->addr) {
+        free(buf);
+        return NULL;
+    }
+    buf->size = size;
+    buf->use = use;
+    buf->size_class = cls;
+
+    hg_size_t bulk_sz = (hg_size_t) size;
+    hg_return_t hret = margo_bulk_create(pool.mid, 1, &(buf->addr),
+                                         &bulk_sz, HG_BULK_READWRITE,
+                                         &(buf->bulk));
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_bulk_create() for %zu bytes failed", size);
+        free(buf->addr);
+        free(buf);
+        return NULL;
+    }
+    return buf;
+}
+
+/* deregister and free a buffer */
+static void free_bulk_buf(bulk_buf_t* buf)
+{
+    margo_bulk_free(buf->bulk);
+    free(buf->addr);
+    free(buf);
+}
+
+/* take one free buffer from the pool to make room for another
+ * class, largest classes first, returns NULL if none are free */
+static bulk_buf_t* evict_free_buf(bulk_subpool_t* sub)
+{
+    int cls;
+    for (cls = BULK_POOL_CLASSES - 1; cls >= 0; cls--) {
+        bulk_buf_t* buf = sub->free_bufs[cls];
+        if (NULL != buf) {
+            sub->free_bufs[cls] = buf->next;
+            sub->free_bytes -= class_size(cls);
+            return buf;
+        }
+    }
+    return NULL;
+}
+
+/* give back bytes of the given use and wake everyone waiting for
+ * buffers, returns the waiting ULTs to wake once the lock is released,
+ * caller must hold the pool lock */
+static bulk_pool_waiter_t* release_bytes(bulk_subpool_t* sub,
+                                         size_t bytes)
+{
+    sub->used_bytes -= bytes;
+    pthread_cond_broadcast(&pool.cond);
+    bulk_pool_waiter_t* waiters = sub->waiters;
+    sub->waiters = NULL;
+    return waiters;
+}
+
+/* drop a reference to a waiter, freeing it with the last one */
+static void waiter_release(bulk_pool_waiter_t* waiter)
+{
+    if (0 == __atomic_sub_fetch(&(waiter->refs), 1, __ATOMIC_ACQ_REL)) {
+        ABT_eventual_free(&(waiter->ev));
+        free(waiter);
+    }
+}
+
+/* wake waiting ULTs taken from the pool by release_bytes() */
+static void wake_waiters(bulk_pool_waiter_t* waiters)
+{
+    while (NULL != waiters) {
+        bulk_pool_waiter_t* next = waiters->next;
+        ABT_eventual_set(waiters->ev, NULL, 0);
+        waiter_release(waiters);
+        waiters = next;
+    }
+}
+
+int bulk_pool_init(margo_instance_id mid,
+                   size_t max_bytes)
+{
+    int use;
+    pthread_mutex_lock(&pool.lock);
+    pool.mid = mid;
+    for (use = 0; use < BULK_POOL_NUM_USES; use++) {
+        pool.uses[use].max_bytes = max_bytes / BULK_POOL_NUM_USES;
+    }
+    pthread_mutex_unlock(&pool.lock);
+    LOGDBG("bulk buffer pool capped at %zu bytes", max_bytes);
+    return (int)UNIFYFS_SUCCESS;
+}
+
+void bulk_pool_fini(void)
+{
+    int cls, use;
+    pthread_mutex_lock(&pool.lock);
+    for (use = 0; use < BULK_POOL_NUM_USES; use++) {
+        bulk_subpool_t* sub = &pool.uses[use];
+        for (cls = 0; cls < BULK_POOL_CLASSES; cls++) {
+            bulk_buf_t* buf = sub->free_bufs[cls];
+            while (NULL != buf) {
+                bulk_buf_t* next = buf->next;
+                free_bulk_buf(buf);
+                buf = next;
+            }
+            sub->free_bufs[cls] = NULL;
+        }
+        sub->free_bytes = 0;
+        if (sub->used_bytes) {
+            LOGDBG("%zu bytes of bulk buffers still in use",
+                   sub->used_bytes);
+        }
+    }
+    pthread_mutex_unlock(&pool.lock);
+}
+
+size_t bulk_pool_capacity(bulk_pool_use_e use)
+{
+    return pool.uses[use].max_bytes;
+}
+
+bulk_buf_t* bulk_pool_get(bulk_pool_use_e use,
+                          size_t size,
+                          int wait)
+{
+    if (MARGO_INSTANCE_NULL == pool.mid) {
+        LOGERR("bulk buffer pool is not initialized");
+        return NULL;
+    }
+    bulk_subpool_t* sub = &pool.uses[use];
+
+    /* a buffer too large for the pool is allocated on its own, and
+     * takes up all of the space of its use */
+    int cls = size_to_class(size);
+    if ((cls >= 0) && (class_size(cls) > sub->max_bytes)) {
+        cls = -1;
+    }
+    size_t csize = (cls >= 0) ? class_size(cls) : size;
+
+    /* callers running as Argobots ULTs (e.g., rpc handlers) must not
+     * block their execution stream while waiting, other threads
+     * (e.g., request manager threads) wait on the condition */
+    ABT_xstream xstream;
+    int in_ult = (ABT_xstream_self(&xstream) == ABT_SUCCESS);
+
+    bulk_buf_t* buf = NULL;
+    bulk_buf_t* evicted = NULL;
+    int reserved = 0;
+    pthread_mutex_lock(&pool.lock);
+    while (1) {
+        if (cls >= 0) {
+            /* reuse a free buffer of our class */
+            buf = sub->free_bufs[cls];
+            if (NULL != buf) {
+                sub->free_bufs[cls] = buf->next;
+                sub->free_bytes -= csize;
+                sub->used_bytes += csize;
+                break;
+            }
+
+            /* allocate a new buffer if it fits under the cap */
+            if ((sub->used_bytes + sub->free_bytes + csize) <=
+                sub->max_bytes) {
+                sub->used_bytes += csize;
+                reserved = 1;
+                break;
+            }
+        } else if (0 == sub->used_bytes) {
+            /* nothing else in use, drop the free buffers and
+             * allocate the large buffer */
+            bulk_buf_t* victim;
+            while (NULL != (victim = evict_free_buf(sub))) {
+                victim->next = evicted;
+                evicted = victim;
+            }
+            sub->used_bytes += csize;
+            reserved = 1;
+            break;
+        }
+
+        /* make room by dropping free buffers of other classes */
+        bulk_buf_t* victim = evict_free_buf(sub);
+        if (NULL != victim) {
+            victim->next = evicted;
+            evicted = victim;
+            continue;
+        }
+
+        /* everything is in use, wait for buffers to come back */
+        if (!wait) {
+            break;
+        }
+        if (in_ult) {
+            /* wait only this ULT, so that others on the same
+             * execution stream keep running and returning buffers */
+            bulk_pool_waiter_t* waiter = (bulk_pool_waiter_t*)
+                malloc(sizeof(bulk_pool_waiter_t));
+            if (NULL == waiter) {
+                LOGERR("failed to allocate bulk buffer waiter");
+                break;
+            }
+            if (ABT_eventual_create(0, &(waiter->ev)) != ABT_SUCCESS) {
+                LOGERR("failed to create bulk buffer wait eventual");
+                free(waiter);
+                break;
+            }
+            waiter->refs = 2;
+            waiter->next = sub->waiters;
+            sub->waiters = waiter;
+            pthread_mutex_unlock(&pool.lock);
+            ABT_eventual_wait(waiter->ev, NULL);
+            waiter_release(waiter);
+            pthread_mutex_lock(&pool.lock);
+        } else {
+            pthread_cond_wait(&pool.cond, &pool.lock);
+        }
+    }
+    pthread_mutex_unlock(&pool.lock);
+
+    /* deregister dropped buffers outside the lock */
+    while (NULL != evicted) {
+        bulk_buf_t* next = evicted->next;
+        free_bulk_buf(evicted);
+        evicted = next;
+    }
+
+    if (reserved) {
+        buf = alloc_bulk_buf(csize, use, cls);
+        if (NULL == buf) {
+            /* give back the reservation */
+            pthread_mutex_lock(&pool.lock);
+            bulk_pool_waiter_t* waiters = release_bytes(sub, csize);
+            pthread_mutex_unlock(&pool.lock);
+            wake_waiters(waiters);
+        }
+    }
+    return buf;
+}
+
+void bulk_pool_put(bulk_buf_t* buf)
+{
+    if (NULL == buf) {
+        return;
+    }
+
+    bulk_subpool_t* sub = &pool.uses[buf->use];
+    bulk_pool_waiter_t* waiters;
+    if (buf->size_class < 0) {
+        size_t size = buf->size;
+        free_bulk_buf(buf);
+        pthread_mutex_lock(&pool.lock);
+        waiters = release_bytes(sub, size);
+        pthread_mutex_unlock(&pool.lock);
+    } else {
+        pthread_mutex_lock(&pool.lock);
+        buf->next = sub->free_bufs[buf->size_class];
+        sub->free_bufs[buf->size_class] = buf;
+        sub->free_bytes += buf->size;
+        waiters = release_bytes(sub, buf->size);
+        pthread_mutex_unlock(&pool.lock);
+    }
+    wake_waiters(waiters);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+/*
+ * Pool of buffers registered for bulk access, used to hold chunk read
+ * responses exchanged between servers.
+ *
+ * Buffers are grouped in power-of-two size classes and are registered
+ * with margo once, when first allocated, then reused by later responses.
+ * The buffers for responses we send and for responses we receive are
+ * capped separately, each at half the pool size, so that servers that
+ * wait for space to receive from each other never hold the space the
+ * other side needs to send. A request that does not fit under the cap
+ * waits for buffers to be returned, which throttles the servers
+ * producing responses when their peers fall behind. A buffer larger
+ * than the cap is only allocated while no other buffer of its kind is
+ * in use.
+ */
+
+#ifndef UNIFYFS_BULK_POOL_H
+#define UNIFYFS_BULK_POOL_H
+
+#include <margo.h>
+
+/* what a buffer is used for, each use has its own cap */
+typedef enum {
+    BULK_POOL_SEND = 0, /* read responses sent to a server */
+    BULK_POOL_RECV,     /* read responses received from a server */
+    BULK_POOL_NUM_USES
+} bulk_pool_use_e;
+
+/* a buffer registered for bulk access */
+typedef struct bulk_buf {
+    void* addr;            /* buffer address */
+    size_t size;           /* buffer capacity in bytes */
+    hg_bulk_t bulk;        /* bulk handle covering the whole buffer */
+    bulk_pool_use_e use;   /* cap the buffer counts against */
+    int size_class;        /* pool size class, -1 if not pooled */
+    struct bulk_buf* next; /* next free buffer of the same class */
+} bulk_buf_t;
+
+/**
+ * Initialize the bulk buffer pool.
+ *
+ * @param mid margo instance used to register buffers
+ * @param max_bytes cap on the total bytes of pooled buffers, split
+ *                  evenly between the uses
+ * @return UNIFYFS_SUCCESS, or error code
+ */
+int bulk_pool_init(margo_instance_id mid,
+                   size_t max_bytes);
+
+/**
+ * Release the free buffers of the pool. Buffers still in use are
+ * freed when they are returned.
+ */
+void bulk_pool_fini(void);
+
+/**
+ * Get the cap on the bytes of buffers for the given use.
+ *
+ * @param use buffer use
+ * @return cap in bytes
+ */
+size_t bulk_pool_capacity(bulk_pool_use_e use);
+
+/**
+ * Get a registered buffer of at least the given size. The contents of
+ * the buffer are not initialized.
+ *
+ * When the buffers of the given use are at their cap, a caller that
+ * asks to wait blocks until buffers are returned, however long that
+ * takes. A caller running as an Argobots ULT waits on an eventual,
+ * which lets other ULTs run, rather than blocking its execution
+ * stream. A caller that does not wait gets NULL instead, and should
+ * try again once it has returned buffers it holds.
+ *
+ * @param use buffer use
+ * @param size number of bytes needed
+ * @param wait wait for pool space if non-zero
+ * @return buffer, or NULL on failure or if there is no space
+ */
+bulk_buf_t* bulk_pool_get(bulk_pool_use_e use,
+                          size_t size,
+                          int wait);
+
+/**
+ * Return a buffer obtained from bulk_pool_get().
+ *
+ * @param buf buffer to return (NULL is ignored)
+ */
+void bulk_pool_put(bulk_buf_t* buf);
+
+#endif /* UNIFYFS_BULK_POOL_H */
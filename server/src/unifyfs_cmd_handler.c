@@ -121,6 +121,37 @@ static void unifyfs_mount_rpc(hg_handle_t handle)
 }
 DEFINE_MARGO_RPC_HANDLER(unifyfs_mount_rpc)
 
+/* return the process id of the caller of a client rpc, taken from
+ * its shared memory transport address (e.g., "na+sm://7170/0"),
+ * returns 0 if the caller does not use the shared memory transport */
+static pid_t rpc_caller_pid(hg_handle_t handle)
+{
+    const struct hg_info* hgi = margo_get_info(handle);
+    if (NULL == hgi) {
+        return 0;
+    }
+    margo_instance_id mid = margo_hg_info_get_instance(hgi);
+
+    char addr_str[128];
+    hg_size_t addr_sz = sizeof(addr_str);
+    hg_return_t hret = margo_addr_to_string(mid, addr_str, &addr_sz,
+                                            hgi->addr);
+    if (hret != HG_SUCCESS) {
+        return 0;
+    }
+
+    const char* sm_prefix = "na+sm://";
+    if (0 != strncmp(addr_str, sm_prefix, strlen(sm_prefix))) {
+        return 0;
+    }
+    char* end = NULL;
+    long pid = strtol(addr_str + strlen(sm_prefix), &end, 10);
+    if ((pid <= 0) || ((*end != '/') && (*end != '-'))) {
+        return 0;
+    }
+    return (pid_t) pid;
+}
+
 /* server attaches to client shared memory regions, opens files
  * holding spillover data */
 static void unifyfs_attach_rpc(hg_handle_t handle)
@@ -136,6 +167,18 @@ static void unifyfs_attach_rpc(hg_handle_t handle)
     int app_id = in.app_id;
     int client_id = in.client_id;
 
+    /* only trust the client pid if it matches the process on the
+     * other end of the connection, otherwise direct reads are
+     * disabled for this client */
+    pid_t client_pid = (pid_t) in.client_pid;
+    pid_t caller_pid = rpc_caller_pid(handle);
+    if (client_pid != caller_pid) {
+        LOGWARN("client pid %d does not match caller pid %d, "
+                "disabling direct reads (app_id=%d, client_id=%d)",
+                (int)client_pid, (int)caller_pid, app_id, client_id);
+        client_pid = 0;
+    }
+
     /* lookup client structure and attach it */
     app_client* client = get_app_client(app_id, client_id);
     if (NULL != client) {
@@ -148,7 +191,8 @@ static void unifyfs_attach_rpc(hg_handle_t handle)
                                 in.shmem_data_size,
                                 in.shmem_super_size,
                                 in.meta_offset,
-                                in.meta_size);
+                                in.meta_size,
+                                client_pid);
         if (ret != UNIFYFS_SUCCESS) {
             LOGERR("attach_app_client() failed");
         }
@@ -287,9 +331,10 @@ static void unifyfs_metaset_rpc(hg_handle_t handle)
 }
 DEFINE_MARGO_RPC_HANDLER(unifyfs_metaset_rpc)
 
-/* given app_id and client_id as input, read all extents from client
- * write index in shared memory and insert corresponding key/value pairs
- * into the global metadata */
+/* given app_id and client_id as input, read extents from client
+ * write index in shared memory (only those of the given gfid, unless
+ * it is -1) and insert corresponding key/value pairs into the global
+ * metadata */
 static void unifyfs_sync_rpc(hg_handle_t handle)
 {
     /* get input params */
@@ -299,7 +344,7 @@ static void unifyfs_sync_rpc(hg_handle_t handle)
 
     /* given global file id, read index metadata from client and
      * insert into global index key/value store */
-    int ret = rm_cmd_sync(in.app_id, in.client_id);
+    int ret = rm_cmd_sync(in.app_id, in.client_id, in.gfid, in.index_buf);
 
     /* build our output values */
     unifyfs_metaset_out_t out;
@@ -439,7 +484,7 @@ static void unifyfs_read_rpc(hg_handle_t handle)
     /* read data for a single read request from client,
      * returns data to client through shared memory */
     int ret = rm_cmd_read(in.app_id, in.client_id,
-                          in.gfid, in.offset, in.length);
+                          in.gfid, in.offset, in.length, in.buf);
 
     /* build our output values */
     unifyfs_read_out_t out;
@@ -508,3 +553,112 @@ static void unifyfs_mread_rpc(hg_handle_t handle)
     margo_destroy(handle);
 }
 DEFINE_MARGO_RPC_HANDLER(unifyfs_mread_rpc)
+
+/* given an app_id, client_id, global file id, an offset, and a length,
+ * return the locations of data in the range that is held in the logs
+ * of clients attached to this server, so that the client can read
+ * that data directly */
+static void unifyfs_log_extents_rpc(hg_handle_t handle)
+{
+    int ret = (int)UNIFYFS_SUCCESS;
+    int num_extents = 0;
+    int num_ranges_done = 0;
+    unifyfs_log_range_t* ranges = NULL;
+    unifyfs_log_extent_t* extents = NULL;
+
+    /* get input params */
+    unifyfs_log_extents_in_t in;
+    hg_return_t hret = margo_get_input(handle, &in);
+    int have_input = (hret == HG_SUCCESS);
+    if (!have_input) {
+        LOGERR("margo_get_input() failed");
+        ret = (int)UNIFYFS_ERROR_MARGO;
+    } else if ((in.num_ranges > 0) && (in.max_extents > 0)) {
+        const struct hg_info* hgi = margo_get_info(handle);
+        margo_instance_id mid = margo_hg_info_get_instance(hgi);
+
+        /* allocate buffers to hold ranges and extent locations */
+        ranges = (unifyfs_log_range_t*)
+            calloc((size_t)in.num_ranges, sizeof(unifyfs_log_range_t));
+        extents = (unifyfs_log_extent_t*)
+            calloc((size_t)in.max_extents, sizeof(unifyfs_log_extent_t));
+        if ((NULL == ranges) || (NULL == extents)) {
+            ret = ENOMEM;
+        }
+
+        /* pull list of ranges from client */
+        if (ret == UNIFYFS_SUCCESS) {
+            void* buf = (void*) ranges;
+            hg_size_t size = in.num_ranges * sizeof(unifyfs_log_range_t);
+            hg_bulk_t bulk_handle;
+            hret = margo_bulk_create(mid, 1, &buf, &size,
+                                     HG_BULK_WRITE_ONLY, &bulk_handle);
+            if (hret != HG_SUCCESS) {
+                ret = (int)UNIFYFS_ERROR_MARGO;
+            } else {
+                hret = margo_bulk_transfer(mid, HG_BULK_PULL, hgi->addr,
+                                           in.range_bulk, 0,
+                                           bulk_handle, 0, size);
+                if (hret != HG_SUCCESS) {
+                    LOGERR("failed to pull ranges from client");
+                    ret = (int)UNIFYFS_ERROR_MARGO;
+                }
+                margo_bulk_free(bulk_handle);
+            }
+        }
+
+        /* look up extent locations */
+        if (ret == UNIFYFS_SUCCESS) {
+            ret = rm_cmd_log_extents(in.app_id, in.client_id,
+                                     in.num_ranges, ranges,
+                                     in.max_extents, extents,
+                                     &num_extents, &num_ranges_done);
+        }
+
+        /* push extent locations to client buffer */
+        if ((ret == UNIFYFS_SUCCESS) && (num_extents > 0)) {
+            void* buf = (void*) extents;
+            hg_size_t size = num_extents * sizeof(unifyfs_log_extent_t);
+            hg_bulk_t bulk_handle;
+            hret = margo_bulk_create(mid, 1, &buf, &size,
+                                     HG_BULK_READ_ONLY, &bulk_handle);
+            if (hret != HG_SUCCESS) {
+                ret = (int)UNIFYFS_ERROR_MARGO;
+            } else {
+                hret = margo_bulk_transfer(mid, HG_BULK_PUSH, hgi->addr,
+                                           in.extent_bulk, 0,
+                                           bulk_handle, 0, size);
+                if (hret != HG_SUCCESS) {
+                    LOGERR("failed to push extent locations to client");
+                    ret = (int)UNIFYFS_ERROR_MARGO;
+                }
+                margo_bulk_free(bulk_handle);
+            }
+        }
+    }
+
+    /* build our output values */
+    unifyfs_log_extents_out_t out;
+    out.ret = ret;
+    out.num_extents = 0;
+    out.num_ranges_done = 0;
+    if (ret == UNIFYFS_SUCCESS) {
+        out.num_extents = num_extents;
+        out.num_ranges_done = num_ranges_done;
+    }
+
+    /* return to caller */
+    hret = margo_respond(handle, &out);
+    if (hret != HG_SUCCESS) {
+        LOGERR("margo_respond() failed");
+    }
+
+    /* free margo resources */
+    if (have_input) {
+        margo_free_input(handle, &in);
+    }
+    free(ranges);
+    free(extents);
+    margo_destroy(handle);
+}
+DEFINE_MARGO_RPC_HANDLER(unifyfs_log_extents_rpc)
@@ -109,7 +109,29 @@ typedef struct {
     ssize_t read_rc;  /* bytes read (or negative error code) */
 } chunk_read_resp_t;
 
-typedef struct {
+/* count of the sets of chunk read responses that an rpc handler posted
+ * to the request manager and that it has not released yet, which the
+ * handler waits on before pulling more */
+typedef struct chunk_read_window_count {
+    pthread_mutex_t lock;
+    int posted;            /* sets posted and not yet released */
+    int refs;              /* handler, posted sets, and wakers */
+    int waiting;           /* handler is waiting for a release */
+    ABT_eventual released; /* set on a release while handler waits */
+} chunk_read_window_count_t;
+
+/* a set of chunk read responses received from a remote server, the
+ * buffer holds the response headers followed by the response data */
+typedef struct chunk_read_window {
+    int num_chunks;                 /* number of responses in the set */
+    struct bulk_buf* buf;           /* bulk pool buffer holding the set */
+    chunk_read_window_count_t* count; /* count of sets not yet released,
+                                       * shared with the rpc handler
+                                       * that posted them, or NULL */
+    struct chunk_read_window* next; /* next set received */
+} chunk_read_window_t;
+
+typedef struct remote_chunk_reads {
     int rank;                /* remote delegator rank */
     int rdreq_id;            /* read-request id */
     int app_id;              /* app id of requesting client process */
@@ -119,13 +141,18 @@ typedef struct {
     size_t total_sz;         /* total size of data requested */
     chunk_read_req_t* reqs;  /* @RM: subarray of server_read_req_t.chunks
                               * @SM: received requests buffer */
-    chunk_read_resp_t* resp; /* @RM: received responses buffer
-                              * @SM: allocated responses buffer */
+    chunk_read_resp_t* resp; /* @SM: allocated responses buffer */
+    struct bulk_buf* resp_buf; /* @SM: bulk pool buffer holding resp */
+    chunk_read_window_t* resp_windows; /* @RM: received response sets
+                                        * not yet handled, in order */
+    int resp_posted;         /* @RM: number of responses received */
+    struct remote_chunk_reads* next; /* @SM: next in response queue */
 } remote_chunk_reads_t;
 
 typedef struct {
     size_t length;  /* length of data to read */
     size_t offset;  /* file offset */
+    size_t buf;     /* client read buffer address (zero if not given) */
     int gfid;       /* global file id */
     int errcode;    /* request completion status */
 } client_read_req_t;
@@ -142,12 +169,14 @@ typedef struct app_client {
     int client_id;           /* this client's index in app's clients array */
     int dbg_rank;            /* client debug rank - NOT CURRENTLY USED */
     int connected;           /* is client currently connected? */
+    pid_t pid;               /* client process id (for direct reads) */
 
     hg_addr_t margo_addr;    /* client Margo address */
 
-    struct reqmgr_thrd* reqmgr; /* this client's request manager thread */
+    struct reqmgr_thrd* reqmgr; /* this client's request manager state */
 
     logio_context* logio;    /* logio context for write data */
+    uint32_t attach_id;      /* changes each time the client attaches */
 
     shm_context* shmem_data;  /* shmem context for read data */
 
@@ -192,7 +221,8 @@ unifyfs_rc attach_app_client(app_client* client,
                              const size_t shmem_data_size,
                              const size_t shmem_super_size,
                              const size_t super_meta_offset,
-                             const size_t super_meta_size);
+                             const size_t super_meta_size,
+                             const pid_t client_pid);
 
 unifyfs_rc disconnect_app_client(app_client* clnt);
 
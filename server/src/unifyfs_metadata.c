@@ -46,12 +46,14 @@
 
 struct mdhim_t* md;
 
-/* we use two MDHIM indexes:
+/* we use three MDHIM indexes:
  *   0) for file extents
- *   1) for file attributes */
+ *   1) for file attributes
+ *   2) for file size high-water marks */
 #define IDX_FILE_EXTENTS (0)
 #define IDX_FILE_ATTR    (1)
-struct index_t* unifyfs_indexes[2];
+#define IDX_FILE_SIZE    (2)
+struct index_t* unifyfs_indexes[3];
 
 size_t meta_slice_sz;
 
@@ -92,10 +94,11 @@ int unifyfs_key_compare(unifyfs_key_t* a, unifyfs_key_t* b)
 /* initialize the key-value store */
 int meta_init_store(unifyfs_cfg_t* cfg)
 {
-    int rc, ratio;
+    int rc, ratio, db_type;
     MPI_Comm comm = MPI_COMM_WORLD;
     size_t path_len;
     long svr_ratio, range_sz;
+    bool stripe;
     struct stat ss;
     char db_path[UNIFYFS_MAX_FILENAME] = {0};
 
@@ -107,7 +110,20 @@ int meta_init_store(unifyfs_cfg_t* cfg)
     if (db_opts == NULL) {
         return -1;
     }
-    mdhim_options_set_db_type(db_opts, LEVELDB);
+    /* UNIFYFS_META_EXTENT_STORE: data store used for file extents.
+     * Extent metadata does not outlive the job, so it may be kept in
+     * memory rather than in LevelDB */
+    db_type = LEVELDB;
+    if (cfg->meta_extent_store != NULL) {
+        if (strcmp(cfg->meta_extent_store, "memory") == 0) {
+            db_type = MEMDB;
+        } else if (strcmp(cfg->meta_extent_store, "leveldb") != 0) {
+            LOGERR("invalid metadata extent store '%s'",
+                   cfg->meta_extent_store);
+            return -1;
+        }
+    }
+    mdhim_options_set_db_type(db_opts, db_type);
     mdhim_options_set_db_name(db_opts, cfg->meta_db_name);
     mdhim_options_set_key_type(db_opts, MDHIM_UNIFYFS_KEY);
     mdhim_options_set_debug_level(db_opts, MLOG_CRIT);
@@ -144,6 +160,17 @@ int meta_init_store(unifyfs_cfg_t* cfg)
     meta_slice_sz = (size_t) range_sz;
     mdhim_options_set_max_recs_per_slice(db_opts, (uint64_t)range_sz);
 
+    /* by default, all extents of a file are stored on the metadata server
+     * selected by the gfid. When UNIFYFS_META_STRIPE_EXTENTS is enabled,
+     * each range of a file is placed on a different server, which spreads
+     * the metadata load for files shared by many clients */
+    stripe = false;
+    rc = configurator_bool_val(cfg->meta_stripe_extents, &stripe);
+    if (rc != 0) {
+        return -1;
+    }
+    mdhim_options_set_unifyfs_stripe_extents(db_opts, (int)stripe);
+
     md = mdhimInit(&comm, db_opts);
 
     /* index for storing file extent metadata */
@@ -153,6 +180,16 @@ int meta_init_store(unifyfs_cfg_t* cfg)
     unifyfs_indexes[IDX_FILE_ATTR] = create_global_index(md,
         ratio, 1, LEVELDB, MDHIM_INT_KEY, "file_attr");
 
+    /* index for storing the largest synced extent end offset of each
+     * file, puts keep the maximum of the stored and new values */
+    unifyfs_indexes[IDX_FILE_SIZE] = create_global_index(md,
+        ratio, 1, LEVELDB, MDHIM_INT_KEY, "file_size");
+    if (unifyfs_indexes[IDX_FILE_SIZE] == NULL) {
+        LOGERR("failed to create file size index");
+        return -1;
+    }
+    unifyfs_indexes[IDX_FILE_SIZE]->value_merge_max = 1;
+
     return 0;
 }
 
@@ -349,6 +386,156 @@ int unifyfs_get_file_attribute(
     return rc;
 }
 
+/* given a global file id, lookup and return the largest end offset
+ * of all extents synced for the file, returns ENOENT if no extents
+ * have been synced */
+int unifyfs_get_file_size_hwm(
+    int gfid,
+    size_t* hwm)
+{
+    int rc = UNIFYFS_SUCCESS;
+
+    *hwm = 0;
+
+    /* select index holding file size high-water marks,
+     * execute lookup for given file id */
+    md->primary_index = unifyfs_indexes[IDX_FILE_SIZE];
+    struct mdhim_bgetrm_t* bgrm = mdhimGet(md, md->primary_index,
+        &gfid, sizeof(int), MDHIM_GET_EQ);
+
+    if (!bgrm) {
+        rc = (int)UNIFYFS_ERROR_MDHIM;
+    } else if (bgrm->error == MDHIM_DB_NOTFOUND) {
+        /* nothing synced for this file yet */
+        rc = ENOENT;
+    } else if (bgrm->error || (bgrm->num_keys < 1) ||
+               (NULL == bgrm->values[0])) {
+        LOGERR("MDHIM get error=%d for gfid=%d", bgrm->error, gfid);
+        rc = (int)UNIFYFS_ERROR_MDHIM;
+    } else {
+        uint64_t* ptr = (uint64_t*)bgrm->values[0];
+        *hwm = (size_t) *ptr;
+    }
+
+    /* free resources returned from lookup */
+    if (bgrm) {
+        mdhim_full_release_msg(bgrm);
+    }
+
+    return rc;
+}
+
+/* given a list of global file ids and the end offsets of newly synced
+ * extents, raise the stored high-water mark of each file. The metadata
+ * server keeps the larger of the stored and new values, so concurrent
+ * updates from different servers never lower the mark */
+int unifyfs_update_file_size_hwm(
+    int num_entries,
+    int* gfids,
+    size_t* hwms)
+{
+    int i;
+    int rc = UNIFYFS_SUCCESS;
+
+    if (num_entries == 0) {
+        return UNIFYFS_SUCCESS;
+    }
+
+    int** keys      = calloc(num_entries, sizeof(int*));
+    uint64_t* vals  = calloc(num_entries, sizeof(uint64_t));
+    void** val_ptrs = calloc(num_entries, sizeof(void*));
+    int* key_lens   = calloc(num_entries, sizeof(int));
+    int* val_lens   = calloc(num_entries, sizeof(int));
+    if ((NULL == keys) || (NULL == vals) || (NULL == val_ptrs) ||
+        (NULL == key_lens) || (NULL == val_lens)) {
+        LOGERR("failed to allocate memory for file size updates");
+        rc = ENOMEM;
+        goto update_hwm_exit;
+    }
+
+    for (i = 0; i < num_entries; i++) {
+        keys[i]     = &gfids[i];
+        vals[i]     = (uint64_t) hwms[i];
+        val_ptrs[i] = &vals[i];
+        key_lens[i] = sizeof(int);
+        val_lens[i] = sizeof(uint64_t);
+    }
+
+    /* select index for file size high-water marks */
+    md->primary_index = unifyfs_indexes[IDX_FILE_SIZE];
+
+    /* put list of key/value pairs */
+    struct mdhim_brm_t* brm = mdhimBPut(md,
+        (void**)keys, key_lens,
+        val_ptrs, val_lens,
+        num_entries, NULL, NULL);
+
+    /* check for errors and free resources */
+    if (!brm) {
+        rc = (int)UNIFYFS_ERROR_MDHIM;
+    } else {
+        /* step through linked list of messages,
+         * scan for any error and free messages */
+        struct mdhim_brm_t* brmp = brm;
+        while (brmp) {
+            /* check current item for error */
+            if (brmp->error) {
+                LOGERR("MDHIM bulk put error=%d", brmp->error);
+                rc = (int)UNIFYFS_ERROR_MDHIM;
+            }
+
+            /* record pointer to current item,
+             * advance loop pointer to next item in list,
+             * free resources for current item */
+            brm  = brmp;
+            brmp = brmp->next;
+            mdhim_full_release_msg(brm);
+        }
+    }
+
+update_hwm_exit:
+    free(keys);
+    free(vals);
+    free(val_ptrs);
+    free(key_lens);
+    free(val_lens);
+
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("failed to update file size high-water marks");
+    }
+    return rc;
+}
+
+/* given a global file id, delete its file size high-water mark */
+int unifyfs_delete_file_size_hwm(
+    int gfid)
+{
+    int rc = UNIFYFS_SUCCESS;
+
+    /* select index holding file size high-water marks,
+     * delete entry for given file id */
+    md->primary_index = unifyfs_indexes[IDX_FILE_SIZE];
+    struct mdhim_brm_t* brm = mdhimDelete(md, md->primary_index,
+        &gfid, sizeof(int));
+
+    /* deleting a missing entry is not an error */
+    if (!brm) {
+        rc = (int)UNIFYFS_ERROR_MDHIM;
+    } else {
+        struct mdhim_brm_t* brmp = brm;
+        while (brmp) {
+            brm  = brmp;
+            brmp = brmp->next;
+            mdhim_full_release_msg(brm);
+        }
+    }
+
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("failed to delete file size for gfid=%d", gfid);
+    }
+    return rc;
+}
+
 /* given a global file id, delete file attributes */
 int unifyfs_delete_file_attribute(
     int gfid)
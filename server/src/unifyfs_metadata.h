@@ -108,6 +108,35 @@ int unifyfs_get_file_attribute(int gfid,
  */
 int unifyfs_delete_file_attribute(int gfid);
 
+/**
+ * Retrieve the file size high-water mark (largest end offset of all
+ * synced extents) of a file from the KV-Store.
+ *
+ * @param[in] gfid
+ * @param[out] *hwm
+ * @return UNIFYFS_SUCCESS on success, ENOENT if nothing has been synced
+ */
+int unifyfs_get_file_size_hwm(int gfid, size_t* hwm);
+
+/**
+ * Raise the file size high-water marks of a list of files. A stored
+ * high-water mark is never lowered by this call.
+ *
+ * @param[in] num_entries number of files
+ * @param[in] gfids array of global file ids
+ * @param[in] hwms array of end offsets of newly synced extents
+ * @return UNIFYFS_SUCCESS on success
+ */
+int unifyfs_update_file_size_hwm(int num_entries, int* gfids, size_t* hwms);
+
+/**
+ * Delete the file size high-water mark of a file from the KV-Store.
+ *
+ * @param[in] gfid
+ * @return UNIFYFS_SUCCESS on success
+ */
+int unifyfs_delete_file_size_hwm(int gfid);
+
 /**
  * Store a File attribute to the KV-Store.
  *
@@ -27,12 +27,17 @@
  * Please read https://github.com/llnl/burstfs/LICENSE for full license text.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 // system headers
 #include <assert.h>
 #include <poll.h>
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
+#include <sys/uio.h>
 
 // general support
 #include "unifyfs_global.h"
@@ -62,10 +67,11 @@ do { \
 } while (0)
 
 
-/* One request manager thread is created for each client that a
- * delegator serves.  The main thread of the delegator assigns
- * work to the request manager thread to retrieve data and send
- * it back to the client.
+/* Request manager state is created for each client that a
+ * delegator serves, and a fixed-size pool of request manager
+ * worker threads is shared by all clients.  The rpc handlers on
+ * the delegator assign work to a client's request manager state
+ * to retrieve data and send it back to the client.
  *
  * To start, given a read request from the client (via rpc)
  * the handler function on the main delegator first queries the
@@ -78,86 +84,316 @@ do { \
  * generates read requests, and inserts those into a list on a
  * data structure shared with the request manager (del_req_set).
  *
- * The request manager thread coordinates with the main thread
- * using a lock and a condition variable to protect the shared data
- * structure and impose flow control.  When assigned work, the
- * request manager thread packs and sends request messages to
- * service manager threads on remote delegators via MPI send.
- * It waits for data to be sent back, and unpacks the read replies
- * in each message into a shared memory buffer for the client.
- * When the shared memory is full or all data has been received,
- * it signals the client process to process the read replies.
- * It iterates with the client until all incoming read replies
- * have been transferred. */
-/* create a request manager thread for the given app_id
- * and client_id, returns pointer to thread control structure
- * on success and NULL on failure */
-
-/* Create Request Manager thread for application client */
+ * The handler then schedules the client on the worker pool.  Each
+ * worker has its own queue of clients with pending work, and an
+ * idle worker steals clients from the queues of other workers.  A
+ * client is queued at most once and is processed by at most one
+ * worker at a time, so the requests of a client are handled in
+ * the order they were issued.  When processing a client, a worker
+ * packs and sends request messages to service managers on remote
+ * delegators, and unpacks any read replies that have arrived into
+ * a shared memory buffer for the client.  When the shared memory
+ * is full or all data has been received, it signals the client
+ * process to process the read replies.  It iterates with the client
+ * until all incoming read replies have been transferred. */
+
+/* queue of clients with pending work, one per worker */
+typedef struct {
+    pthread_mutex_t lock;
+    reqmgr_thrd_t* clients[MAX_NUM_APPS * MAX_APP_CLIENTS];
+    int head;  /* index of oldest queued client */
+    int count; /* number of queued clients */
+} rm_worker_queue_t;
+
+/* state for pool of request manager worker threads */
+typedef struct {
+    int num_workers;
+    pthread_t* workers;
+    rm_worker_queue_t* queues;
+
+    /* lock and condition variable used by idle workers
+     * to wait for clients to be queued */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int num_queued;   /* total clients queued across workers */
+    int next_worker;  /* home worker for next client created */
+    int time_to_exit;
+    long client_timeout_ms; /* max wait for a client to drain shmem */
+} rm_pool_t;
+
+static rm_pool_t* rm_pool; // = NULL
+
+/* worker thread argument, index of worker within pool */
+typedef struct {
+    int id;
+} rm_worker_arg_t;
+
+static rm_worker_arg_t* rm_worker_args; // = NULL
+
+/* request manager worker thread main */
+static void* rm_delegate_request_thread(void* arg);
+
+/* add client to the tail of the given worker queue */
+static void rm_queue_push(rm_worker_queue_t* q, reqmgr_thrd_t* thrd_ctrl)
+{
+    int cap = MAX_NUM_APPS * MAX_APP_CLIENTS;
+    pthread_mutex_lock(&(q->lock));
+    assert(q->count < cap);
+    q->clients[(q->head + q->count) % cap] = thrd_ctrl;
+    q->count++;
+    pthread_mutex_unlock(&(q->lock));
+}
+
+/* remove client from the head (own = 1) or tail (own = 0) of the
+ * given worker queue, workers take the oldest client from their own
+ * queue and steal the newest client from other queues,
+ * returns NULL if queue is empty */
+static reqmgr_thrd_t* rm_queue_pop(rm_worker_queue_t* q, int own)
+{
+    int cap = MAX_NUM_APPS * MAX_APP_CLIENTS;
+    reqmgr_thrd_t* thrd_ctrl = NULL;
+    pthread_mutex_lock(&(q->lock));
+    if (q->count > 0) {
+        if (own) {
+            thrd_ctrl = q->clients[q->head];
+            q->head = (q->head + 1) % cap;
+        } else {
+            thrd_ctrl = q->clients[(q->head + q->count - 1) % cap];
+        }
+        q->count--;
+    }
+    pthread_mutex_unlock(&(q->lock));
+    return thrd_ctrl;
+}
+
+/* queue client on its home worker if it is not already queued or
+ * being processed, otherwise note that it has more work to do */
+static void rm_schedule(reqmgr_thrd_t* thrd_ctrl)
+{
+    // NOTE: this fn assumes thrd_ctrl->thrd_lock is locked
+
+    if (thrd_ctrl->exit_flag) {
+        return;
+    }
+
+    if (thrd_ctrl->scheduled) {
+        /* worker processing this client will make another pass */
+        thrd_ctrl->pending = 1;
+        return;
+    }
+    thrd_ctrl->scheduled = 1;
+
+    rm_queue_push(rm_pool->queues + thrd_ctrl->home_worker, thrd_ctrl);
+
+    /* wake an idle worker */
+    pthread_mutex_lock(&(rm_pool->lock));
+    rm_pool->num_queued++;
+    pthread_cond_signal(&(rm_pool->cond));
+    pthread_mutex_unlock(&(rm_pool->lock));
+}
+
+/* find a queued client for the given worker, checking its own queue
+ * before stealing from others, blocks until a client is found or the
+ * pool is shutting down, returns NULL on shutdown */
+static reqmgr_thrd_t* rm_next_client(int id)
+{
+    int n = rm_pool->num_workers;
+    reqmgr_thrd_t* thrd_ctrl = NULL;
+
+    pthread_mutex_lock(&(rm_pool->lock));
+    while ((rm_pool->num_queued == 0) && !rm_pool->time_to_exit) {
+        pthread_cond_wait(&(rm_pool->cond), &(rm_pool->lock));
+    }
+    if (!rm_pool->time_to_exit) {
+        /* clients are pushed before num_queued is raised, and only
+         * popped while holding the pool lock, so a queued client
+         * is always found here */
+        for (int i = 0; i < n; i++) {
+            int victim = (id + i) % n;
+            thrd_ctrl = rm_queue_pop(rm_pool->queues + victim,
+                                     (victim == id));
+            if (NULL != thrd_ctrl) {
+                rm_pool->num_queued--;
+                break;
+            }
+        }
+        assert(NULL != thrd_ctrl);
+    }
+    pthread_mutex_unlock(&(rm_pool->lock));
+
+    return thrd_ctrl;
+}
+
+/* start the pool of request manager worker threads,
+ * uses one thread per core when num_threads is 0 */
+int rm_pool_init(int num_threads,
+                 int client_timeout)
+{
+    if (num_threads <= 0) {
+        long ncores = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = (ncores > 0) ? (int)ncores : 1;
+    }
+
+    rm_pool = (rm_pool_t*) calloc(1, sizeof(rm_pool_t));
+    if (NULL == rm_pool) {
+        LOGERR("failed to allocate request manager pool");
+        return ENOMEM;
+    }
+    rm_pool->client_timeout_ms = (long)client_timeout * 1000;
+    rm_pool->workers = (pthread_t*) calloc(num_threads, sizeof(pthread_t));
+    rm_pool->queues = (rm_worker_queue_t*)
+        calloc(num_threads, sizeof(rm_worker_queue_t));
+    rm_worker_args = (rm_worker_arg_t*)
+        calloc(num_threads, sizeof(rm_worker_arg_t));
+    if ((NULL == rm_pool->workers) ||
+        (NULL == rm_pool->queues) ||
+        (NULL == rm_worker_args)) {
+        LOGERR("failed to allocate request manager pool");
+        rm_pool_fini();
+        return ENOMEM;
+    }
+
+    pthread_mutex_init(&(rm_pool->lock), NULL);
+    pthread_cond_init(&(rm_pool->cond), NULL);
+    for (int i = 0; i < num_threads; i++) {
+        pthread_mutex_init(&(rm_pool->queues[i].lock), NULL);
+    }
+
+    /* launch request manager worker threads */
+    for (int i = 0; i < num_threads; i++) {
+        rm_worker_args[i].id = i;
+        int rc = pthread_create(&(rm_pool->workers[i]), NULL,
+                                rm_delegate_request_thread,
+                                (void*)(rm_worker_args + i));
+        if (rc != 0) {
+            LOGERR("failed to create request manager thread %d - rc=%d (%s)",
+                   i, rc, strerror(rc));
+            rm_pool_fini();
+            return (int)UNIFYFS_ERROR_THRDINIT;
+        }
+        rm_pool->num_workers++;
+    }
+
+    LOGDBG("started %d request manager threads", num_threads);
+    return (int)UNIFYFS_SUCCESS;
+}
+
+/* stop request manager worker threads */
+int rm_pool_fini(void)
+{
+    if (NULL == rm_pool) {
+        return (int)UNIFYFS_SUCCESS;
+    }
+
+    /* tell workers to exit and wait for them */
+    if (rm_pool->num_workers > 0) {
+        pthread_mutex_lock(&(rm_pool->lock));
+        rm_pool->time_to_exit = 1;
+        pthread_cond_broadcast(&(rm_pool->cond));
+        pthread_mutex_unlock(&(rm_pool->lock));
+
+        for (int i = 0; i < rm_pool->num_workers; i++) {
+            pthread_join(rm_pool->workers[i], NULL);
+        }
+
+        for (int i = 0; i < rm_pool->num_workers; i++) {
+            pthread_mutex_destroy(&(rm_pool->queues[i].lock));
+        }
+        pthread_cond_destroy(&(rm_pool->cond));
+        pthread_mutex_destroy(&(rm_pool->lock));
+    }
+
+    free(rm_pool->workers);
+    free(rm_pool->queues);
+    free(rm_pool);
+    rm_pool = NULL;
+
+    free(rm_worker_args);
+    rm_worker_args = NULL;
+
+    return (int)UNIFYFS_SUCCESS;
+}
+
+/* Create Request Manager state for application client */
 reqmgr_thrd_t* unifyfs_rm_thrd_create(int app_id, int client_id)
 {
+    if (NULL == rm_pool) {
+        LOGERR("request manager pool has not been started");
+        return NULL;
+    }
+
     /* allocate a new thread control structure */
     reqmgr_thrd_t* thrd_ctrl = (reqmgr_thrd_t*)
         calloc(1, sizeof(reqmgr_thrd_t));
     if (thrd_ctrl == NULL) {
         LOGERR("Failed to allocate structure for request "
-               "manager thread for app_id=%d client_id=%d",
+               "manager for app_id=%d client_id=%d",
                app_id, client_id);
         return NULL;
     }
 
     /* initialize lock for shared data structures between
-     * main thread and request delegator thread */
+     * rpc handlers and request manager workers */
     pthread_mutexattr_t attr;
     pthread_mutexattr_init(&attr);
     pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
     int rc = pthread_mutex_init(&(thrd_ctrl->thrd_lock), &attr);
     if (rc != 0) {
         LOGERR("pthread_mutex_init failed for request "
-               "manager thread app_id=%d client_id=%d rc=%d (%s)",
+               "manager app_id=%d client_id=%d rc=%d (%s)",
                app_id, client_id, rc, strerror(rc));
         free(thrd_ctrl);
         return NULL;
     }
 
-    /* initailize condition variable to flow control
-     * work between main thread and request delegator thread */
+    /* initailize condition variable used to wait for
+     * workers to finish with this client */
     rc = pthread_cond_init(&(thrd_ctrl->thrd_cond), NULL);
     if (rc != 0) {
         LOGERR("pthread_cond_init failed for request "
-               "manager thread app_id=%d client_id=%d rc=%d (%s)",
+               "manager app_id=%d client_id=%d rc=%d (%s)",
                app_id, client_id, rc, strerror(rc));
         pthread_mutex_destroy(&(thrd_ctrl->thrd_lock));
         free(thrd_ctrl);
         return NULL;
     }
 
-    /* record app and client id this thread will be serving */
+    /* record app and client id this state will be serving */
     thrd_ctrl->app_id    = app_id;
     thrd_ctrl->client_id = client_id;
 
     /* initialize flow control flags */
-    thrd_ctrl->exit_flag              = 0;
-    thrd_ctrl->exited                 = 0;
-    thrd_ctrl->has_waiting_delegator  = 0;
-    thrd_ctrl->has_waiting_dispatcher = 0;
-
-    /* launch request manager thread */
-    rc = pthread_create(&(thrd_ctrl->thrd), NULL,
-                        rm_delegate_request_thread, (void*)thrd_ctrl);
-    if (rc != 0) {
-        LOGERR("failed to create request manager thread for "
-               "app_id=%d client_id=%d - rc=%d (%s)",
-               app_id, client_id, rc, strerror(rc));
-        pthread_cond_destroy(&(thrd_ctrl->thrd_cond));
-        pthread_mutex_destroy(&(thrd_ctrl->thrd_lock));
-        free(thrd_ctrl);
-        return NULL;
-    }
+    thrd_ctrl->exit_flag = 0;
+    thrd_ctrl->exited    = 0;
+    thrd_ctrl->scheduled = 0;
+    thrd_ctrl->pending   = 0;
+
+    /* spread clients across worker queues */
+    pthread_mutex_lock(&(rm_pool->lock));
+    thrd_ctrl->home_worker = rm_pool->next_worker;
+    rm_pool->next_worker = (rm_pool->next_worker + 1) % rm_pool->num_workers;
+    pthread_mutex_unlock(&(rm_pool->lock));
 
     return thrd_ctrl;
 }
 
+/* order keyvals by file offset */
+static int compare_kv_offset(const void* a, const void* b)
+{
+    const unifyfs_keyval_t* kv_a = a;
+    const unifyfs_keyval_t* kv_b = b;
+
+    size_t off_a = kv_a->key.offset;
+    size_t off_b = kv_b->key.offset;
+    if (off_a == off_b) {
+        return 0;
+    } else if (off_a < off_b) {
+        return -1;
+    } else {
+        return 1;
+    }
+}
+
 /* order keyvals by gfid, then host delegator rank */
 static int compare_kv_gfid_rank(const void* a, const void* b)
 {
@@ -183,11 +419,35 @@ static int compare_kv_gfid_rank(const void* a, const void* b)
     }
 }
 
+/* largest end offset of the extents of a file */
+typedef struct {
+    int gfid;
+    size_t size;
+} file_hwm_t;
+
+/* order file end offsets by gfid */
+static int compare_hwm_gfid(const void* a, const void* b)
+{
+    const file_hwm_t* hwm_a = a;
+    const file_hwm_t* hwm_b = b;
+
+    if (hwm_a->gfid == hwm_b->gfid) {
+        return 0;
+    } else if (hwm_a->gfid < hwm_b->gfid) {
+        return -1;
+    } else {
+        return 1;
+    }
+}
+
 unifyfs_key_t** alloc_key_array(int elems)
 {
     int size = elems * (sizeof(unifyfs_key_t*) + sizeof(unifyfs_key_t));
 
     void* mem_block = calloc(size, sizeof(char));
+    if (NULL == mem_block) {
+        return NULL;
+    }
 
     unifyfs_key_t** array_ptr = mem_block;
     unifyfs_key_t* key_ptr = (unifyfs_key_t*)(array_ptr + elems);
@@ -263,6 +523,116 @@ static server_read_req_t* reserve_read_req(reqmgr_thrd_t* thrd_ctrl)
     return rdreq;
 }
 
+/* create a count of posted response sets, holding a reference for
+ * the caller */
+static chunk_read_window_count_t* window_count_create(void)
+{
+    chunk_read_window_count_t* count = (chunk_read_window_count_t*)
+        calloc(1, sizeof(chunk_read_window_count_t));
+    if (NULL == count) {
+        return NULL;
+    }
+    if (ABT_eventual_create(0, &(count->released)) != ABT_SUCCESS) {
+        free(count);
+        return NULL;
+    }
+    pthread_mutex_init(&(count->lock), NULL);
+    count->refs = 1;
+    return count;
+}
+
+/* drop a reference to a count of posted response sets, which is
+ * freed along with the last reference */
+static void window_count_put(chunk_read_window_count_t* count)
+{
+    pthread_mutex_lock(&(count->lock));
+    int refs = --(count->refs);
+    pthread_mutex_unlock(&(count->lock));
+    if (0 == refs) {
+        ABT_eventual_free(&(count->released));
+        pthread_mutex_destroy(&(count->lock));
+        free(count);
+    }
+}
+
+/* count a posted response set, which holds a reference until it
+ * is released */
+static void window_count_post(chunk_read_window_count_t* count)
+{
+    pthread_mutex_lock(&(count->lock));
+    count->posted++;
+    count->refs++;
+    pthread_mutex_unlock(&(count->lock));
+}
+
+/* release a posted response set, waking the rpc handler if it is
+ * waiting for a release */
+static void window_count_release(chunk_read_window_count_t* count)
+{
+    pthread_mutex_lock(&(count->lock));
+    count->posted--;
+    int wake = count->waiting;
+    count->waiting = 0;
+    if (wake) {
+        /* keep the count while we set the eventual */
+        count->refs++;
+    }
+    pthread_mutex_unlock(&(count->lock));
+
+    if (wake) {
+        ABT_eventual_set(count->released, NULL, 0);
+        window_count_put(count);
+    }
+    window_count_put(count);
+}
+
+/* wait until fewer than max response sets are posted and unreleased */
+static void window_count_wait(chunk_read_window_count_t* count,
+                              int max)
+{
+    pthread_mutex_lock(&(count->lock));
+    while (count->posted >= max) {
+        count->waiting = 1;
+        ABT_eventual_reset(count->released);
+        pthread_mutex_unlock(&(count->lock));
+        ABT_eventual_wait(count->released, NULL);
+        pthread_mutex_lock(&(count->lock));
+    }
+    pthread_mutex_unlock(&(count->lock));
+}
+
+/* number of posted response sets that are not released yet */
+static int window_count_posted(chunk_read_window_count_t* count)
+{
+    pthread_mutex_lock(&(count->lock));
+    int posted = count->posted;
+    pthread_mutex_unlock(&(count->lock));
+    return posted;
+}
+
+/* release a set of received chunk read responses */
+static void free_chunk_read_window(chunk_read_window_t* win)
+{
+    bulk_pool_put(win->buf);
+    if (NULL != win->count) {
+        window_count_release(win->count);
+    }
+    free(win);
+}
+
+/* release response sets received for the remote chunk reads that
+ * have not been handled */
+static void drop_chunk_read_windows(remote_chunk_reads_t* del_reads)
+{
+    chunk_read_window_t* win = del_reads->resp_windows;
+    while (NULL != win) {
+        chunk_read_window_t* next = win->next;
+        free_chunk_read_window(win);
+        win = next;
+    }
+    del_reads->resp_windows = NULL;
+}
+
 static int release_read_req(reqmgr_thrd_t* thrd_ctrl,
                             server_read_req_t* rdreq)
 {
@@ -277,8 +647,14 @@ static int release_read_req(reqmgr_thrd_t* thrd_ctrl,
             free(rdreq->chunks);
         }
         if (NULL != rdreq->remote_reads) {
+            for (int i = 0; i < rdreq->num_remote_reads; i++) {
+                drop_chunk_read_windows(rdreq->remote_reads + i);
+            }
             free(rdreq->remote_reads);
         }
+        if (NULL != rdreq->bufs) {
+            free(rdreq->bufs);
+        }
         memset((void*)rdreq, 0, sizeof(server_read_req_t));
         thrd_ctrl->num_read_reqs--;
         LOGDBG("after release (active=%d, next=%d)",
@@ -292,40 +668,6 @@ static int release_read_req(reqmgr_thrd_t* thrd_ctrl,
     return rc;
 }
 
-static void signal_new_requests(reqmgr_thrd_t* thrd_ctrl)
-{
-    // NOTE: this fn assumes thrd_ctrl->thrd_lock is locked
-
-    /* wake up the request manager thread for the requesting client */
-    if (!thrd_ctrl->has_waiting_delegator) {
-        /* delegator thread is not waiting, but we are in critical
-         * section, we just added requests so we must wait for delegator
-         * to signal us that it's reached the critical section before
-         * we escape so we don't overwrite these requests before it
-         * has had a chance to process them */
-        thrd_ctrl->has_waiting_dispatcher = 1;
-        pthread_cond_wait(&thrd_ctrl->thrd_cond, &thrd_ctrl->thrd_lock);
-
-        /* delegator thread has signaled us that it's now waiting */
-        thrd_ctrl->has_waiting_dispatcher = 0;
-    }
-    /* have a delegator thread waiting on condition variable,
-     * signal it to begin processing the requests we just added */
-    pthread_cond_signal(&thrd_ctrl->thrd_cond);
-}
-
-static void signal_new_responses(reqmgr_thrd_t* thrd_ctrl)
-{
-    // NOTE: this fn assumes thrd_ctrl->thrd_lock is locked
-
-    /* wake up the request manager thread */
-    if (thrd_ctrl->has_waiting_delegator) {
-        /* have a delegator thread waiting on condition variable,
-         * signal it to begin processing the responses we just added */
-        pthread_cond_signal(&thrd_ctrl->thrd_cond);
-    }
-}
-
 /* issue remote chunk read requests for extent chunks
  * listed within keyvals */
 int create_chunk_requests(reqmgr_thrd_t* thrd_ctrl,
@@ -433,7 +775,8 @@ int create_chunk_requests(reqmgr_thrd_t* thrd_ctrl,
             reads->rank     = curr_del;
             reads->rdreq_id = rdreq->req_ndx;
             reads->reqs     = all_chunk_reads + i;
-            reads->resp     = NULL;
+            reads->resp_windows = NULL;
+            reads->resp_posted  = 0;
         }
 
         /* increment number of read requests we're sending
@@ -450,8 +793,8 @@ int create_chunk_requests(reqmgr_thrd_t* thrd_ctrl,
     /* mark request as ready to be started */
     rdreq->status = READREQ_READY;
 
-    /* wake up the request manager thread for the requesting client */
-    signal_new_requests(thrd_ctrl);
+    /* schedule the requesting client on a request manager worker */
+    rm_schedule(thrd_ctrl);
 
     RM_UNLOCK(thrd_ctrl);
 
@@ -459,7 +802,7 @@ int create_chunk_requests(reqmgr_thrd_t* thrd_ctrl,
 }
 
 /* signal the client process for it to start processing read
- * data in shared memory */
+ * data in the shared memory segment the server is filling */
 static int client_signal(shm_data_header* hdr,
                          shm_data_state_e flag)
 {
@@ -470,51 +813,50 @@ static int client_signal(shm_data_header* hdr,
     }
 
     /* we signal the client by setting a flag value within
-     * a shared memory segment that the client is monitoring */
-    hdr->state = flag;
-
-    /* TODO: MEM_FLUSH */
+     * a shared memory segment that the client is monitoring,
+     * this wakes the client if it is blocked on the flag */
+    unifyfs_shm_segment_signal(hdr->segs + hdr->prod_seg, flag);
 
     return UNIFYFS_SUCCESS;
 }
 
-/* wait until client has processed all read data in shared memory */
-static int client_wait(shm_data_header* hdr)
+/* wait until client has processed all read data in the given
+ * shared memory segment, the client resets the segment counts
+ * before marking it empty */
+static int client_wait(shm_data_header* hdr, size_t seg)
 {
-    int rc = (int)UNIFYFS_SUCCESS;
-
-    /* specify time to sleep between checking flag in shared
-     * memory indicating client has processed data */
-    struct timespec shm_wait_tm;
-    shm_wait_tm.tv_sec  = 0;
-    shm_wait_tm.tv_nsec = SHM_WAIT_INTERVAL;
-
-    /* wait for client to set flag to 0 */
-    int max_sleep = 10000000; // 10s
-    volatile int* vip = (volatile int*)&(hdr->state);
-    while (*vip != SHMEM_REGION_EMPTY) {
-        /* not there yet, sleep for a while */
-        nanosleep(&shm_wait_tm, NULL);
-
-        /* TODO: MEM_FETCH */
-
-        max_sleep--;
-        if (0 == max_sleep) {
-            LOGERR("timed out waiting for empty");
-            rc = (int)UNIFYFS_ERROR_SHMEM;
-            break;
-        }
+    /* wait for client to set flag to 0, spinning briefly
+     * before blocking */
+    int rc = unifyfs_shm_segment_wait(hdr->segs + seg, SHMEM_REGION_EMPTY,
+                                      1, rm_pool->client_timeout_ms);
+    if (rc != (int)UNIFYFS_SUCCESS) {
+        LOGERR("timed out waiting for empty");
     }
+    return rc;
+}
+
+/* signal the client that all read data has been written, and wait
+ * for it to drain the shared memory region, the next read starts
+ * again with the first segment */
+static int client_complete(shm_data_header* hdr)
+{
+    pthread_mutex_lock(&(hdr->sync));
+
+    /* signal client that we're now done writing data */
+    client_signal(hdr, SHMEM_REGION_DATA_COMPLETE);
+
+    /* wait for client to read data, segments are drained in order
+     * so all earlier segments have been drained as well */
+    int rc = client_wait(hdr, hdr->prod_seg);
+    hdr->prod_seg = 0;
 
-    /* reset header to reflect empty state */
-    hdr->meta_cnt = 0;
-    hdr->bytes = 0;
+    pthread_mutex_unlock(&(hdr->sync));
     return rc;
 }
 
 /************************
  * These functions are called by the rpc handler to assign work
- * to the request manager thread
+ * to the request manager workers
  ***********************/
 
 /* given an app_id, client_id and global file id,
@@ -530,62 +872,17 @@ int rm_cmd_filesize(
      * in case we drop out with an error */
     *outsize = 0;
 
-    /* set offset and length to request *all* key/value pairs
-     * for this file */
-    size_t offset = 0;
-
-    /* want to pick the highest integer offset value a file
-     * could have here */
-    size_t length = (SIZE_MAX >> 1) - 1;
-
-    /* get the locations of all the read requests from the
-     * key-value store*/
-    unifyfs_key_t key1, key2;
-
-    /* create key to describe first byte we'll read */
-    key1.gfid   = gfid;
-    key1.offset = offset;
-
-    /* create key to describe last byte we'll read */
-    key2.gfid   = gfid;
-    key2.offset = offset + length - 1;
-
-    /* set up input params to specify range lookup */
-    unifyfs_key_t* unifyfs_keys[2] = {&key1, &key2};
-    int key_lens[2] = {sizeof(unifyfs_key_t), sizeof(unifyfs_key_t)};
-
-    /* look up all entries in this range */
-    int num_vals = 0;
-    unifyfs_keyval_t* keyvals = NULL;
-    int rc = unifyfs_get_file_extents(2, unifyfs_keys, key_lens,
-                                      &num_vals, &keyvals);
-    if (UNIFYFS_SUCCESS != rc) {
-        /* failed to look up extents, bail with error */
-        LOGERR("failed to retrieve extent metadata for gfid=%d", gfid);
-        return UNIFYFS_FAILURE;
-    }
-
-    /* compute our file size by iterating over each file
-     * segment and taking the max logical offset */
-    int i;
+    /* look up the largest end offset of all extents synced for this
+     * file, which is maintained as extents are inserted during sync */
     size_t filesize = 0;
-    for (i = 0; i < num_vals; i++) {
-        /* get pointer to next key value pair */
-        unifyfs_keyval_t* kv = &keyvals[i];
-
-        /* get last byte offset for this segment of the file */
-        size_t last_offset = kv->key.offset + kv->val.len;
-
-        /* update our filesize if this offset is bigger than the current max */
-        if (last_offset > filesize) {
-            filesize = last_offset;
-        }
-    }
-
-    /* free off key/value buffer returned from get_file_extents */
-    if (NULL != keyvals) {
-        free(keyvals);
-        keyvals = NULL;
+    int rc = unifyfs_get_file_size_hwm(gfid, &filesize);
+    if (ENOENT == rc) {
+        /* no extents have been synced for this file */
+        filesize = 0;
+        rc = UNIFYFS_SUCCESS;
+    } else if (UNIFYFS_SUCCESS != rc) {
+        LOGERR("failed to retrieve size metadata for gfid=%d", gfid);
+        return UNIFYFS_FAILURE;
     }
 
     /* get filesize as recorded in metadata, which may be bigger if
@@ -839,81 +1136,60 @@ int rm_cmd_truncate(
     int gfid,       /* global file id */
     size_t newsize) /* desired file size */
 {
-    /* set offset and length to request *all* key/value pairs
-     * for this file */
-    size_t offset = 0;
-
-    /* want to pick the highest integer offset value a file
-     * could have here */
-    size_t length = (SIZE_MAX >> 1) - 1;
-
-    /* get the locations of all the read requests from the
-     * key-value store*/
-    unifyfs_key_t key1, key2;
-
-    /* create key to describe first byte we'll read */
-    key1.gfid   = gfid;
-    key1.offset = offset;
-
-    /* create key to describe last byte we'll read */
-    key2.gfid   = gfid;
-    key2.offset = offset + length - 1;
-
-    /* set up input params to specify range lookup */
-    unifyfs_key_t* unifyfs_keys[2] = {&key1, &key2};
-    int key_lens[2] = {sizeof(unifyfs_key_t), sizeof(unifyfs_key_t)};
-
-    /* look up all entries in this range */
     int num_vals = 0;
     unifyfs_keyval_t* keyvals = NULL;
-    int rc = unifyfs_get_file_extents(2, unifyfs_keys, key_lens,
-                                      &num_vals, &keyvals);
-    if (UNIFYFS_SUCCESS != rc) {
-        /* failed to look up extents, bail with error */
-        return UNIFYFS_FAILURE;
-    }
 
-    /* compute our file size by iterating over each file
-     * segment and taking the max logical offset */
-    int i;
-    size_t filesize = 0;
-    for (i = 0; i < num_vals; i++) {
-        /* get pointer to next key value pair */
-        unifyfs_keyval_t* kv = &keyvals[i];
-
-        /* get last byte offset for this segment of the file */
-        size_t last_offset = kv->key.offset + kv->val.len;
-
-        /* update our filesize if this offset is bigger than the current max */
-        if (last_offset > filesize) {
-            filesize = last_offset;
-        }
+    /* look up the largest end offset of all extents synced for this
+     * file, only extents that end beyond the new file size need to be
+     * deleted or rewritten */
+    size_t extents_end = 0;
+    int rc = unifyfs_get_file_size_hwm(gfid, &extents_end);
+    if (ENOENT == rc) {
+        /* no extents have been synced for this file */
+        extents_end = 0;
+    } else if (UNIFYFS_SUCCESS != rc) {
+        return UNIFYFS_FAILURE;
     }
 
-    /* get filesize as recorded in metadata, which may be bigger if
-     * user issued an ftruncate on the file to extend it past the
-     * last write */
-    size_t filesize_meta = filesize;
-
     /* given the global file id, look up file attributes
      * from key/value store */
     unifyfs_file_attr_t fattr;
     rc = unifyfs_get_file_attribute(gfid, &fattr);
-    if (rc == UNIFYFS_SUCCESS) {
-        /* found file attribute for this file, now get its size */
-        filesize_meta = fattr.size;
-    } else {
+    if (rc != UNIFYFS_SUCCESS) {
         /* failed to find file attributes for this file */
         goto truncate_exit;
     }
 
-    /* take maximum of last write and file size from metadata */
-    if (filesize_meta > filesize) {
-        filesize = filesize_meta;
-    }
-
     /* may need to throw away and rewrite keys if shrinking file */
-    if (newsize < filesize) {
+    if (newsize < extents_end) {
+        /* Extents are split at slice boundaries when they are synced,
+         * so an extent that overlaps the new file size starts in the
+         * same slice. Look up all entries from the start of that slice
+         * to the end of the file. */
+        unifyfs_key_t key1, key2;
+
+        /* create key to describe first byte of the slice holding
+         * the new end of file */
+        key1.gfid   = gfid;
+        key1.offset = (newsize / meta_slice_sz) * meta_slice_sz;
+
+        /* create key to describe last byte we'll read */
+        key2.gfid   = gfid;
+        key2.offset = extents_end;
+
+        /* set up input params to specify range lookup */
+        unifyfs_key_t* unifyfs_keys[2] = {&key1, &key2};
+        int key_lens[2] = {sizeof(unifyfs_key_t), sizeof(unifyfs_key_t)};
+
+        /* look up all entries in this range */
+        rc = unifyfs_get_file_extents(2, unifyfs_keys, key_lens,
+                                      &num_vals, &keyvals);
+        if (UNIFYFS_SUCCESS != rc) {
+            /* failed to look up extents, bail with error */
+            rc = UNIFYFS_FAILURE;
+            goto truncate_exit;
+        }
+
         /* delete any key that extends beyond new file size */
         rc = truncate_delete_keys(newsize, num_vals, keyvals);
         if (rc != UNIFYFS_SUCCESS) {
@@ -925,6 +1201,13 @@ int rm_cmd_truncate(
         if (rc != UNIFYFS_SUCCESS) {
             goto truncate_exit;
         }
+
+        /* no remaining extent ends beyond the new size, which is
+         * recorded in the file attributes below */
+        rc = unifyfs_delete_file_size_hwm(gfid);
+        if (rc != UNIFYFS_SUCCESS) {
+            goto truncate_exit;
+        }
     }
 
     /* update file size field with latest size */
@@ -1035,7 +1318,8 @@ int rm_cmd_laminate(
 
 int create_gfid_chunk_reads(reqmgr_thrd_t* thrd_ctrl,
                             int gfid, int app_id, int client_id,
-                            int num_keys, unifyfs_key_t** keys, int* keylens)
+                            int num_keys, unifyfs_key_t** keys, int* keylens,
+                            int num_bufs, client_read_req_t* bufs)
 {
     /* lookup all key/value pairs for given range */
     int num_vals = 0;
@@ -1075,6 +1359,25 @@ int create_gfid_chunk_reads(reqmgr_thrd_t* thrd_ctrl,
             rdreq->extent.gfid    = gfid;
             rdreq->extent.errcode = EINPROGRESS;
 
+            /* remember client buffers so response data can be
+             * placed directly into them, unless they overlap, in
+             * which case data has to be copied by the client */
+            for (int i = 1; i < num_bufs; i++) {
+                if (bufs[i].offset <
+                    (bufs[i - 1].offset + bufs[i - 1].length)) {
+                    num_bufs = 0;
+                    break;
+                }
+            }
+            if (num_bufs > 0) {
+                size_t bufs_sz = num_bufs * sizeof(client_read_req_t);
+                rdreq->bufs = (client_read_req_t*) malloc(bufs_sz);
+                if (NULL != rdreq->bufs) {
+                    memcpy(rdreq->bufs, bufs, bufs_sz);
+                    rdreq->num_bufs = num_bufs;
+                }
+            }
+
             rc = create_chunk_requests(thrd_ctrl, rdreq,
                                        num_vals, keyvals);
             if (rc != (int)UNIFYFS_SUCCESS) {
@@ -1246,7 +1549,8 @@ int rm_cmd_read(
     int client_id, /* client_id for requesting client */
     int gfid,      /* global file id of read request */
     size_t offset, /* logical file offset of read request */
-    size_t length) /* number of bytes to read */
+    size_t length, /* number of bytes to read */
+    size_t buf)    /* client read buffer address (zero if none) */
 {
     /* get application client */
     app_client* client = get_app_client(app_id, client_id);
@@ -1292,9 +1596,22 @@ int rm_cmd_read(
      * MDHIM range query */
     split_request(keys, key_lens, gfid, offset, length);
 
+    /* describe client buffer if server may write into it directly */
+    int num_bufs = 0;
+    client_read_req_t rdbuf;
+    if (buf != 0) {
+        memset(&rdbuf, 0, sizeof(rdbuf));
+        rdbuf.gfid   = gfid;
+        rdbuf.offset = offset;
+        rdbuf.length = length;
+        rdbuf.buf    = buf;
+        num_bufs = 1;
+    }
+
     /* queue up the read operations */
     int rc = create_gfid_chunk_reads(thrd_ctrl, gfid,
-        app_id, client_id, key_cnt, keys, key_lens);
+        app_id, client_id, key_cnt, keys, key_lens,
+        num_bufs, &rdbuf);
 
     /* free memory allocated for key storage */
     free_key_array(keys);
@@ -1334,6 +1651,15 @@ int rm_cmd_mread(
     size_t extents_len = unifyfs_Extent_vec_len(extents);
     assert(extents_len == req_num);
 
+    /* client buffer addresses are only sent for direct reads */
+    flatbuffers_uint64_vec_t buf_addrs =
+        unifyfs_ReadRequest_bufs(readRequest);
+    if ((NULL != buf_addrs) &&
+        (flatbuffers_uint64_vec_len(buf_addrs) != extents_len)) {
+        LOGWARN("ignoring mismatched client buffer list");
+        buf_addrs = NULL;
+    }
+
     /* count up number of slices these request cover */
     int j;
     size_t slices = 0;
@@ -1354,8 +1680,11 @@ int rm_cmd_mread(
     size_t key_cnt = slices * 2;
     unifyfs_key_t** keys = alloc_key_array(key_cnt);
     int* key_lens = (int*) calloc(key_cnt, sizeof(int));
+    client_read_req_t* bufs = (client_read_req_t*)
+        calloc(req_num, sizeof(client_read_req_t));
     if ((NULL == keys) ||
-        (NULL == key_lens)) {
+        (NULL == key_lens) ||
+        (NULL == bufs)) {
         // this is a fatal error
         // TODO: we need better error handling
         LOGERR("Error allocating buffers");
@@ -1365,6 +1694,7 @@ int rm_cmd_mread(
     /* get chunks corresponding to requested client read extents */
     int ret;
     int num_keys = 0;
+    int num_bufs = 0;
     int last_gfid = -1;
     for (j = 0; j < req_num; j++) {
         /* get the file id for this request */
@@ -1375,21 +1705,36 @@ int rm_cmd_mread(
         if (j && (gfid != last_gfid)) {
             /* create requests for all extents of last_gfid */
             ret = create_gfid_chunk_reads(thrd_ctrl, last_gfid,
-                app_id, client_id, num_keys, keys, key_lens);
+                app_id, client_id, num_keys, keys, key_lens,
+                num_bufs, bufs);
             if (ret != UNIFYFS_SUCCESS) {
                 LOGERR("Error creating chunk reads for gfid=%d", last_gfid);
                 rc = ret;
             }
 
-            /* reset key counter for the current gfid */
+            /* reset key and buffer counters for the current gfid */
             num_keys = 0;
+            num_bufs = 0;
         }
 
         /* get offset and length of current read request */
         size_t off = unifyfs_Extent_offset(unifyfs_Extent_vec_at(extents, j));
         size_t len = unifyfs_Extent_length(unifyfs_Extent_vec_at(extents, j));
+        size_t buf = 0;
+        if (NULL != buf_addrs) {
+            buf = (size_t) flatbuffers_uint64_vec_at(buf_addrs, j);
+        }
         LOGDBG("gfid:%d, offset:%zu, length:%zu", gfid, off, len);
 
+        /* record client buffer if server may write into it directly */
+        if (buf != 0) {
+            bufs[num_bufs].gfid   = gfid;
+            bufs[num_bufs].offset = off;
+            bufs[num_bufs].length = len;
+            bufs[num_bufs].buf    = buf;
+            num_bufs++;
+        }
+
         /* Generate a pair of keys for each read request, representing
          * the start and end offsets. MDHIM returns all key-value pairs that
          * fall within the offset range.
@@ -1412,71 +1757,218 @@ int rm_cmd_mread(
 
     /* create requests for all extents of final gfid */
     ret = create_gfid_chunk_reads(thrd_ctrl, last_gfid,
-        app_id, client_id, num_keys, keys, key_lens);
+        app_id, client_id, num_keys, keys, key_lens,
+        num_bufs, bufs);
     if (ret != UNIFYFS_SUCCESS) {
         LOGERR("Error creating chunk reads for gfid=%d", last_gfid);
         rc = ret;
     }
 
-    /* free memory allocated for key storage */
+    /* free memory allocated for key and buffer storage */
     free_key_array(keys);
     free(key_lens);
+    free(bufs);
 
     return rc;
 }
 
-/* function called by main thread to instruct
- * resource manager thread to exit,
- * returns UNIFYFS_SUCCESS on success */
-int rm_cmd_exit(reqmgr_thrd_t* thrd_ctrl)
+/* look up where data for one range is held in the logs of clients
+ * attached to this server, appending the locations found to extents
+ * (which has room for max_extents entries) in file offset order,
+ * returns ENOSPC if the locations of the range do not all fit */
+static int log_extents_for_range(unifyfs_log_range_t* range,
+                                 int range_index,
+                                 int max_extents,
+                                 unifyfs_log_extent_t* extents,
+                                 int* num_extents)
 {
-    if (thrd_ctrl->exited) {
-        /* already done */
-        return UNIFYFS_SUCCESS;
+    int gfid = (int) range->gfid;
+    size_t offset = range->offset;
+    size_t length = range->length;
+
+    /* count number of slices this range covers */
+    size_t slices = num_slices(offset, length);
+    if (slices >= UNIFYFS_MAX_SPLIT_CNT) {
+        LOGERR("Error allocating buffers");
+        return ENOMEM;
     }
 
-    /* grab the lock */
-    RM_LOCK(thrd_ctrl);
+    /* allocate key storage */
+    size_t key_cnt = slices * 2;
+    unifyfs_key_t** keys = alloc_key_array(key_cnt);
+    int* key_lens = (int*) calloc(key_cnt, sizeof(int));
+    if ((NULL == keys) ||
+        (NULL == key_lens)) {
+        LOGERR("Error allocating buffers");
+        if (NULL != keys) {
+            free_key_array(keys);
+        }
+        if (NULL != key_lens) {
+            free(key_lens);
+        }
+        return ENOMEM;
+    }
 
-    /* if delegator thread is not waiting in critical
-     * section, let's wait on it to come back */
-    if (!thrd_ctrl->has_waiting_delegator) {
-        /* delegator thread is not in critical section,
-         * tell it we've got something and signal it */
-        thrd_ctrl->has_waiting_dispatcher = 1;
-        pthread_cond_wait(&thrd_ctrl->thrd_cond, &thrd_ctrl->thrd_lock);
+    /* split range at boundaries used for MDHIM range query,
+     * then look up all extents in range */
+    split_request(keys, key_lens, gfid, offset, length);
+    int num_vals = 0;
+    unifyfs_keyval_t* keyvals = NULL;
+    int rc = unifyfs_get_file_extents(key_cnt, keys, key_lens,
+                                      &num_vals, &keyvals);
+    free_key_array(keys);
+    free(key_lens);
+    if (UNIFYFS_SUCCESS != rc) {
+        return rc;
+    }
+
+    if (num_vals > 1) {
+        qsort(keyvals, (size_t)num_vals, sizeof(unifyfs_keyval_t),
+              compare_kv_offset);
+    }
 
-        /* we're no longer waiting */
-        thrd_ctrl->has_waiting_dispatcher = 0;
+    /* report only extents whose data lives in the log of a client
+     * that is attached to this server */
+    int count = *num_extents;
+    for (int i = 0; i < num_vals; i++) {
+        unifyfs_val_t* val = &(keyvals[i].val);
+        if (val->delegator_rank != glb_pmi_rank) {
+            continue;
+        }
+        app_client* owner = get_app_client(val->app_id, val->rank);
+        if ((NULL == owner) || (NULL == owner->logio)) {
+            continue;
+        }
+        if (count == max_extents) {
+            rc = ENOSPC;
+            break;
+        }
+
+        unifyfs_log_extent_t* ext = extents + count;
+        ext->offset         = keyvals[i].key.offset;
+        ext->length         = val->len;
+        ext->log_offset     = val->addr;
+        ext->log_mem_size   = 0;
+        if (NULL != owner->logio->shmem) {
+            ext->log_mem_size = owner->logio->shmem->size;
+        }
+        ext->log_spill_size = owner->logio->spill_sz;
+        ext->log_attach_id  = owner->attach_id;
+        ext->log_app_id     = val->app_id;
+        ext->log_client_id  = val->rank;
+        ext->range_index    = range_index;
+        count++;
+    }
+
+    if (NULL != keyvals) {
+        free(keyvals);
+    }
+
+    if (rc == UNIFYFS_SUCCESS) {
+        LOGDBG("found %d node-local extents for gfid=%d [%zu, %zu)",
+               count - *num_extents, gfid, offset, offset + length);
+        *num_extents = count;
     }
+    return rc;
+}
+
+/* look up where data for a list of client read ranges is held in the
+ * logs of clients attached to this server, so the requesting client
+ * can read it directly instead of going through the request manager
+ *
+ * @param app_id: application id
+ * @param client_id: client id for requesting process
+ * @param num_ranges: number of ranges
+ * @param ranges: array of file ranges to look up
+ * @param max_extents: size of extents array
+ * @param extents: array to fill with log locations, grouped by range
+ *                 and sorted by offset within each range
+ * @param num_extents: number of log locations found
+ * @param num_ranges_done: number of leading ranges whose locations
+ *                         were all returned
+ * @return success/error code */
+int rm_cmd_log_extents(
+    int app_id,
+    int client_id,
+    int num_ranges,
+    unifyfs_log_range_t* ranges,
+    int max_extents,
+    unifyfs_log_extent_t* extents,
+    int* num_extents,
+    int* num_ranges_done)
+{
+    *num_extents = 0;
+    *num_ranges_done = 0;
 
-    /* inform delegator thread that it's time to exit */
+    int rc = UNIFYFS_SUCCESS;
+    int i;
+    for (i = 0; i < num_ranges; i++) {
+        rc = log_extents_for_range(ranges + i, i, max_extents,
+                                   extents, num_extents);
+        if (rc != UNIFYFS_SUCCESS) {
+            break;
+        }
+        *num_ranges_done = i + 1;
+    }
+
+    /* ranges whose locations did not fit are left for the
+     * client to read through the request manager */
+    if (rc == ENOSPC) {
+        LOGDBG("extent list full after %d of %d ranges",
+               *num_ranges_done, num_ranges);
+        rc = UNIFYFS_SUCCESS;
+    }
+
+    LOGDBG("app=%d client=%d found %d node-local extents for %d ranges",
+           app_id, client_id, *num_extents, *num_ranges_done);
+
+    return rc;
+}
+
+/* function called by main thread to stop scheduling work for a
+ * client and wait for any in-progress work to finish,
+ * returns UNIFYFS_SUCCESS on success */
+int rm_cmd_exit(reqmgr_thrd_t* thrd_ctrl)
+{
+    if (thrd_ctrl->exited) {
+        /* already done */
+        return UNIFYFS_SUCCESS;
+    }
+
+    /* grab the lock */
+    RM_LOCK(thrd_ctrl);
+
+    /* prevent the client from being scheduled again */
     thrd_ctrl->exit_flag = 1;
 
-    /* signal delegator thread */
-    pthread_cond_signal(&thrd_ctrl->thrd_cond);
+    /* wait for a worker to drain the client if it is queued
+     * or being processed */
+    while (thrd_ctrl->scheduled) {
+        pthread_cond_wait(&thrd_ctrl->thrd_cond, &thrd_ctrl->thrd_lock);
+    }
 
     /* release the lock */
     RM_UNLOCK(thrd_ctrl);
 
-    /* wait for delegator thread to exit */
-    int rc = pthread_join(thrd_ctrl->thrd, NULL);
-    if (0 == rc) {
-        pthread_cond_destroy(&(thrd_ctrl->thrd_cond));
-        pthread_mutex_destroy(&(thrd_ctrl->thrd_lock));
-        thrd_ctrl->exited = 1;
-    }
+    pthread_cond_destroy(&(thrd_ctrl->thrd_cond));
+    pthread_mutex_destroy(&(thrd_ctrl->thrd_lock));
+    thrd_ctrl->exited = 1;
+
     return UNIFYFS_SUCCESS;
 }
 
 /*
- * store all writes from app-client's index in the global metadata
+ * store writes from app-client's index in the global metadata
  *
  * @param app_id: the application id
  * @param client_id: client rank in app
+ * @param gfid: global file id to sync, or -1 for all files. The client
+ *              places the entries of the file at the front of its index.
+ * @param index_buf: which of the client's index buffers to read, each
+ *                   buffer follows the previous one in the superblock
  * @return success/error code
  */
-int rm_cmd_sync(int app_id, int client_id)
+int rm_cmd_sync(int app_id, int client_id, int gfid, int index_buf)
 {
     size_t i;
 
@@ -1500,8 +1992,18 @@ int rm_cmd_sync(int app_id, int client_id)
     }
     char* superblk = (char*)(super_ctx->addr);
 
-    /* get pointer to start of key/value region in superblock */
-    char* meta = superblk + client->super_meta_offset;
+    /* get pointer to start of key/value region in superblock, each
+     * index buffer is a page holding the entry count followed by
+     * the entries */
+    size_t index_region = (size_t)page_sz + client->super_meta_size;
+    size_t meta_offset = client->super_meta_offset +
+                         ((size_t)index_buf * index_region);
+    if ((index_buf < 0) ||
+        ((meta_offset + index_region) > super_ctx->size)) {
+        LOGERR("invalid client index buffer %d", index_buf);
+        return EINVAL;
+    }
+    char* meta = superblk + meta_offset;
 
     /* get number of file extent index values client has for us,
      * stored as a size_t value in meta region of shared memory */
@@ -1519,6 +2021,19 @@ int rm_cmd_sync(int app_id, int client_id)
 
     unifyfs_index_t* meta_payload = (unifyfs_index_t*)(ptr_extents);
 
+    if (-1 != gfid) {
+        /* only process the leading entries that belong to the file */
+        for (i = 0; i < extent_num_entries; i++) {
+            if (meta_payload[i].gfid != gfid) {
+                break;
+            }
+        }
+        extent_num_entries = i;
+        if (extent_num_entries == 0) {
+            return UNIFYFS_SUCCESS;
+        }
+    }
+
     /* total up number of key/value pairs we'll need for this
      * set of index values */
     size_t slices = 0;
@@ -1537,6 +2052,9 @@ int rm_cmd_sync(int app_id, int client_id)
     unifyfs_val_t** vals = NULL;
     int* key_lens        = NULL;
     int* val_lens        = NULL;
+    file_hwm_t* hwms     = NULL;
+    int* hwm_gfids       = NULL;
+    size_t* hwm_sizes    = NULL;
 
     /* allocate storage for file extent key/values */
     /* TODO: possibly get this from memory pool */
@@ -1582,9 +2100,57 @@ int rm_cmd_sync(int app_id, int client_id)
         goto rm_cmd_fsync_exit;
     }
 
+    /* record the largest end offset of the new extents for each file,
+     * so file size queries do not need to scan the extents */
+    hwms      = calloc(extent_num_entries, sizeof(file_hwm_t));
+    hwm_gfids = calloc(extent_num_entries, sizeof(int));
+    hwm_sizes = calloc(extent_num_entries, sizeof(size_t));
+    if ((NULL == hwms) || (NULL == hwm_gfids) || (NULL == hwm_sizes)) {
+        LOGERR("failed to allocate memory for file sizes");
+        ret = ENOMEM;
+        goto rm_cmd_fsync_exit;
+    }
+
+    /* sort the end offsets by file, then keep the largest of each */
+    for (i = 0; i < extent_num_entries; i++) {
+        hwms[i].gfid = meta_payload[i].gfid;
+        hwms[i].size = meta_payload[i].file_pos + meta_payload[i].length;
+    }
+    qsort(hwms, extent_num_entries, sizeof(file_hwm_t), compare_hwm_gfid);
+
+    int num_files = 0;
+    for (i = 0; i < extent_num_entries; i++) {
+        if ((num_files == 0) ||
+            (hwm_gfids[num_files - 1] != hwms[i].gfid)) {
+            hwm_gfids[num_files] = hwms[i].gfid;
+            hwm_sizes[num_files] = hwms[i].size;
+            num_files++;
+        } else if (hwms[i].size > hwm_sizes[num_files - 1]) {
+            hwm_sizes[num_files - 1] = hwms[i].size;
+        }
+    }
+
+    ret = unifyfs_update_file_size_hwm(num_files, hwm_gfids, hwm_sizes);
+    if (ret != UNIFYFS_SUCCESS) {
+        LOGERR("unifyfs_update_file_size_hwm() failed");
+        goto rm_cmd_fsync_exit;
+    }
+
 rm_cmd_fsync_exit:
     /* clean up memory */
 
+    if (NULL != hwms) {
+        free(hwms);
+    }
+
+    if (NULL != hwm_gfids) {
+        free(hwm_gfids);
+    }
+
+    if (NULL != hwm_sizes) {
+        free(hwm_sizes);
+    }
+
     if (NULL != keys) {
         free_key_array(keys);
     }
@@ -1605,9 +2171,37 @@ rm_cmd_fsync_exit:
 }
 
 /************************
- * These functions define the logic of the request manager thread
+ * These functions define the logic of the request manager workers
  ***********************/
 
+/* state for an in-flight chunk read request rpc */
+typedef struct {
+    int rank;
+    hg_handle_t handle;
+    hg_bulk_t bulk_handle;
+    margo_request req;
+    int rc;
+} chunk_read_request_op_t;
+
+/* start a chunk read request rpc, see finish_chunk_read_request_rpc() */
+static void start_chunk_read_request_rpc(int dst_srvr_rank,
+                                         server_read_req_t* rdreq,
+                                         int num_chunks,
+                                         void* data_buf, size_t buf_sz,
+                                         chunk_read_request_op_t* op);
+
+/* wait for a chunk read request rpc to complete and free its
+ * resources, returns rpc result */
+static int finish_chunk_read_request_rpc(chunk_read_request_op_t* op);
+
+/* return size of packed chunk read requests for a single
+ * remote delegator */
+static size_t rm_packed_chunk_requests_size(remote_chunk_reads_t* remote_reads)
+{
+    size_t reqs_sz = remote_reads->num_chunks * sizeof(chunk_read_req_t);
+    return (2 * sizeof(int)) + sizeof(size_t) + reqs_sz;
+}
+
 /* pack the chunk read requests for a single remote delegator.
  *
  * @param req_msg_buf: request buffer used for packing
@@ -1623,7 +2217,7 @@ static size_t rm_pack_chunk_requests(char* req_msg_buf,
      *   {sequence of chunk_read_req_t} */
     int req_cnt = remote_reads->num_chunks;
     size_t reqs_sz = req_cnt * sizeof(chunk_read_req_t);
-    size_t packed_size = (2 * sizeof(int)) + sizeof(size_t) + reqs_sz;
+    size_t packed_size = rm_packed_chunk_requests_size(remote_reads);
 
     assert(req_cnt < MAX_META_PER_SEND);
 
@@ -1652,6 +2246,145 @@ static size_t rm_pack_chunk_requests(char* req_msg_buf,
     return packed_size;
 }
 
+/* wait for in-flight chunk read request rpcs to complete,
+ * releases the client lock while waiting so that responses
+ * can be posted as they arrive
+ *
+ * @param thrd_ctrl : reqmgr thread control structure
+ * @param ops       : in-flight rpcs
+ * @param num_ops   : number of in-flight rpcs
+ * @return success/error code
+ */
+static int rm_wait_remote_chunk_requests(reqmgr_thrd_t* thrd_ctrl,
+                                         chunk_read_request_op_t* ops,
+                                         int num_ops)
+{
+    // NOTE: this fn assumes thrd_ctrl->thrd_lock is locked once
+
+    int rc;
+    int ret = (int)UNIFYFS_SUCCESS;
+
+    RM_UNLOCK(thrd_ctrl);
+    for (int i = 0; i < num_ops; i++) {
+        rc = finish_chunk_read_request_rpc(ops + i);
+        if (rc != (int)UNIFYFS_SUCCESS) {
+            ret = rc;
+            LOGERR("server request rpc to %d failed - %s",
+                   ops[i].rank, unifyfs_rc_enum_str((unifyfs_rc)rc));
+        }
+    }
+    RM_LOCK(thrd_ctrl);
+
+    return ret;
+}
+
+/* send the chunk read requests for a read request to all remote
+ * delegators at once, then wait for them to be acknowledged,
+ * the requests for our own delegator are queued to be serviced
+ * by a margo ULT while the remote requests are in flight
+ *
+ * @param thrd_ctrl : reqmgr thread control structure
+ * @param req       : read request to send
+ * @return success/error code
+ */
+static int rm_send_remote_chunk_requests(reqmgr_thrd_t* thrd_ctrl,
+                                         server_read_req_t* req)
+{
+    // NOTE: this fn assumes thrd_ctrl->thrd_lock is locked once
+
+    int j, rc;
+    int ret = (int)UNIFYFS_SUCCESS;
+
+    /* get pointer to send buffer, requests for each delegator
+     * are packed one after another */
+    char* sendbuf = thrd_ctrl->del_req_msg_buf;
+    size_t buf_used = 0;
+
+    chunk_read_request_op_t* ops = (chunk_read_request_op_t*)
+        calloc(req->num_remote_reads, sizeof(chunk_read_request_op_t));
+    if (NULL == ops) {
+        LOGERR("failed to allocate chunk read request rpcs");
+        return ENOMEM;
+    }
+    int num_ops = 0;
+
+    /* iterate over each delegator we need to send requests to */
+    remote_chunk_reads_t* local_reads = NULL;
+    for (j = 0; j < req->num_remote_reads; j++) {
+        remote_chunk_reads_t* remote_reads = req->remote_reads + j;
+        remote_reads->status = READREQ_STARTED;
+
+        /* get rank of target delegator */
+        int del_rank = remote_reads->rank;
+        if (del_rank == glb_pmi_rank) {
+            /* handle our own requests after the others are sent */
+            local_reads = remote_reads;
+            continue;
+        }
+
+        /* if send buffer is full, wait for in-flight requests
+         * to complete so we can reuse it */
+        size_t packed_sz = rm_packed_chunk_requests_size(remote_reads);
+        if ((buf_used + packed_sz) > REQ_BUF_LEN) {
+            rc = rm_wait_remote_chunk_requests(thrd_ctrl, ops, num_ops);
+            if (rc != (int)UNIFYFS_SUCCESS) {
+                ret = rc;
+            }
+            num_ops = 0;
+            buf_used = 0;
+        }
+
+        /* pack requests into send buffer */
+        char* msg = sendbuf + buf_used;
+        packed_sz = rm_pack_chunk_requests(msg, remote_reads);
+        buf_used += packed_sz;
+
+        /* send requests */
+        LOGDBG("[%d of %d] sending %d chunk requests to server %d",
+               j, req->num_remote_reads,
+               remote_reads->num_chunks, del_rank);
+        start_chunk_read_request_rpc(del_rank, req,
+                                     remote_reads->num_chunks,
+                                     msg, packed_sz, ops + num_ops);
+        num_ops++;
+    }
+
+    /* queue reads of data held by our own delegator */
+    if (NULL != local_reads) {
+        size_t packed_sz = rm_packed_chunk_requests_size(local_reads);
+        if ((buf_used + packed_sz) > REQ_BUF_LEN) {
+            rc = rm_wait_remote_chunk_requests(thrd_ctrl, ops, num_ops);
+            if (rc != (int)UNIFYFS_SUCCESS) {
+                ret = rc;
+            }
+            num_ops = 0;
+            buf_used = 0;
+        }
+        char* msg = sendbuf + buf_used;
+        packed_sz = rm_pack_chunk_requests(msg, local_reads);
+        rc = sm_queue_local_chunk_reads(req->app_id,
+                                        req->client_id,
+                                        req->req_ndx,
+                                        local_reads->num_chunks,
+                                        msg, packed_sz);
+        if (rc != (int)UNIFYFS_SUCCESS) {
+            ret = rc;
+            LOGERR("local chunk reads failed - %s",
+                   unifyfs_rc_enum_str((unifyfs_rc)rc));
+        }
+    }
+
+    /* wait for remote delegators to acknowledge requests */
+    rc = rm_wait_remote_chunk_requests(thrd_ctrl, ops, num_ops);
+    if (rc != (int)UNIFYFS_SUCCESS) {
+        ret = rc;
+    }
+
+    free(ops);
+
+    return ret;
+}
+
 /* send the chunk read requests to remote delegators
  *
  * @param thrd_ctrl : reqmgr thread control structure
@@ -1661,12 +2394,9 @@ static int rm_request_remote_chunks(reqmgr_thrd_t* thrd_ctrl)
 {
     // NOTE: this fn assumes thrd_ctrl->thrd_lock is locked
 
-    int i, j, rc;
+    int i, rc;
     int ret = (int)UNIFYFS_SUCCESS;
 
-    /* get pointer to send buffer */
-    char* sendbuf = thrd_ctrl->del_req_msg_buf;
-
     /* iterate over each active read request */
     for (i = 0; i < RM_MAX_ACTIVE_REQUESTS; i++) {
         server_read_req_t* req = thrd_ctrl->read_reqs + i;
@@ -1675,32 +2405,9 @@ static int rm_request_remote_chunks(reqmgr_thrd_t* thrd_ctrl)
             debug_print_read_req(req);
             if (req->status == READREQ_READY) {
                 req->status = READREQ_STARTED;
-                /* iterate over each delegator we need to send requests to */
-                remote_chunk_reads_t* remote_reads;
-                size_t packed_sz;
-                for (j = 0; j < req->num_remote_reads; j++) {
-                    remote_reads = req->remote_reads + j;
-                    remote_reads->status = READREQ_STARTED;
-
-                    /* pack requests into send buffer, get packed size */
-                    packed_sz = rm_pack_chunk_requests(sendbuf, remote_reads);
-
-                    /* get rank of target delegator */
-                    int del_rank = remote_reads->rank;
-
-                    /* send requests */
-                    LOGDBG("[%d of %d] sending %d chunk requests to server %d",
-                           j, req->num_remote_reads,
-                           remote_reads->num_chunks, del_rank);
-                    rc = invoke_chunk_read_request_rpc(del_rank, req,
-                                                       remote_reads->num_chunks,
-                                                       sendbuf, packed_sz);
-                    if (rc != (int)UNIFYFS_SUCCESS) {
-                        ret = rc;
-                        LOGERR("server request rpc to %d failed - %s",
-                               del_rank,
-                               unifyfs_rc_enum_str((unifyfs_rc)rc));
-                    }
+                rc = rm_send_remote_chunk_requests(thrd_ctrl, req);
+                if (rc != (int)UNIFYFS_SUCCESS) {
+                    ret = rc;
                 }
             } else {
                 /* already started */
@@ -1723,7 +2430,7 @@ static int rm_request_remote_chunks(reqmgr_thrd_t* thrd_ctrl)
  */
 static int rm_process_remote_chunk_responses(reqmgr_thrd_t* thrd_ctrl)
 {
-    // NOTE: this fn assumes thrd_ctrl->thrd_lock is locked
+    // NOTE: this fn assumes thrd_ctrl->thrd_lock is locked once
 
     int i, j, rc;
     int ret = (int)UNIFYFS_SUCCESS;
@@ -1737,7 +2444,7 @@ static int rm_process_remote_chunk_responses(reqmgr_thrd_t* thrd_ctrl)
             remote_chunk_reads_t* rcr;
             for (j = 0; j < req->num_remote_reads; j++) {
                 rcr = req->remote_reads + j;
-                if (NULL == rcr->resp) {
+                if (NULL == rcr->resp_windows) {
                     continue;
                 }
                 LOGDBG("found read req %d responses from delegator %d",
@@ -1750,8 +2457,6 @@ static int rm_process_remote_chunk_responses(reqmgr_thrd_t* thrd_ctrl)
             }
         } else if ((req->num_remote_reads == 0) &&
                    (req->status == READREQ_STARTED)) {
-            RM_LOCK(thrd_ctrl);
-
             /* look up client shared memory region */
             int app_id = req->app_id;
             int client_id = req->client_id;
@@ -1764,11 +2469,12 @@ static int rm_process_remote_chunk_responses(reqmgr_thrd_t* thrd_ctrl)
                 /* mark request as complete */
                 req->status = READREQ_COMPLETE;
 
-                /* signal client that we're now done writing data */
-                client_signal(shm_hdr, SHMEM_REGION_DATA_COMPLETE);
-
-                /* wait for client to read data */
-                client_wait(shm_hdr);
+                /* signal client that we're now done writing data,
+                 * and wait for client to read data without holding
+                 * the client lock */
+                RM_UNLOCK(thrd_ctrl);
+                client_complete(shm_hdr);
+                RM_LOCK(thrd_ctrl);
             }
 
             rc = release_read_req(thrd_ctrl, req);
@@ -1776,8 +2482,6 @@ static int rm_process_remote_chunk_responses(reqmgr_thrd_t* thrd_ctrl)
                 LOGERR("failed to release server_read_req_t");
                 ret = rc;
             }
-
-            RM_UNLOCK(thrd_ctrl);
         }
     }
 
@@ -1792,33 +2496,40 @@ static shm_data_meta* reserve_shmem_meta(shm_context* shmem_data,
     if (NULL == hdr) {
         LOGERR("invalid header");
     } else {
-        pthread_mutex_lock(&(hdr->sync));
-        LOGDBG("shm_data_header(cnt=%zu, bytes=%zu)",
-               hdr->meta_cnt, hdr->bytes);
-        size_t remain_size = shmem_data->size -
-                             (sizeof(shm_data_header) + hdr->bytes);
         size_t meta_size = sizeof(shm_data_meta) + data_sz;
+        if (meta_size > hdr->seg_size) {
+            LOGERR("read reply of %zu bytes exceeds shmem segment size %zu",
+                   meta_size, hdr->seg_size);
+            return NULL;
+        }
+
+        pthread_mutex_lock(&(hdr->sync));
+        shm_data_segment* seg = hdr->segs + hdr->prod_seg;
+        LOGDBG("shm_data_segment[%zu](cnt=%zu, bytes=%zu)",
+               hdr->prod_seg, seg->meta_cnt, seg->bytes);
+        size_t remain_size = hdr->seg_size - seg->bytes;
         if (meta_size > remain_size) {
-            /* client-side receive buffer is full,
-             * inform client to start reading */
+            /* segment is full, inform client to start reading it */
             LOGDBG("need more space in client recv buffer");
             client_signal(hdr, SHMEM_REGION_DATA_READY);
 
-            /* wait for client to read data */
-            int rc = client_wait(hdr);
+            /* move on to the next segment, waiting for the client
+             * if it has not yet drained that segment */
+            hdr->prod_seg = (hdr->prod_seg + 1) % SHMEM_DATA_SEGMENTS;
+            int rc = client_wait(hdr, hdr->prod_seg);
             if (rc != (int)UNIFYFS_SUCCESS) {
                 LOGERR("wait for client recv buffer space failed");
                 pthread_mutex_unlock(&(hdr->sync));
                 return NULL;
             }
+            seg = hdr->segs + hdr->prod_seg;
         }
-        size_t shm_offset = hdr->bytes;
-        char* shm_buf = ((char*)hdr) + sizeof(shm_data_header);
-        meta = (shm_data_meta*)(shm_buf + shm_offset);
+        char* shm_buf = shm_data_segment_buf(hdr, hdr->prod_seg);
+        meta = (shm_data_meta*)(shm_buf + seg->bytes);
         LOGDBG("reserved shm_data_meta[%zu] and %zu payload bytes",
-               hdr->meta_cnt, data_sz);
-        hdr->meta_cnt++;
-        hdr->bytes += meta_size;
+               seg->meta_cnt, data_sz);
+        seg->meta_cnt++;
+        seg->bytes += meta_size;
         pthread_mutex_unlock(&(hdr->sync));
     }
     return meta;
@@ -1829,8 +2540,8 @@ int rm_post_chunk_read_responses(int app_id,
                                  int src_rank,
                                  int req_id,
                                  int num_chks,
-                                 size_t bulk_sz,
-                                 char* resp_buf)
+                                 bulk_buf_t* resp_buf,
+                                 chunk_read_window_count_t* count)
 {
     int rc;
 
@@ -1857,30 +2568,113 @@ int rm_post_chunk_read_responses(int app_id,
         }
     }
 
+    chunk_read_window_t* win = NULL;
     if (NULL != del_reads) {
-        LOGDBG("posting chunk responses for req %d from delegator %d",
-               req_id, src_rank);
-        del_reads->resp = (chunk_read_resp_t*)resp_buf;
-        if (del_reads->num_chunks != num_chks) {
+        win = (chunk_read_window_t*) calloc(1, sizeof(chunk_read_window_t));
+    }
+    if (NULL != win) {
+        LOGDBG("posting %d chunk responses for req %d from delegator %d",
+               num_chks, req_id, src_rank);
+        win->num_chunks = num_chks;
+        win->buf = resp_buf;
+        win->count = count;
+        if (NULL != count) {
+            window_count_post(count);
+        }
+
+        /* append to the response sets received from this server */
+        chunk_read_window_t** tail = &(del_reads->resp_windows);
+        while (NULL != *tail) {
+            tail = &((*tail)->next);
+        }
+        *tail = win;
+
+        del_reads->resp_posted += num_chks;
+        if (del_reads->resp_posted > del_reads->num_chunks) {
             LOGERR("mismatch on request vs. response chunks");
-            del_reads->num_chunks = num_chks;
+            del_reads->num_chunks = del_reads->resp_posted;
         }
-        del_reads->total_sz = bulk_sz;
         rc = (int)UNIFYFS_SUCCESS;
+    } else if (NULL != del_reads) {
+        LOGERR("failed to allocate chunk read response set");
+        rc = ENOMEM;
     } else {
         LOGERR("failed to find matching chunk-reads request");
         rc = (int)UNIFYFS_FAILURE;
     }
 
-    /* inform the request manager thread we added responses */
-    signal_new_responses(thrd_ctrl);
+    /* schedule a request manager worker to handle the responses */
+    rm_schedule(thrd_ctrl);
 
     RM_UNLOCK(thrd_ctrl);
 
     return rc;
 }
 
-/* process the requested chunk data returned from service managers
+/* maximum number of client buffers a single chunk is placed into */
+#define RM_MAX_PLACE_IOVS 64
+
+/* write chunk data for file range [offset, offset+len) directly into
+ * the client read buffers of the given request using cross-memory
+ * attach, returns 1 if all data was placed, or 0 if the caller must
+ * copy the data through shared memory instead */
+static int place_chunk_data(pid_t pid,
+                            server_read_req_t* rdreq,
+                            size_t offset,
+                            char* data,
+                            size_t len)
+{
+    if ((pid <= 0) || (0 == rdreq->num_bufs) || (0 == len)) {
+        return 0;
+    }
+
+    /* map the chunk range onto the client buffers, which are sorted
+     * by offset and do not overlap, all bytes must be covered */
+    struct iovec remote[RM_MAX_PLACE_IOVS];
+    unsigned long niov = 0;
+    size_t placed = 0;
+    size_t chunk_end = offset + len;
+    for (int i = 0; i < rdreq->num_bufs; i++) {
+        client_read_req_t* b = rdreq->bufs + i;
+        size_t buf_end = b->offset + b->length;
+        size_t cur = offset + placed;
+        if (buf_end <= cur) {
+            continue;
+        }
+        if ((b->offset > cur) || (niov == RM_MAX_PLACE_IOVS)) {
+            /* hole in buffer coverage or too many pieces */
+            return 0;
+        }
+        size_t end = (buf_end < chunk_end) ? buf_end : chunk_end;
+        remote[niov].iov_base = (void*)(uintptr_t)(b->buf + (cur - b->offset));
+        remote[niov].iov_len  = end - cur;
+        niov++;
+        placed += end - cur;
+        if (placed == len) {
+            break;
+        }
+    }
+    if (placed != len) {
+        return 0;
+    }
+
+    struct iovec local;
+    local.iov_base = data;
+    local.iov_len  = len;
+    ssize_t nwrite = process_vm_writev(pid, &local, 1, remote, niov, 0);
+    if (nwrite != (ssize_t)len) {
+        if (nwrite < 0) {
+            LOGDBG("process_vm_writev(pid=%d) failed - %s",
+                   (int)pid, strerror(errno));
+        }
+        return 0;
+    }
+    return 1;
+}
+
+/* process the requested chunk data returned from service managers,
+ * the responses of a remote server may arrive in several sets, the
+ * remote reads are complete once all responses have been handled
  *
  * @param thrd_ctrl  : request manager thread state
  * @param rdreq      : server read request
@@ -1891,6 +2685,9 @@ int rm_handle_chunk_read_responses(reqmgr_thrd_t* thrd_ctrl,
                                    server_read_req_t* rdreq,
                                    remote_chunk_reads_t* del_reads)
 {
+    // NOTE: this fn assumes thrd_ctrl->thrd_lock is locked exactly once,
+    // since it is released while data is copied to the client
+
     int errcode, gfid, i, num_chks, rc, thrd_id;
     int ret = (int)UNIFYFS_SUCCESS;
     chunk_read_resp_t* responses = NULL;
@@ -1904,7 +2701,7 @@ int rm_handle_chunk_read_responses(reqmgr_thrd_t* thrd_ctrl,
     assert((NULL != thrd_ctrl) &&
            (NULL != rdreq) &&
            (NULL != del_reads) &&
-           (NULL != del_reads->resp));
+           (NULL != del_reads->resp_windows));
 
     /* look up client shared memory region */
     app_config* app_cfg = get_application(rdreq->app_id);
@@ -1915,158 +2712,191 @@ int rm_handle_chunk_read_responses(reqmgr_thrd_t* thrd_ctrl,
     client_shm = clnt->shmem_data;
     shm_hdr = (shm_data_header*) client_shm->addr;
 
-    RM_LOCK(thrd_ctrl);
-
-    num_chks = del_reads->num_chunks;
     gfid = rdreq->extent.gfid;
     if (del_reads->status != READREQ_STARTED) {
         LOGERR("chunk read response for non-started req @ index=%d",
                rdreq->req_ndx);
-        ret = (int32_t)EINVAL;
-    } else if (0 == del_reads->total_sz) {
-        LOGERR("empty chunk read response for gfid=%d", gfid);
-        ret = (int32_t)EINVAL;
-    } else {
-        LOGDBG("handling chunk read responses from server %d: "
-               "gfid=%d num_chunks=%d buf_size=%zu",
-               del_reads->rank, gfid, num_chks,
-               del_reads->total_sz);
-        responses = del_reads->resp;
-        data_buf = (char*)(responses + num_chks);
-        for (i = 0; i < num_chks; i++) {
-            chunk_read_resp_t* resp = responses + i;
-            if (resp->read_rc < 0) {
-                errcode = (int)-(resp->read_rc);
-                data_sz = 0;
-            } else {
-                errcode = 0;
-                data_sz = resp->nbytes;
-            }
-            offset = resp->offset;
-            LOGDBG("chunk response for offset=%zu: sz=%zu", offset, data_sz);
-
-            /* allocate and register local target buffer for bulk access */
-            meta = reserve_shmem_meta(client_shm, shm_hdr, data_sz);
-            if (NULL != meta) {
-                meta->offset = offset;
-                meta->length = data_sz;
-                meta->gfid = gfid;
-                meta->errcode = errcode;
-                shm_buf = (void*)((char*)meta + sizeof(shm_data_meta));
+        drop_chunk_read_windows(del_reads);
+        return (int32_t)EINVAL;
+    }
+
+    /* handle each set of responses received so far, more sets may be
+     * posted while we copy data to the client */
+    while (NULL != del_reads->resp_windows) {
+        chunk_read_window_t* win = del_reads->resp_windows;
+        del_reads->resp_windows = NULL;
+
+        /* copying to the client may wait for it to drain shared memory,
+         * so release the client lock to let rpc handlers post responses
+         * and add requests meanwhile, only this worker touches rdreq */
+        RM_UNLOCK(thrd_ctrl);
+        while (NULL != win) {
+            num_chks = win->num_chunks;
+            LOGDBG("handling chunk read responses from server %d: "
+                   "gfid=%d num_chunks=%d buf_size=%zu",
+                   del_reads->rank, gfid, num_chks, win->buf->size);
+            responses = (chunk_read_resp_t*) win->buf->addr;
+            data_buf = (char*)(responses + num_chks);
+            for (i = 0; i < num_chks; i++) {
+                chunk_read_resp_t* resp = responses + i;
+                if (resp->read_rc < 0) {
+                    errcode = (int)-(resp->read_rc);
+                    data_sz = 0;
+                } else {
+                    errcode = 0;
+                    data_sz = resp->nbytes;
+                }
+                offset = resp->offset;
+                LOGDBG("chunk response for offset=%zu: sz=%zu",
+                       offset, data_sz);
+
+                /* try to write data straight into client read buffers,
+                 * so only the reply header goes through shared memory */
+                int direct = 0;
                 if (data_sz) {
-                    memcpy(shm_buf, data_buf, data_sz);
+                    direct = place_chunk_data(clnt->pid, rdreq, offset,
+                                              data_buf, data_sz);
                 }
-            } else {
-                LOGERR("failed to reserve shmem space for read reply")
-                ret = (int32_t)UNIFYFS_ERROR_SHMEM;
-            }
-            data_buf += data_sz;
-        }
-        /* cleanup */
-        free((void*)responses);
-        del_reads->resp = NULL;
 
-        /* update request status */
-        del_reads->status = READREQ_COMPLETE;
-        if (rdreq->status == READREQ_STARTED) {
-            rdreq->status = READREQ_PARTIAL_COMPLETE;
-        }
-        int completed_remote_reads = 0;
-        for (i = 0; i < rdreq->num_remote_reads; i++) {
-            if (rdreq->remote_reads[i].status != READREQ_COMPLETE) {
-                break;
+                /* reserve space for the reply in client shared memory */
+                meta = reserve_shmem_meta(client_shm, shm_hdr,
+                                          (direct ? 0 : data_sz));
+                if (NULL != meta) {
+                    meta->offset = offset;
+                    meta->length = data_sz;
+                    meta->gfid = gfid;
+                    meta->errcode = errcode;
+                    meta->direct = direct;
+                    shm_buf = (void*)((char*)meta + sizeof(shm_data_meta));
+                    if (data_sz && !direct) {
+                        memcpy(shm_buf, data_buf, data_sz);
+                    }
+                } else {
+                    LOGERR("failed to reserve shmem space for read reply");
+                    ret = (int32_t)UNIFYFS_ERROR_SHMEM;
+                }
+
+                /* data of every chunk occupies its full size in the
+                 * response, even when the read failed */
+                data_buf += resp->nbytes;
             }
-            completed_remote_reads++;
-        }
-        if (completed_remote_reads == rdreq->num_remote_reads) {
-            rdreq->status = READREQ_COMPLETE;
 
-            /* signal client that we're now done writing data */
-            client_signal(shm_hdr, SHMEM_REGION_DATA_COMPLETE);
+            /* cleanup */
+            chunk_read_window_t* next = win->next;
+            free_chunk_read_window(win);
+            win = next;
+        }
+        RM_LOCK(thrd_ctrl);
+    }
 
-            /* wait for client to read data */
-            client_wait(shm_hdr);
+    /* wait for the rest of the responses of this server */
+    if (del_reads->resp_posted < del_reads->num_chunks) {
+        return ret;
+    }
 
-            rc = release_read_req(thrd_ctrl, rdreq);
-            if (rc != (int)UNIFYFS_SUCCESS) {
-                LOGERR("failed to release server_read_req_t");
-            }
+    /* update request status */
+    del_reads->status = READREQ_COMPLETE;
+    if (rdreq->status == READREQ_STARTED) {
+        rdreq->status = READREQ_PARTIAL_COMPLETE;
+    }
+    int completed_remote_reads = 0;
+    for (i = 0; i < rdreq->num_remote_reads; i++) {
+        if (rdreq->remote_reads[i].status != READREQ_COMPLETE) {
+            break;
         }
+        completed_remote_reads++;
     }
+    if (completed_remote_reads == rdreq->num_remote_reads) {
+        rdreq->status = READREQ_COMPLETE;
 
-    RM_UNLOCK(thrd_ctrl);
+        /* signal client that we're now done writing data,
+         * and wait for client to read data */
+        RM_UNLOCK(thrd_ctrl);
+        client_complete(shm_hdr);
+        RM_LOCK(thrd_ctrl);
+
+        rc = release_read_req(thrd_ctrl, rdreq);
+        if (rc != (int)UNIFYFS_SUCCESS) {
+            LOGERR("failed to release server_read_req_t");
+        }
+    }
 
     return ret;
 }
 
-/* Entry point for request manager thread. One thread is created
- * for each client process to retrieve remote data and notify the
- * client when data is ready.
+/* process all outstanding work for a client, makes another pass
+ * if more work is scheduled while processing
  *
- * @param arg: pointer to RM thread control structure
- * @return NULL */
-void* rm_delegate_request_thread(void* arg)
+ * @param thrd_ctrl: client request manager state
+ * @return success/error code */
+static int rm_process_client(reqmgr_thrd_t* thrd_ctrl)
 {
-    /* get pointer to our thread control structure */
-    reqmgr_thrd_t* thrd_ctrl = (reqmgr_thrd_t*) arg;
+    int rc;
+    int ret = (int)UNIFYFS_SUCCESS;
 
-    LOGDBG("I am request manager thread!");
+    /* grab lock */
+    RM_LOCK(thrd_ctrl);
 
-    /* loop forever to handle read requests from the client,
-     * new requests are added to a list on a shared data structure
-     * with main thread, new items inserted by the rpc handler */
-    int rc;
-    while (1) {
-        /* grab lock */
-        RM_LOCK(thrd_ctrl);
+    LOGDBG("RM[%d:%d] got work", thrd_ctrl->app_id, thrd_ctrl->client_id);
+
+    do {
+        thrd_ctrl->pending = 0;
+
+        /* on exit, just drain the client */
+        if (thrd_ctrl->exit_flag) {
+            break;
+        }
+
+        /* send chunk read requests to remote servers */
+        rc = rm_request_remote_chunks(thrd_ctrl);
+        if (rc != UNIFYFS_SUCCESS) {
+            LOGERR("failed to request remote chunks");
+            ret = rc;
+        }
 
         /* process any chunk read responses */
         rc = rm_process_remote_chunk_responses(thrd_ctrl);
         if (rc != UNIFYFS_SUCCESS) {
             LOGERR("failed to process remote chunk responses");
+            ret = rc;
         }
+    } while (thrd_ctrl->pending);
 
-        /* inform dispatcher that we're waiting for work
-         * inside the critical section */
-        thrd_ctrl->has_waiting_delegator = 1;
+    /* client may now be queued again, wake main thread
+     * if it is waiting for us to finish with this client */
+    thrd_ctrl->scheduled = 0;
+    pthread_cond_signal(&thrd_ctrl->thrd_cond);
 
-        /* if dispatcher is waiting on us, signal it to go ahead,
-         * this coordination ensures that we'll be the next thread
-         * to grab the lock after the dispatcher has assigned us
-         * some work (rather than the dispatcher grabbing the lock
-         * and assigning yet more work) */
-        if (thrd_ctrl->has_waiting_dispatcher == 1) {
-            pthread_cond_signal(&thrd_ctrl->thrd_cond);
-        }
+    /* release lock */
+    RM_UNLOCK(thrd_ctrl);
 
-        /* release lock and wait to be signaled by dispatcher */
-        LOGDBG("RM[%d:%d] waiting for work",
-               thrd_ctrl->app_id, thrd_ctrl->client_id);
-        pthread_cond_wait(&thrd_ctrl->thrd_cond, &thrd_ctrl->thrd_lock);
+    return ret;
+}
 
-        /* set flag to indicate we're no longer waiting */
-        thrd_ctrl->has_waiting_delegator = 0;
+/* Entry point for request manager worker thread. A fixed number of
+ * workers are shared by all client processes to retrieve remote data
+ * and notify the client when data is ready.
+ *
+ * @param arg: pointer to worker argument
+ * @return NULL */
+static void* rm_delegate_request_thread(void* arg)
+{
+    /* get index of this worker within pool */
+    int id = ((rm_worker_arg_t*) arg)->id;
 
-        /* go do work ... */
-        LOGDBG("RM[%d:%d] got work", thrd_ctrl->app_id, thrd_ctrl->client_id);
+    LOGDBG("I am request manager thread %d!", id);
 
-        /* release lock and bail out if we've been told to exit */
-        if (thrd_ctrl->exit_flag == 1) {
-            RM_UNLOCK(thrd_ctrl);
+    /* loop until told to exit, handling read requests and responses
+     * for clients added to the worker queues by the rpc handlers */
+    while (1) {
+        reqmgr_thrd_t* thrd_ctrl = rm_next_client(id);
+        if (NULL == thrd_ctrl) {
             break;
         }
-
-        /* send chunk read requests to remote servers */
-        rc = rm_request_remote_chunks(thrd_ctrl);
-        if (rc != UNIFYFS_SUCCESS) {
-            LOGERR("failed to request remote chunks");
-        }
-
-        /* release lock */
-        RM_UNLOCK(thrd_ctrl);
+        rm_process_client(thrd_ctrl);
     }
 
-    LOGDBG("request manager thread exiting");
+    LOGDBG("request manager thread %d exiting", id);
 
     return NULL;
 }
@@ -2180,36 +3010,30 @@ int invoke_server_request_rpc(int dst_srvr_rank, int req_id, int tag,
 }
 #endif // DISABLE UNUSED RPCS
 
-/* invokes the server_request rpc */
-int invoke_chunk_read_request_rpc(int dst_srvr_rank,
-                                  server_read_req_t* rdreq,
-                                  int num_chunks,
-                                  void* data_buf, size_t buf_sz)
+/* starts the chunk_read_request rpc, the remote server pulls the
+ * packed requests in data_buf before it responds, so data_buf must
+ * not be reused until the rpc has completed */
+static void start_chunk_read_request_rpc(int dst_srvr_rank,
+                                         server_read_req_t* rdreq,
+                                         int num_chunks,
+                                         void* data_buf, size_t buf_sz,
+                                         chunk_read_request_op_t* op)
 {
-    int rc = (int)UNIFYFS_SUCCESS;
-    hg_handle_t handle;
     chunk_read_request_in_t in;
-    chunk_read_request_out_t out;
     hg_return_t hret;
     hg_addr_t dst_srvr_addr;
     hg_size_t bulk_sz = buf_sz;
 
-    if (dst_srvr_rank == glb_pmi_rank) {
-        // short-circuit for local requests
-        return sm_issue_chunk_reads(glb_pmi_rank,
-                                    rdreq->app_id,
-                                    rdreq->client_id,
-                                    rdreq->req_ndx,
-                                    num_chunks,
-                                    (char*)data_buf);
-    }
+    op->rank = dst_srvr_rank;
+    op->req  = MARGO_REQUEST_NULL;
+    op->rc   = (int)UNIFYFS_SUCCESS;
 
     assert(dst_srvr_rank < (int)glb_num_servers);
     dst_srvr_addr = glb_servers[dst_srvr_rank].margo_svr_addr;
 
     hret = margo_create(unifyfsd_rpc_context->svr_mid, dst_srvr_addr,
                         unifyfsd_rpc_context->rpcs.chunk_read_request_id,
-                        &handle);
+                        &(op->handle));
     assert(hret == HG_SUCCESS);
 
     /* fill in input struct */
@@ -2225,32 +3049,334 @@ int invoke_chunk_read_request_rpc(int dst_srvr_rank,
                              &data_buf, &bulk_sz,
                              HG_BULK_READ_ONLY, &in.bulk_handle);
     assert(hret == HG_SUCCESS);
+    op->bulk_handle = in.bulk_handle;
 
     LOGDBG("invoking the chunk-read-request rpc function");
-    hret = margo_forward(handle, &in);
+    hret = margo_iforward(op->handle, &in, &(op->req));
     if (hret != HG_SUCCESS) {
-        rc = (int)UNIFYFS_FAILURE;
-    } else {
-        /* decode response */
-        hret = margo_get_output(handle, &out);
-        if (hret == HG_SUCCESS) {
-            rc = (int)out.ret;
-            LOGDBG("Got request rpc response from %d - ret=%d",
-                   dst_srvr_rank, rc);
-            margo_free_output(handle, &out);
-        } else {
+        op->req = MARGO_REQUEST_NULL;
+        op->rc  = (int)UNIFYFS_FAILURE;
+    }
+}
+
+/* wait for a chunk read request rpc to complete and free its
+ * resources, returns rpc result */
+static int finish_chunk_read_request_rpc(chunk_read_request_op_t* op)
+{
+    int rc = op->rc;
+    chunk_read_request_out_t out;
+    hg_return_t hret;
+
+    if (op->req != MARGO_REQUEST_NULL) {
+        hret = margo_wait(op->req);
+        if (hret != HG_SUCCESS) {
             rc = (int)UNIFYFS_FAILURE;
+        } else {
+            /* decode response */
+            hret = margo_get_output(op->handle, &out);
+            if (hret == HG_SUCCESS) {
+                rc = (int)out.ret;
+                LOGDBG("Got request rpc response from %d - ret=%d",
+                       op->rank, rc);
+                margo_free_output(op->handle, &out);
+            } else {
+                rc = (int)UNIFYFS_FAILURE;
+            }
         }
     }
 
-    margo_bulk_free(in.bulk_handle);
-    margo_destroy(handle);
+    margo_bulk_free(op->bulk_handle);
+    margo_destroy(op->handle);
 
     return rc;
 }
 
 /* BEGIN MARGO SERVER-SERVER RPC HANDLER FUNCTIONS */
 
+/* pull all chunk read responses of a remote server with a single
+ * bulk transfer and hand them to the request manager */
+static int pull_chunk_read_responses(margo_instance_id mid,
+                                     const struct hg_info* hgi,
+                                     chunk_read_response_in_t* in)
+{
+    size_t bulk_sz = (size_t)in->bulk_size;
+
+    /* get a registered buffer to hold the incoming data, waiting for
+     * the request manager to return buffers when the pool is full */
+    bulk_buf_t* resp_buf = bulk_pool_get(BULK_POOL_RECV, bulk_sz, 1);
+    if (NULL == resp_buf) {
+        /* allocation failed, that's bad */
+        LOGERR("failed to allocate chunk read responses buffer");
+        return ENOMEM;
+    }
+
+    /* execute the transfer to pull data from remote side
+     * into our registered buffer */
+    hg_return_t hret = margo_bulk_transfer(mid, HG_BULK_PULL, hgi->addr,
+        in->bulk_handle, 0, resp_buf->bulk, 0, in->bulk_size);
+    if (hret != HG_SUCCESS) {
+        LOGERR("failed to pull chunk read responses");
+        bulk_pool_put(resp_buf);
+        return (int)UNIFYFS_FAILURE;
+    }
+
+    /* process read replies (headers and data) we just received */
+    int rc = rm_post_chunk_read_responses(in->app_id, in->client_id,
+        in->src_rank, in->req_id, in->num_chks, resp_buf, NULL);
+    if (rc != (int)UNIFYFS_SUCCESS) {
+        LOGERR("failed to handle chunk read responses");
+        bulk_pool_put(resp_buf);
+    }
+    return rc;
+}
+
+/* a window of chunk read responses being pulled from a remote server */
+typedef struct {
+    bulk_buf_t* buf;    /* buffer for the window headers and data */
+    int num_chks;       /* number of responses in the window */
+    margo_request req;  /* bulk transfer of the window data */
+} response_window_t;
+
+/* state for pulling the responses of a remote server in windows */
+typedef struct {
+    margo_instance_id mid;
+    const struct hg_info* hgi;
+    chunk_read_response_in_t* in;
+    chunk_read_resp_t* hdrs; /* response headers of all chunks */
+    size_t win_sz;           /* bytes of a window with several chunks */
+    int max_wins;            /* windows in flight or posted at a time */
+    int next_chk;            /* first chunk of the next window */
+    size_t next_off;         /* remote offset of the next window data */
+    response_window_t wins[RM_MAX_INFLIGHT_WINDOWS];
+    int first;               /* oldest window in flight */
+    int count;               /* number of windows in flight */
+    chunk_read_window_count_t* posted; /* windows posted to the request
+                                        * manager and not released */
+} response_windows_t;
+
+/* start bulk transfers for the next windows of responses, while fewer
+ * than max_wins are in flight or waiting to be handled by the request
+ * manager. Each window buffer holds the headers and data of whole
+ * chunks in at most win_sz bytes, unless a single chunk is larger.
+ * Window buffers come from the bulk pool. We only wait for pool space
+ * when no windows are in flight, since the windows in flight are not
+ * released until we wait for them and post them. */
+static int start_response_windows(response_windows_t* rw)
+{
+    int num_chks = (int)rw->in->num_chks;
+    while (((rw->count + window_count_posted(rw->posted)) <
+            rw->max_wins) &&
+           (rw->next_chk < num_chks)) {
+        int n = 0;
+        size_t data_sz = 0;
+        while ((rw->next_chk + n) < num_chks) {
+            size_t nbytes = rw->hdrs[rw->next_chk + n].nbytes;
+            size_t win_sz = ((n + 1) * sizeof(chunk_read_resp_t)) +
+                            data_sz + nbytes;
+            if ((n > 0) && (win_sz > rw->win_sz)) {
+                break;
+            }
+            data_sz += nbytes;
+            n++;
+        }
+
+        /* the window buffer is laid out like a full response, so the
+         * request manager handles it the same way */
+        size_t hdr_sz = n * sizeof(chunk_read_resp_t);
+        int wait = (0 == rw->count);
+        bulk_buf_t* buf = bulk_pool_get(BULK_POOL_RECV,
+                                        hdr_sz + data_sz, wait);
+        if (NULL == buf) {
+            if (!wait) {
+                /* try again once we have posted a window */
+                break;
+            }
+            LOGERR("failed to allocate chunk read response window");
+            return ENOMEM;
+        }
+        memcpy(buf->addr, rw->hdrs + rw->next_chk, hdr_sz);
+
+        int slot = (rw->first + rw->count) % RM_MAX_INFLIGHT_WINDOWS;
+        response_window_t* win = rw->wins + slot;
+        win->buf = buf;
+        win->num_chks = n;
+        win->req = MARGO_REQUEST_NULL;
+        if (data_sz > 0) {
+            hg_return_t hret = margo_bulk_itransfer(rw->mid, HG_BULK_PULL,
+                rw->hgi->addr, rw->in->bulk_handle, rw->next_off,
+                buf->bulk, hdr_sz, data_sz, &(win->req));
+            if (hret != HG_SUCCESS) {
+                LOGERR("failed to start chunk read response transfer");
+                bulk_pool_put(buf);
+                return (int)UNIFYFS_FAILURE;
+            }
+        }
+        rw->count++;
+        rw->next_chk += n;
+        rw->next_off += data_sz;
+    }
+    return (int)UNIFYFS_SUCCESS;
+}
+
+/* pull the response headers of a remote server into an allocated
+ * array, and check that the data they describe fits in the response */
+static int pull_response_headers(margo_instance_id mid,
+                                 const struct hg_info* hgi,
+                                 chunk_read_response_in_t* in,
+                                 chunk_read_resp_t** hdrs)
+{
+    int num_chks = (int)in->num_chks;
+    size_t hdr_sz = num_chks * sizeof(chunk_read_resp_t);
+
+    *hdrs = (chunk_read_resp_t*) malloc(hdr_sz);
+    if (NULL == *hdrs) {
+        LOGERR("failed to allocate chunk read response headers");
+        return ENOMEM;
+    }
+
+    /* the registered buffer is returned right away, so that it does
+     * not hold pool space needed by the windows */
+    bulk_buf_t* hdr_buf = bulk_pool_get(BULK_POOL_RECV, hdr_sz, 1);
+    if (NULL == hdr_buf) {
+        LOGERR("failed to allocate chunk read response headers");
+        free(*hdrs);
+        *hdrs = NULL;
+        return ENOMEM;
+    }
+    hg_return_t hret = margo_bulk_transfer(mid, HG_BULK_PULL, hgi->addr,
+        in->bulk_handle, 0, hdr_buf->bulk, 0, hdr_sz);
+    if (hret == HG_SUCCESS) {
+        memcpy(*hdrs, hdr_buf->addr, hdr_sz);
+    }
+    bulk_pool_put(hdr_buf);
+    if (hret != HG_SUCCESS) {
+        LOGERR("failed to pull chunk read response headers");
+        free(*hdrs);
+        *hdrs = NULL;
+        return (int)UNIFYFS_FAILURE;
+    }
+
+    /* the data of all chunks must follow the headers in the response */
+    size_t data_max = (size_t)in->bulk_size - hdr_sz;
+    size_t data_sz = 0;
+    for (int i = 0; i < num_chks; i++) {
+        size_t nbytes = (*hdrs)[i].nbytes;
+        if (nbytes > (data_max - data_sz)) {
+            LOGERR("chunk read response data exceeds %zu bytes",
+                   data_max);
+            free(*hdrs);
+            *hdrs = NULL;
+            return EINVAL;
+        }
+        data_sz += nbytes;
+    }
+    return (int)UNIFYFS_SUCCESS;
+}
+
+/* pull the chunk read responses of a remote server in windows, with
+ * several bulk transfers in flight. Each window is handed to the
+ * request manager as soon as it arrives, so that copying data to the
+ * client overlaps with the transfer of later windows. Windows waiting
+ * to be handled count against the windows in flight, so the buffer
+ * space used by a response is bounded by RM_MAX_INFLIGHT_WINDOWS
+ * windows, or fewer if the bulk pool can not hold that many. */
+static int pull_chunk_read_windows(margo_instance_id mid,
+                                   const struct hg_info* hgi,
+                                   chunk_read_response_in_t* in)
+{
+    int ret = (int)UNIFYFS_SUCCESS;
+    int num_chks = (int)in->num_chks;
+    size_t hdr_sz = num_chks * sizeof(chunk_read_resp_t);
+    if ((num_chks <= 0) || (hdr_sz > (size_t)in->bulk_size)) {
+        LOGERR("invalid chunk read response (num_chunks=%d)", num_chks);
+        return EINVAL;
+    }
+
+    response_windows_t rw;
+    memset(&rw, 0, sizeof(rw));
+    rw.mid = mid;
+    rw.hgi = hgi;
+    rw.in = in;
+    rw.next_off = hdr_sz;
+
+    /* pull the response headers, which give the size of each chunk */
+    ret = pull_response_headers(mid, hgi, in, &(rw.hdrs));
+    if (ret != (int)UNIFYFS_SUCCESS) {
+        return ret;
+    }
+
+    /* size the windows so that those we may hold fit in the pool */
+    size_t pool_sz = bulk_pool_capacity(BULK_POOL_RECV);
+    rw.win_sz = RM_RESPONSE_WINDOW_SIZE;
+    if (pool_sz < rw.win_sz) {
+        rw.win_sz = pool_sz;
+    }
+    rw.max_wins = RM_MAX_INFLIGHT_WINDOWS;
+    if ((rw.win_sz > 0) && ((pool_sz / rw.win_sz) < (size_t)rw.max_wins)) {
+        rw.max_wins = (int)(pool_sz / rw.win_sz);
+    }
+    if (rw.max_wins < 1) {
+        rw.max_wins = 1;
+    }
+
+    /* windows we post may be released after we return */
+    rw.posted = window_count_create();
+    if (NULL == rw.posted) {
+        LOGERR("failed to allocate chunk read window count");
+        free(rw.hdrs);
+        return ENOMEM;
+    }
+
+    ret = start_response_windows(&rw);
+    while ((rw.count > 0) ||
+           ((ret == (int)UNIFYFS_SUCCESS) && (rw.next_chk < num_chks))) {
+        if (0 == rw.count) {
+            /* every window we may have is waiting for the request
+             * manager, pull more once it releases some */
+            window_count_wait(rw.posted, rw.max_wins);
+            ret = start_response_windows(&rw);
+            continue;
+        }
+
+        /* wait for the oldest window */
+        response_window_t win = rw.wins[rw.first];
+        rw.first = (rw.first + 1) % RM_MAX_INFLIGHT_WINDOWS;
+        rw.count--;
+        int win_rc = (int)UNIFYFS_SUCCESS;
+        if (win.req != MARGO_REQUEST_NULL) {
+            hg_return_t hret = margo_wait(win.req);
+            if (hret != HG_SUCCESS) {
+                LOGERR("chunk read response transfer failed");
+                win_rc = (int)UNIFYFS_FAILURE;
+            }
+        }
+
+        if (win_rc == (int)UNIFYFS_SUCCESS) {
+            win_rc = rm_post_chunk_read_responses(in->app_id, in->client_id,
+                in->src_rank, in->req_id, win.num_chks, win.buf,
+                rw.posted);
+            if (win_rc != (int)UNIFYFS_SUCCESS) {
+                LOGERR("failed to handle chunk read responses");
+            }
+        }
+        if (win_rc != (int)UNIFYFS_SUCCESS) {
+            bulk_pool_put(win.buf);
+            ret = win_rc;
+            /* stop starting new windows, but drain those in flight */
+            rw.next_chk = num_chks;
+        }
+
+        /* keep the transfers going */
+        if ((ret == (int)UNIFYFS_SUCCESS) && (rw.count > 0)) {
+            ret = start_response_windows(&rw);
+        }
+    }
+
+    window_count_put(rw.posted);
+    free(rw.hdrs);
+    return ret;
+}
+
 /* handler for remote read request response */
 static void chunk_read_response_rpc(hg_handle_t handle)
 {
@@ -2264,12 +3390,14 @@ static void chunk_read_response_rpc(hg_handle_t handle)
 
     /* extract params from input struct */
     int src_rank   = (int)in.src_rank;
-    int app_id     = (int)in.app_id;
-    int client_id  = (int)in.client_id;
     int req_id     = (int)in.req_id;
     int num_chks   = (int)in.num_chks;
     size_t bulk_sz = (size_t)in.bulk_size;
 
+    LOGDBG("handling chunk read response from server %d: "
+           "req=%d num_chunks=%d bulk_sz=%zu",
+           src_rank, req_id, num_chks, bulk_sz);
+
     /* The input parameters specify the info for a bulk transfer
      * buffer on the sending process.  We use that info to pull data
      * from the sender into a local buffer.  This buffer contains
@@ -2284,48 +3412,19 @@ static void chunk_read_response_rpc(hg_handle_t handle)
         LOGERR("empty response buffer");
         ret = (int32_t)EINVAL;
     } else {
-        /* allocate a buffer to hold the incoming data */
-        char* resp_buf = (char*) malloc(bulk_sz);
-        if (NULL == resp_buf) {
-            /* allocation failed, that's bad */
-            LOGERR("failed to allocate chunk read responses buffer");
-            ret = (int32_t)ENOMEM;
-        } else {
-            /* got a buffer, now pull response data */
-            ret = (int32_t)UNIFYFS_SUCCESS;
-
-            /* get margo info */
-            const struct hg_info* hgi = margo_get_info(handle);
-            assert(NULL != hgi);
-
-            margo_instance_id mid = margo_hg_info_get_instance(hgi);
-            assert(mid != MARGO_INSTANCE_NULL);
-
-            /* pass along address of buffer we want to transfer
-             * data into to prepare it for a bulk write,
-             * get resulting margo handle */
-            hg_bulk_t bulk_handle;
-            hret = margo_bulk_create(mid, 1, (void**)&resp_buf, &in.bulk_size,
-                HG_BULK_WRITE_ONLY, &bulk_handle);
-            assert(hret == HG_SUCCESS);
-
-            /* execute the transfer to pull data from remote side
-             * into our local bulk transfer buffer */
-            hret = margo_bulk_transfer(mid, HG_BULK_PULL, hgi->addr,
-                in.bulk_handle, 0, bulk_handle, 0, in.bulk_size);
-            assert(hret == HG_SUCCESS);
-
-            /* process read replies (headers and data) we just
-             * received */
-            rc = rm_post_chunk_read_responses(app_id, client_id,
-                src_rank, req_id, num_chks, bulk_sz, resp_buf);
-            if (rc != (int)UNIFYFS_SUCCESS) {
-                LOGERR("failed to handle chunk read responses")
-                ret = rc;
-            }
+        /* get margo info */
+        const struct hg_info* hgi = margo_get_info(handle);
+        assert(NULL != hgi);
 
-            /* deregister our bulk transfer buffer */
-            margo_bulk_free(bulk_handle);
+        margo_instance_id mid = margo_hg_info_get_instance(hgi);
+        assert(mid != MARGO_INSTANCE_NULL);
+
+        /* large responses are pulled in windows, so that we can
+         * start copying data to the client before all of it arrives */
+        if (bulk_sz <= RM_RESPONSE_WINDOW_SIZE) {
+            ret = (int32_t)pull_chunk_read_responses(mid, hgi, &in);
+        } else {
+            ret = (int32_t)pull_chunk_read_windows(mid, hgi, &in);
         }
     }
 
@@ -31,6 +31,8 @@
 #define UNIFYFS_REQUEST_MANAGER_H
 
 #include "unifyfs_global.h"
+#include "unifyfs_bulk_pool.h"
+#include "unifyfs_client_rpcs.h"
 
 typedef struct {
     readreq_status_e status;   /* aggregate request status */
@@ -39,32 +41,35 @@ typedef struct {
     int client_id;             /* client id of requesting client process */
     int num_remote_reads;      /* size of remote_reads array */
     client_read_req_t extent;  /* client read extent, includes gfid */
+    int num_bufs;              /* size of bufs array */
+    client_read_req_t* bufs;   /* client read buffers, sorted by offset */
     chunk_read_req_t* chunks;  /* array of chunk-reads */
     remote_chunk_reads_t* remote_reads; /* per-delegator remote reads array */
 } server_read_req_t;
 
-/* this structure is created by the main thread for each request
- * manager thread, contains shared data structures where main thread
- * issues read requests and request manager processes them, contains
- * condition variable and lock for coordination between threads */
+/* this structure is created by the main thread for each client,
+ * contains shared data structures where rpc handlers issue read
+ * requests and request manager workers process them, contains
+ * lock and condition variable for coordination between threads */
 typedef struct reqmgr_thrd {
-    /* request manager thread */
-    pthread_t thrd;
-
-    /* condition variable to synchronize request manager thread
-     * and main thread delivering work */
+    /* condition variable used to wait for a worker to finish
+     * processing this client before it is torn down */
     pthread_cond_t thrd_cond;
 
     /* lock for shared data structures (variables below) */
     pthread_mutex_t thrd_lock;
 
-    /* flag indicating that request manager thread is waiting
-     * for work inside of critical region */
-    int has_waiting_delegator;
+    /* flag indicating this client is queued on or being processed
+     * by a request manager worker, at most one worker processes
+     * a given client at a time so its requests stay in order */
+    int scheduled;
+
+    /* flag indicating new work arrived while a worker was
+     * processing this client */
+    int pending;
 
-    /* flag indicating main thread is in critical section waiting
-     * for request manager thread */
-    int has_waiting_dispatcher;
+    /* index of the worker whose queue this client is placed on */
+    int home_worker;
 
     int num_read_reqs;
     int next_rdreq_ndx;
@@ -73,34 +78,44 @@ typedef struct reqmgr_thrd {
     /* buffer to build read request messages */
     char del_req_msg_buf[REQ_BUF_LEN];
 
-    /* flag set to indicate request manager thread should exit */
+    /* flag set to indicate no more work should be scheduled */
     int exit_flag;
 
-    /* flag set after thread has exited and join completed */
+    /* flag set after client has been drained from the workers */
     int exited;
 
-    /* app_id this thread is serving */
+    /* app_id this structure is serving */
     int app_id;
 
-    /* client_id this thread is serving */
+    /* client_id this structure is serving */
     int client_id;
 } reqmgr_thrd_t;
 
+/* start the pool of request manager worker threads,
+ * uses one thread per core when num_threads is 0, workers wait up to
+ * client_timeout seconds for a client to consume read data */
+int rm_pool_init(int num_threads,
+                 int client_timeout);
+
+/* stop request manager worker threads */
+int rm_pool_fini(void);
 
-/* create Request Manager thread for application client */
+/* create Request Manager state for application client */
 reqmgr_thrd_t* unifyfs_rm_thrd_create(int app_id,
                                       int client_id);
 
-/* Request Manager pthread main */
-void* rm_delegate_request_thread(void* arg);
-
 /* functions called by rpc handlers to assign work
  * to request manager threads */
 int rm_cmd_mread(int app_id, int client_id,
                  size_t req_num, void* reqbuf);
 
 int rm_cmd_read(int app_id, int client_id, int gfid,
-                size_t offset, size_t length);
+                size_t offset, size_t length, size_t buf);
+
+int rm_cmd_log_extents(int app_id, int client_id,
+                       int num_ranges, unifyfs_log_range_t* ranges,
+                       int max_extents, unifyfs_log_extent_t* extents,
+                       int* num_extents, int* num_ranges_done);
 
 int rm_cmd_filesize(int app_id, int client_id, int gfid, size_t* outsize);
 
@@ -113,25 +128,33 @@ int rm_cmd_unlink(int app_id, int client_id, int gfid);
 /* laminate file */
 int rm_cmd_laminate(int app_id, int client_id, int gfid);
 
-/* function called by main thread to instruct
- * resource manager thread to exit,
+/* function called by main thread to stop scheduling work for a
+ * client and wait for any in-progress work to finish,
  * returns UNIFYFS_SUCCESS on success */
 int rm_cmd_exit(reqmgr_thrd_t* thrd_ctrl);
 
-/* retrieve all write index entries for app-client and
- * store them in global metadata */
-int rm_cmd_sync(int app_id, int client_side_id);
+/* retrieve write index entries for app-client from the given index
+ * buffer and store them in global metadata, if gfid is not -1 only
+ * the leading entries for that file are retrieved */
+int rm_cmd_sync(int app_id, int client_side_id, int gfid, int index_buf);
 
-/* update state for remote chunk reads with received response data */
+/* update state for remote chunk reads with a set of received responses,
+ * resp_buf holds num_chks response headers followed by their data, on
+ * success the request manager takes ownership of resp_buf. If given,
+ * the set is counted in count until the request manager releases it,
+ * which wakes the caller if it is waiting on the count */
 int rm_post_chunk_read_responses(int app_id,
                                  int client_id,
                                  int src_rank,
                                  int req_id,
                                  int num_chks,
-                                 size_t bulk_sz,
-                                 char* resp_buf);
+                                 bulk_buf_t* resp_buf,
+                                 chunk_read_window_count_t* count);
 
-/* process the requested chunk data returned from service managers */
+/* process the requested chunk data returned from service managers.
+ * The caller must hold thrd_ctrl->thrd_lock exactly once, not
+ * recursively, since it is released and re-acquired while the data
+ * is copied to the client */
 int rm_handle_chunk_read_responses(reqmgr_thrd_t* thrd_ctrl,
                                    server_read_req_t* rdreq,
                                    remote_chunk_reads_t* del_reads);
@@ -147,9 +170,4 @@ int invoke_server_request_rpc(int dst_srvr_rank,
                               void* data_buf, size_t buf_sz);
 #endif // DISABLE UNUSED RPCS
 
-int invoke_chunk_read_request_rpc(int dst_srvr_rank,
-                                  server_read_req_t* rdreq,
-                                  int num_chunks,
-                                  void* data_buf, size_t buf_sz);
-
 #endif
@@ -28,6 +28,7 @@
  */
 
 // system headers
+#include <limits.h>
 #include <signal.h>
 #include <sys/mman.h>
 
@@ -38,6 +39,7 @@
 
 // server components
 #include "unifyfs_global.h"
+#include "unifyfs_bulk_pool.h"
 #include "unifyfs_metadata.h"
 #include "unifyfs_request_manager.h"
 #include "unifyfs_service_manager.h"
@@ -358,6 +360,24 @@ int main(int argc, char* argv[])
         exit(1);
     }
 
+    /* set up pool of registered buffers for read responses */
+    long bulk_pool_size = UNIFYFS_BULK_POOL_SIZE;
+    if (server_cfg.server_bulk_pool_size != NULL) {
+        rc = configurator_int_val(server_cfg.server_bulk_pool_size,
+                                  &bulk_pool_size);
+        if ((rc != 0) || (bulk_pool_size < 0)) {
+            LOGERR("invalid server.bulk_pool_size value '%s'",
+                   server_cfg.server_bulk_pool_size);
+            exit(1);
+        }
+    }
+    rc = bulk_pool_init(unifyfsd_rpc_context->svr_mid,
+                        (size_t)bulk_pool_size);
+    if (rc != UNIFYFS_SUCCESS) {
+        LOGERR("%s", unifyfs_rc_enum_description(rc));
+        exit(1);
+    }
+
     LOGDBG("connecting rpc servers");
     rc = margo_connect_servers();
     if (rc != UNIFYFS_SUCCESS) {
@@ -373,6 +393,34 @@ int main(int argc, char* argv[])
         exit(1);
     }
 
+    /* launch the request manager worker threads */
+    long rm_threads = 0;
+    if (server_cfg.server_rm_threads != NULL) {
+        rc = configurator_int_val(server_cfg.server_rm_threads, &rm_threads);
+        if ((rc != 0) || (rm_threads < 0) || (rm_threads > INT_MAX)) {
+            LOGERR("invalid server.rm_threads value '%s'",
+                   server_cfg.server_rm_threads);
+            exit(1);
+        }
+    }
+    long client_timeout = UNIFYFS_CLIENT_WAIT_TIMEOUT;
+    if (server_cfg.server_client_timeout != NULL) {
+        rc = configurator_int_val(server_cfg.server_client_timeout,
+                                  &client_timeout);
+        if ((rc != 0) || (client_timeout <= 0) ||
+            (client_timeout > INT_MAX)) {
+            LOGERR("invalid server.client_timeout value '%s'",
+                   server_cfg.server_client_timeout);
+            exit(1);
+        }
+    }
+    LOGDBG("launching request manager threads");
+    rc = rm_pool_init((int)rm_threads, (int)client_timeout);
+    if (rc != (int)UNIFYFS_SUCCESS) {
+        LOGERR("launch failed - %s", unifyfs_rc_enum_description(rc));
+        exit(1);
+    }
+
     LOGDBG("initializing metadata store");
     rc = meta_init_store(&server_cfg);
     if (rc != 0) {
@@ -592,12 +640,19 @@ static int unifyfs_exit(void)
         }
     }
 
+    /* stop request manager threads, clients have been drained above */
+    LOGDBG("stopping request manager threads");
+    rm_pool_fini();
+
     /* TODO: notify the service threads to exit */
 
     /* finalize kvstore service*/
     LOGDBG("finalizing kvstore service");
     unifyfs_keyval_fini();
 
+    /* release pooled bulk buffers before margo goes away */
+    bulk_pool_fini();
+
     /* shutdown rpc service
      * (note: this needs to happen after app-client cleanup above) */
     LOGDBG("stopping rpc service");
@@ -715,17 +770,68 @@ static unifyfs_rc attach_to_client_shmem(app_client* client,
     /* initialize shmem header in data region */
     shm_data_header* shm_hdr = (shm_data_header*) client->shmem_data->addr;
     pthread_mutex_init(&(shm_hdr->sync), NULL);
-    shm_hdr->meta_cnt = 0;
-    shm_hdr->bytes = 0;
-    shm_hdr->state = SHMEM_REGION_EMPTY;
+    size_t seg_size = (shmem_data_sz - sizeof(shm_data_header)) /
+                      SHMEM_DATA_SEGMENTS;
+    shm_hdr->seg_size = seg_size - (seg_size % sizeof(size_t));
+    shm_hdr->prod_seg = 0;
+    shm_hdr->cons_seg = 0;
+    for (int i = 0; i < SHMEM_DATA_SEGMENTS; i++) {
+        shm_hdr->segs[i].meta_cnt = 0;
+        shm_hdr->segs[i].bytes = 0;
+        shm_hdr->segs[i].state = SHMEM_REGION_EMPTY;
+    }
 
     return UNIFYFS_SUCCESS;
 }
 
+/**
+ * Check that the given process has the read data shared memory region
+ * of the client mapped, so that the server only writes read data
+ * directly into the process that attached as this client.
+ * @return 1 if the region is mapped by the process, 0 otherwise
+ */
+static int client_pid_maps_shmem(app_client* client,
+                                 pid_t pid)
+{
+    char path[64];
+    char shm_name[SHMEM_NAME_LEN] = {0};
+    char line[PATH_MAX + 128];
+    int found = 0;
+
+    if (pid <= 0) {
+        return 0;
+    }
+
+    /* shm_open() regions appear as /dev/shm/<name> in the maps */
+    shm_name[0] = '/';
+    snprintf(shm_name + 1, sizeof(shm_name) - 1, SHMEM_DATA_FMTSTR,
+             client->app_id, client->client_id);
+    size_t name_len = strlen(shm_name);
+
+    snprintf(path, sizeof(path), "/proc/%d/maps", (int)pid);
+    FILE* maps = fopen(path, "r");
+    if (NULL == maps) {
+        LOGDBG("failed to open %s - %s", path, strerror(errno));
+        return 0;
+    }
+    while (!found && (NULL != fgets(line, sizeof(line), maps))) {
+        size_t len = strlen(line);
+        if ((len > 0) && (line[len - 1] == '\n')) {
+            line[--len] = '\0';
+        }
+        if ((len >= name_len) &&
+            (0 == strcmp(line + len - name_len, shm_name))) {
+            found = 1;
+        }
+    }
+    fclose(maps);
+    return found;
+}
+
 /**
  * Initialize client state using passed values.
  *
- * Sets up logio and shmem region contexts, request manager thread,
+ * Sets up logio and shmem region contexts, request manager state,
  * margo rpc address, etc.
  */
 app_client* create_app_client(app_config* app,
@@ -760,7 +866,7 @@ app_client* create_app_client(app_config* app,
             failure = 1;
         }
 
-        /* create a request manager thread for this client */
+        /* create request manager state for this client */
         client->reqmgr = unifyfs_rm_thrd_create(app_id, client_id);
         if (NULL == client->reqmgr) {
             failure = 1;
@@ -779,6 +885,10 @@ app_client* create_app_client(app_config* app,
     return client;
 }
 
+/* source of app_client attach ids, lets clients reading the logs
+ * of their peers notice a peer has attached again */
+static uint32_t next_attach_id;
+
 /**
  * Attaches server to shared client state (e.g., logio and shmem regions)
  */
@@ -789,7 +899,8 @@ unifyfs_rc attach_app_client(app_client* client,
                              const size_t shmem_data_size,
                              const size_t shmem_super_size,
                              const size_t super_meta_offset,
-                             const size_t super_meta_size)
+                             const size_t super_meta_size,
+                             const pid_t client_pid)
 {
     if ((NULL == client) || (NULL == logio_spill_dir)) {
         return EINVAL;
@@ -807,6 +918,17 @@ unifyfs_rc attach_app_client(app_client* client,
                                        &(client->logio));
     if (rc != UNIFYFS_SUCCESS) {
         failure = 1;
+    } else {
+        /* read spilled data through a mapping of the spill file */
+        bool map_spill = false;
+        configurator_bool_val(server_cfg.logio_spill_mmap, &map_spill);
+        if (map_spill) {
+            rc = unifyfs_logio_map_spill(client->logio);
+            if (rc != UNIFYFS_SUCCESS) {
+                LOGWARN("failed to map spill file of client %d:%d",
+                        app_id, client_id);
+            }
+        }
     }
 
     /* attach server-side shmem regions for this client */
@@ -822,6 +944,19 @@ unifyfs_rc attach_app_client(app_client* client,
 
     client->super_meta_offset = super_meta_offset;
     client->super_meta_size = super_meta_size;
+    client->attach_id = __atomic_add_fetch(&next_attach_id, 1,
+                                           __ATOMIC_RELAXED);
+    /* enable direct reads only for a client pid that we verified */
+    client->pid = 0;
+    if (client_pid > 0) {
+        if (client_pid_maps_shmem(client, client_pid)) {
+            client->pid = client_pid;
+        } else {
+            LOGWARN("process %d does not map the shared memory of client "
+                    "%d:%d, disabling direct reads",
+                    (int)client_pid, app_id, client_id);
+        }
+    }
     client->connected = 1;
 
     return UNIFYFS_SUCCESS;
@@ -844,7 +979,7 @@ unifyfs_rc disconnect_app_client(app_client* client)
 
     client->connected = 0;
 
-    /* stop client request manager thread */
+    /* stop scheduling request manager work for client */
     if (NULL != client->reqmgr) {
         rm_cmd_exit(client->reqmgr);
     }
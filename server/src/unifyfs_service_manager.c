@@ -31,6 +31,7 @@
 #include <time.h>
 
 #include "unifyfs_global.h"
+#include "unifyfs_bulk_pool.h"
 #include "unifyfs_request_manager.h"
 #include "unifyfs_service_manager.h"
 #include "unifyfs_server_rpcs.h"
@@ -44,6 +45,9 @@ typedef struct {
     /* state synchronization mutex */
     pthread_mutex_t sync;
 
+    /* condition variable to wake SM thread when responses are queued */
+    pthread_cond_t wakeup;
+
     /* thread status */
     int initialized;
     volatile int time_to_exit;
@@ -51,14 +55,24 @@ typedef struct {
     /* thread return status code */
     int sm_exit_rc;
 
-    /* list of chunk read requests from remote delegators */
-    arraylist_t* chunk_reads;
+    /* lock-free list of chunk read responses to send to remote
+     * delegators, rpc handlers push onto the head and the SM
+     * thread takes the whole list at once */
+    remote_chunk_reads_t* chunk_reads;
 
-    /* tracks running total of bytes in current read burst */
-    size_t burst_data_sz;
+    /* flag set while SM thread is waiting on wakeup */
+    int waiting;
 } svcmgr_state_t;
 svcmgr_state_t* sm; // = NULL
 
+/* state for an in-flight chunk read response rpc */
+typedef struct {
+    remote_chunk_reads_t* rcr;
+    hg_handle_t handle;
+    margo_request req;
+    int rc;
+} chunk_read_response_op_t;
+
 /* lock macro for debugging SM locking */
 #define SM_LOCK() \
 do { \
@@ -73,10 +87,262 @@ do { \
     pthread_mutex_unlock(&(sm->sync)); \
 } while (0)
 
+/* add chunk read responses to the SM send list, and wake the
+ * SM thread if it is waiting */
+static void sm_queue_chunk_reads(remote_chunk_reads_t* rcr)
+{
+    remote_chunk_reads_t* head =
+        __atomic_load_n(&(sm->chunk_reads), __ATOMIC_RELAXED);
+    do {
+        rcr->next = head;
+    } while (!__atomic_compare_exchange_n(&(sm->chunk_reads), &head, rcr, 1,
+                                          __ATOMIC_SEQ_CST,
+                                          __ATOMIC_RELAXED));
+
+    /* the SM thread sets its waiting flag before checking the list,
+     * so it either sees our response or we see the flag */
+    if (__atomic_load_n(&(sm->waiting), __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&(sm->sync));
+        pthread_cond_signal(&(sm->wakeup));
+        pthread_mutex_unlock(&(sm->sync));
+    }
+}
+
+/* take all queued chunk read responses from the SM send list,
+ * returns list in the order responses were queued */
+static remote_chunk_reads_t* sm_take_chunk_reads(void)
+{
+    remote_chunk_reads_t* list =
+        __atomic_exchange_n(&(sm->chunk_reads), NULL, __ATOMIC_ACQUIRE);
+
+    /* list was built by pushing onto head, reverse it */
+    remote_chunk_reads_t* ordered = NULL;
+    while (NULL != list) {
+        remote_chunk_reads_t* next = list->next;
+        list->next = ordered;
+        ordered = list;
+        list = next;
+    }
+    return ordered;
+}
+
+/* a chunk read request, with the position of its data in the
+ * read reply buffer, used to sort requests by log location */
+typedef struct {
+    int app_id;        /* app id of client log holding the data */
+    int client_id;     /* client id of client log holding the data */
+    size_t log_offset; /* offset of data in client log */
+    size_t nbytes;     /* size of data */
+    size_t buf_offset; /* offset of data in reply data buffer */
+    int ndx;           /* index of request in the request array */
+} chunk_read_span_t;
+
+/* order chunk reads by (app, client, log offset) */
+static int compare_chunk_spans(const void* a, const void* b)
+{
+    const chunk_read_span_t* sa = (const chunk_read_span_t*) a;
+    const chunk_read_span_t* sb = (const chunk_read_span_t*) b;
+    if (sa->app_id != sb->app_id) {
+        return (sa->app_id < sb->app_id) ? -1 : 1;
+    }
+    if (sa->client_id != sb->client_id) {
+        return (sa->client_id < sb->client_id) ? -1 : 1;
+    }
+    if (sa->log_offset != sb->log_offset) {
+        return (sa->log_offset < sb->log_offset) ? -1 : 1;
+    }
+    return 0;
+}
+
+/* a run of chunk reads that cover adjacent or overlapping ranges of
+ * the same client log, which are served by a single log read */
+typedef struct {
+    chunk_read_span_t* spans; /* spans of the run, sorted by log offset */
+    int num_spans;            /* number of spans in the run */
+    char* tmpbuf;             /* buffer for run data, NULL if read in place */
+} chunk_read_run_t;
+
+/* Prepare the log read of a run of chunk reads. When the chunks are
+ * back to back in both the log and the reply buffer, which is the
+ * case for a large write split into slices, the run is read straight
+ * into the reply buffer. Otherwise it is read into a temporary buffer
+ * and each chunk is copied to its slot afterwards. Returns ENOMEM if
+ * the temporary buffer can not be allocated, or EINVAL if the log is
+ * not found, in which case the result of its chunks is set in resp. */
+static int prepare_chunk_run(chunk_read_run_t* run,
+                             logio_read_req* lreq,
+                             chunk_read_resp_t* resp,
+                             char* databuf)
+{
+    int i;
+    chunk_read_span_t* spans = run->spans;
+
+    /* log range covered by the run */
+    size_t run_start = spans[0].log_offset;
+    size_t run_end   = run_start;
+    for (i = 0; i < run->num_spans; i++) {
+        size_t end = spans[i].log_offset + spans[i].nbytes;
+        if (end > run_end) {
+            run_end = end;
+        }
+    }
+    size_t run_sz = run_end - run_start;
+
+    /* find the log for the run */
+    logio_context* logio_ctx = NULL;
+    app_client* app_clnt = get_app_client(spans[0].app_id,
+                                          spans[0].client_id);
+    if (NULL != app_clnt) {
+        logio_ctx = app_clnt->logio;
+    }
+    if (NULL == logio_ctx) {
+        for (i = 0; i < run->num_spans; i++) {
+            resp[spans[i].ndx].read_rc = (ssize_t)(-EINVAL);
+        }
+        return EINVAL;
+    }
+
+    int in_place = 1;
+    for (i = 1; i < run->num_spans; i++) {
+        chunk_read_span_t* prev = &spans[i - 1];
+        if ((spans[i].log_offset != (prev->log_offset + prev->nbytes)) ||
+            (spans[i].buf_offset != (prev->buf_offset + prev->nbytes))) {
+            in_place = 0;
+            break;
+        }
+    }
+
+    run->tmpbuf = NULL;
+    char* readbuf = databuf + spans[0].buf_offset;
+    if (!in_place) {
+        run->tmpbuf = (char*) malloc(run_sz);
+        if (NULL == run->tmpbuf) {
+            return ENOMEM;
+        }
+        readbuf = run->tmpbuf;
+    }
+
+    lreq->ctx        = logio_ctx;
+    lreq->log_offset = (off_t) run_start;
+    lreq->nbytes     = run_sz;
+    lreq->buf        = readbuf;
+    return UNIFYFS_SUCCESS;
+}
+
+/* Set the result of each chunk read of a run from its completed log
+ * read, each chunk gets the bytes of the run read within its range */
+static void finish_chunk_run(chunk_read_run_t* run,
+                             logio_read_req* lreq,
+                             chunk_read_resp_t* resp,
+                             char* databuf)
+{
+    int i;
+    chunk_read_span_t* spans = run->spans;
+
+    if (lreq->rc != UNIFYFS_SUCCESS) {
+        for (i = 0; i < run->num_spans; i++) {
+            resp[spans[i].ndx].read_rc = (ssize_t)(-(lreq->rc));
+        }
+    } else {
+        size_t run_start = (size_t) lreq->log_offset;
+        size_t nread = lreq->nread;
+        for (i = 0; i < run->num_spans; i++) {
+            chunk_read_span_t* span = &spans[i];
+            size_t span_start = span->log_offset - run_start;
+            size_t span_nread = 0;
+            if (nread > span_start) {
+                span_nread = nread - span_start;
+                if (span_nread > span->nbytes) {
+                    span_nread = span->nbytes;
+                }
+            }
+            if ((NULL != run->tmpbuf) && (span_nread > 0)) {
+                memcpy(databuf + span->buf_offset,
+                       run->tmpbuf + span_start, span_nread);
+            }
+            resp[span->ndx].read_rc = (ssize_t) span_nread;
+        }
+    }
+
+    free(run->tmpbuf);
+    run->tmpbuf = NULL;
+}
+
+/* Read the data of all chunk reads, grouped in runs, with a single
+ * batch of log reads so that the spill file reads of the runs are
+ * in flight together. */
+static void read_chunk_runs(chunk_read_run_t* runs,
+                            int num_runs,
+                            chunk_read_resp_t* resp,
+                            char* databuf)
+{
+    int i, j;
+
+    /* runs, plus single chunk runs split from runs we could not
+     * get a temporary buffer for, never exceed one per chunk */
+    int max_runs = 0;
+    for (i = 0; i < num_runs; i++) {
+        max_runs += runs[i].num_spans;
+    }
+
+    chunk_read_run_t* batch_runs = (chunk_read_run_t*)
+        calloc(max_runs, sizeof(chunk_read_run_t));
+    logio_read_req* lreqs = (logio_read_req*)
+        calloc(max_runs, sizeof(logio_read_req));
+    if ((NULL == batch_runs) || (NULL == lreqs)) {
+        LOGERR("failed to allocate chunk read batch");
+        for (i = 0; i < num_runs; i++) {
+            for (j = 0; j < runs[i].num_spans; j++) {
+                resp[runs[i].spans[j].ndx].read_rc = (ssize_t)(-ENOMEM);
+            }
+        }
+        free(batch_runs);
+        free(lreqs);
+        return;
+    }
+
+    int num_batch = 0;
+    for (i = 0; i < num_runs; i++) {
+        chunk_read_run_t* run = &runs[i];
+        batch_runs[num_batch] = *run;
+        int rc = prepare_chunk_run(&batch_runs[num_batch], &lreqs[num_batch],
+                                   resp, databuf);
+        if (rc == UNIFYFS_SUCCESS) {
+            num_batch++;
+        } else if (rc == ENOMEM) {
+            /* no temporary buffer, read each chunk in place */
+            for (j = 0; j < run->num_spans; j++) {
+                batch_runs[num_batch].spans = &(run->spans[j]);
+                batch_runs[num_batch].num_spans = 1;
+                rc = prepare_chunk_run(&batch_runs[num_batch],
+                                       &lreqs[num_batch], resp, databuf);
+                if (rc == UNIFYFS_SUCCESS) {
+                    num_batch++;
+                }
+            }
+        }
+    }
+
+    int rc = unifyfs_logio_read_batch(lreqs, num_batch);
+    for (i = 0; i < num_batch; i++) {
+        if (rc != UNIFYFS_SUCCESS) {
+            lreqs[i].rc = rc;
+        }
+        finish_chunk_run(&batch_runs[i], &lreqs[i], resp, databuf);
+    }
+
+    free(batch_runs);
+    free(lreqs);
+}
+
 /* Decode and issue chunk-reads received from request manager.
  * We get a list of read requests for data on our node.  Read
  * data for each request and construct a set of read replies
- * that will be sent back to the request manager.
+ * that will be sent back to the request manager.  Requests for
+ * adjacent or overlapping data of the same client log are served
+ * by a single log read, and the log reads of all requests are
+ * issued as one batch. This may wait for bulk buffers, so it is
+ * only called from ULTs, see sm_queue_local_chunk_reads().
  *
  * @param src_rank      : source delegator rank
  * @param src_app_id    : app id at source delegator
@@ -119,13 +385,14 @@ int sm_issue_chunk_reads(int src_rank,
     size_t resp_sz = sizeof(chunk_read_resp_t) * num_chks;
     size_t buf_sz  = resp_sz + total_data_sz;
 
-    /* allocate the buffer */
-    // NOTE: calloc() is required here, don't use malloc
-    char* crbuf = (char*) calloc(1, buf_sz);
-    if (NULL == crbuf) {
+    /* get a registered buffer from the bulk pool, this waits for
+     * buffers in use by earlier responses when the pool is full */
+    bulk_buf_t* resp_buf = bulk_pool_get(BULK_POOL_SEND, buf_sz, 1);
+    if (NULL == resp_buf) {
         LOGERR("failed to allocate chunk_read_reqs");
         return ENOMEM;
     }
+    char* crbuf = (char*) resp_buf->addr;
 
     /* the chunk read response array starts as the first
      * byte in our buffer and the data buffer follows
@@ -138,6 +405,7 @@ int sm_issue_chunk_reads(int src_rank,
         calloc(1, sizeof(remote_chunk_reads_t));
     if (NULL == rcr) {
         LOGERR("failed to allocate remote_chunk_reads");
+        bulk_pool_put(resp_buf);
         return ENOMEM;
     }
 
@@ -150,16 +418,26 @@ int sm_issue_chunk_reads(int src_rank,
     rcr->reqs       = NULL;
     rcr->total_sz   = buf_sz;
     rcr->resp       = resp;
+    rcr->resp_buf   = resp_buf;
 
     LOGDBG("issuing %d requests, total data size = %zu",
            num_chks, total_data_sz);
 
+    /* allocate list of requests to sort by log location */
+    chunk_read_span_t* spans = (chunk_read_span_t*)
+        calloc(num_chks, sizeof(chunk_read_span_t));
+    if (NULL == spans) {
+        LOGERR("failed to allocate chunk read spans");
+        free(rcr);
+        bulk_pool_put(resp_buf);
+        return ENOMEM;
+    }
+
     /* points to offset in read reply buffer to place
      * data for next read */
     size_t buf_cursor = 0;
 
     int i;
-    app_client* app_clnt = NULL;
     for (i = 0; i < num_chks; i++) {
         /* pointer to next read request */
         chunk_read_req_t* rreq = reqs + i;
@@ -167,9 +445,8 @@ int sm_issue_chunk_reads(int src_rank,
         /* pointer to next read response */
         chunk_read_resp_t* rresp = resp + i;
 
-        /* get size and log offset of data we are to read */
+        /* get size of data we are to read */
         size_t nbytes = rreq->nbytes;
-        size_t log_offset = rreq->log_offset;
 
         /* record request metadata in response */
         rresp->read_rc = 0;
@@ -178,37 +455,72 @@ int sm_issue_chunk_reads(int src_rank,
         LOGDBG("reading chunk(offset=%zu, size=%zu)",
                rreq->offset, nbytes);
 
-        /* get pointer to next position in buffer to store read data */
-        char* buf_ptr = databuf + buf_cursor;
-
-        /* read data from client log */
-        int app_id = rreq->log_app_id;
-        int cli_id = rreq->log_client_id;
-        app_clnt = get_app_client(app_id, cli_id);
-        if (NULL != app_clnt) {
-            logio_context* logio_ctx = app_clnt->logio;
-            if (NULL != logio_ctx) {
-                size_t nread = 0;
-                int rc = unifyfs_logio_read(logio_ctx, log_offset, nbytes,
-                                            buf_ptr, &nread);
-                if (UNIFYFS_SUCCESS == rc) {
-                    rresp->read_rc = nread;
-                } else {
-                    rresp->read_rc = (ssize_t)(-rc);
-                }
-            } else {
-                rresp->read_rc = (ssize_t)(-EINVAL);
-            }
-        } else {
-            rresp->read_rc = (ssize_t)(-EINVAL);
-        }
+        /* record where the data lives and where it goes */
+        spans[i].app_id     = rreq->log_app_id;
+        spans[i].client_id  = rreq->log_client_id;
+        spans[i].log_offset = rreq->log_offset;
+        spans[i].nbytes     = nbytes;
+        spans[i].buf_offset = buf_cursor;
+        spans[i].ndx        = i;
 
         /* update to point to next slot in read reply buffer */
         buf_cursor += nbytes;
+    }
 
-        /* update accounting for burst size */
-        sm->burst_data_sz += nbytes;
+    /* sort requests by log location and group the requests for
+     * adjacent or overlapping data in the same log into runs */
+    qsort(spans, num_chks, sizeof(chunk_read_span_t), compare_chunk_spans);
+    chunk_read_run_t* runs = (chunk_read_run_t*)
+        calloc(num_chks, sizeof(chunk_read_run_t));
+    if (NULL == runs) {
+        LOGERR("failed to allocate chunk read runs");
+        free(spans);
+        free(rcr);
+        bulk_pool_put(resp_buf);
+        return ENOMEM;
     }
+    int num_runs = 0;
+    size_t run_end = 0;
+    for (i = 0; i < num_chks; i++) {
+        chunk_read_span_t* span = &spans[i];
+        chunk_read_run_t* run = NULL;
+        if (num_runs > 0) {
+            run = &runs[num_runs - 1];
+            if ((span->app_id != run->spans[0].app_id) ||
+                (span->client_id != run->spans[0].client_id) ||
+                (span->log_offset > run_end)) {
+                /* span starts a new run */
+                run = NULL;
+            }
+        }
+        if (NULL == run) {
+            run = &runs[num_runs++];
+            run->spans = span;
+            run->num_spans = 0;
+            run_end = 0;
+        }
+        run->num_spans++;
+        if ((span->log_offset + span->nbytes) > run_end) {
+            run_end = span->log_offset + span->nbytes;
+        }
+    }
+
+    /* read the data of all runs at once */
+    read_chunk_runs(runs, num_runs, resp, databuf);
+    free(runs);
+
+    /* the reply buffer is not zeroed, so clear the data slots of
+     * chunks that were not read in full */
+    for (i = 0; i < num_chks; i++) {
+        chunk_read_span_t* span = &spans[i];
+        ssize_t read_rc = resp[span->ndx].read_rc;
+        size_t valid = (read_rc > 0) ? (size_t)read_rc : 0;
+        if (valid < span->nbytes) {
+            memset(databuf + span->buf_offset + valid, 0,
+                   span->nbytes - valid);
+        }
+    }
+    free(spans);
 
     if (src_rank != glb_pmi_rank) {
         /* we need to send these read responses to another rank,
@@ -217,9 +529,7 @@ int sm_issue_chunk_reads(int src_rank,
         LOGDBG("adding to svcmgr chunk_reads");
         assert(NULL != sm);
 
-        SM_LOCK();
-        arraylist_add(sm->chunk_reads, rcr);
-        SM_UNLOCK();
+        sm_queue_chunk_reads(rcr);
 
         /* rcr will be freed later by the sending thread */
 
@@ -230,9 +540,10 @@ int sm_issue_chunk_reads(int src_rank,
         LOGDBG("responding to myself");
         int rc = rm_post_chunk_read_responses(src_app_id, src_client_id,
                                               src_rank, src_req_id,
-                                              num_chks, buf_sz, crbuf);
+                                              num_chks, resp_buf, NULL);
         if (rc != (int)UNIFYFS_SUCCESS) {
             LOGERR("failed to handle chunk read responses");
+            bulk_pool_put(resp_buf);
         }
 
         /* clean up allocated buffers */
@@ -242,6 +553,83 @@ int sm_issue_chunk_reads(int src_rank,
     }
 }
 
+/* chunk reads of our own request manager, serviced by a ULT */
+typedef struct {
+    int app_id;     /* app id of requesting client */
+    int client_id;  /* client id of requesting client */
+    int req_id;     /* request id at request manager */
+    int num_chks;   /* number of chunk requests */
+    char* msg_buf;  /* copy of the packed chunk requests */
+} local_chunk_reads_t;
+
+static void local_chunk_reads_ult(void* arg)
+{
+    local_chunk_reads_t* lcr = (local_chunk_reads_t*) arg;
+    int rc = sm_issue_chunk_reads(glb_pmi_rank, lcr->app_id,
+                                  lcr->client_id, lcr->req_id,
+                                  lcr->num_chks, lcr->msg_buf);
+    if (rc != (int)UNIFYFS_SUCCESS) {
+        LOGERR("local chunk reads failed - %s",
+               unifyfs_rc_enum_str((unifyfs_rc)rc));
+    }
+    free(lcr->msg_buf);
+    free(lcr);
+}
+
+/* Queue the chunk reads of our own request manager to be issued by a
+ * ULT in the margo handler pool, as those of remote servers are. The
+ * reads may wait for bulk buffers to be returned, which the request
+ * manager threads must not do, since they return them.
+ *
+ * @param app_id    : app id of requesting client
+ * @param client_id : client id of requesting client
+ * @param req_id    : request id at request manager
+ * @param num_chks  : number of chunk requests
+ * @param msg_buf   : message buffer containing request(s), copied
+ * @param msg_sz    : size of message buffer
+ * @return success/error code
+ */
+int sm_queue_local_chunk_reads(int app_id,
+                               int client_id,
+                               int req_id,
+                               int num_chks,
+                               char* msg_buf,
+                               size_t msg_sz)
+{
+    local_chunk_reads_t* lcr = (local_chunk_reads_t*)
+        calloc(1, sizeof(local_chunk_reads_t));
+    if (NULL == lcr) {
+        LOGERR("failed to allocate local chunk reads");
+        return ENOMEM;
+    }
+    lcr->msg_buf = (char*) malloc(msg_sz);
+    if (NULL == lcr->msg_buf) {
+        LOGERR("failed to allocate local chunk reads");
+        free(lcr);
+        return ENOMEM;
+    }
+    memcpy(lcr->msg_buf, msg_buf, msg_sz);
+    lcr->app_id    = app_id;
+    lcr->client_id = client_id;
+    lcr->req_id    = req_id;
+    lcr->num_chks  = num_chks;
+
+    ABT_pool handler_pool;
+    int rc = margo_get_handler_pool(unifyfsd_rpc_context->svr_mid,
+                                    &handler_pool);
+    if (rc == 0) {
+        rc = ABT_thread_create(handler_pool, local_chunk_reads_ult, lcr,
+                               ABT_THREAD_ATTR_NULL, NULL);
+    }
+    if (rc != ABT_SUCCESS) {
+        LOGERR("failed to start local chunk reads");
+        free(lcr->msg_buf);
+        free(lcr);
+        return (int)UNIFYFS_FAILURE;
+    }
+    return (int)UNIFYFS_SUCCESS;
+}
+
 /* initialize and launch service manager thread */
 int svcmgr_init(void)
 {
@@ -253,20 +641,21 @@ int svcmgr_init(void)
         return ENOMEM;
     }
 
-    /* tracks how much data we process in each burst */
-    sm->burst_data_sz = 0;
+    /* list of chunk read responses starts empty */
+    sm->chunk_reads = NULL;
+    sm->waiting = 0;
 
-    /* allocate a list to track chunk read requests */
-    sm->chunk_reads = arraylist_create();
-    if (sm->chunk_reads == NULL) {
-        LOGERR("failed to allocate service manager chunk_reads!");
+    int rc = pthread_mutex_init(&(sm->sync), NULL);
+    if (0 != rc) {
+        LOGERR("failed to initialize service manager mutex!");
         svcmgr_fini();
-        return ENOMEM;
+        return (int)UNIFYFS_ERROR_THRDINIT;
     }
 
-    int rc = pthread_mutex_init(&(sm->sync), NULL);
+    rc = pthread_cond_init(&(sm->wakeup), NULL);
     if (0 != rc) {
-        LOGERR("failed to initialize service manager mutex!");
+        LOGERR("failed to initialize service manager condition!");
+        pthread_mutex_destroy(&(sm->sync));
         svcmgr_fini();
         return (int)UNIFYFS_ERROR_THRDINIT;
     }
@@ -289,18 +678,24 @@ int svcmgr_fini(void)
 {
     if (NULL != sm) {
         if (sm->thrd) {
+            SM_LOCK();
             sm->time_to_exit = 1;
+            pthread_cond_signal(&(sm->wakeup));
+            SM_UNLOCK();
             pthread_join(sm->thrd, NULL);
         }
 
-        if (sm->initialized) {
-            SM_LOCK();
+        /* drop any responses that were not sent */
+        remote_chunk_reads_t* rcr = sm_take_chunk_reads();
+        while (NULL != rcr) {
+            remote_chunk_reads_t* next = rcr->next;
+            bulk_pool_put(rcr->resp_buf);
+            free(rcr);
+            rcr = next;
         }
 
-        arraylist_free(sm->chunk_reads);
-
         if (sm->initialized) {
-            SM_UNLOCK();
+            pthread_cond_destroy(&(sm->wakeup));
             pthread_mutex_destroy(&(sm->sync));
         }
 
@@ -311,45 +706,44 @@ int svcmgr_fini(void)
     return (int)UNIFYFS_SUCCESS;
 }
 
-/* iterate over list of chunk reads and send responses */
+/* start a chunk read response rpc, see
+ * finish_chunk_read_response_rpc() */
+static void start_chunk_read_response_rpc(remote_chunk_reads_t* rcr,
+                                          chunk_read_response_op_t* op);
+
+/* wait for a chunk read response rpc to complete and free its
+ * resources, returns rpc result */
+static int finish_chunk_read_response_rpc(chunk_read_response_op_t* op);
+
+/* send responses for all queued chunk reads, keeping up to
+ * SM_MAX_INFLIGHT_RESPONSES rpcs in flight at a time */
 static int send_chunk_read_responses(void)
 {
     /* assume we'll succeed */
     int rc = (int)UNIFYFS_SUCCESS;
 
-    /* this will hold a list of chunk read requests if we find any */
-    arraylist_t* chunk_reads = NULL;
-
-    /* lock to access global service manager object */
-    pthread_mutex_lock(&(sm->sync));
-
-    /* if we have any chunk reads, take pointer to the list
-     * of chunk read requests and replace it with a newly allocated
-     * list on the service manager structure */
-    int num_chunk_reads = arraylist_size(sm->chunk_reads);
-    if (num_chunk_reads) {
-        /* got some chunk read requets, take the list and replace
-         * it with an empty list */
-        LOGDBG("processing %d chunk read responses", num_chunk_reads);
-        chunk_reads = sm->chunk_reads;
-        sm->chunk_reads = arraylist_create();
-    }
-
-    /* release lock on service manager object */
-    pthread_mutex_unlock(&(sm->sync));
-
-    /* iterate over each chunk read request */
-    for (int i = 0; i < num_chunk_reads; i++) {
-        /* get next chunk read request */
-        remote_chunk_reads_t* rcr = (remote_chunk_reads_t*)
-            arraylist_get(chunk_reads, i);
-
-        rc = invoke_chunk_read_response_rpc(rcr);
-    }
+    chunk_read_response_op_t ops[SM_MAX_INFLIGHT_RESPONSES];
+
+    /* take all chunk read responses queued so far */
+    remote_chunk_reads_t* rcr = sm_take_chunk_reads();
+    while (NULL != rcr) {
+        /* start a batch of response rpcs */
+        int num_ops = 0;
+        while ((NULL != rcr) && (num_ops < SM_MAX_INFLIGHT_RESPONSES)) {
+            remote_chunk_reads_t* next = rcr->next;
+            start_chunk_read_response_rpc(rcr, ops + num_ops);
+            num_ops++;
+            rcr = next;
+        }
+        LOGDBG("sent %d chunk read responses", num_ops);
 
-    /* free the list if we have one */
-    if (NULL != chunk_reads) {
-        arraylist_free(chunk_reads);
+        /* wait for the batch to complete */
+        for (int i = 0; i < num_ops; i++) {
+            int ret = finish_chunk_read_response_rpc(ops + i);
+            if (ret != (int)UNIFYFS_SUCCESS) {
+                rc = ret;
+            }
+        }
     }
 
     return rc;
@@ -358,7 +752,8 @@ static int send_chunk_read_responses(void)
 /* Entry point for service manager thread. The SM thread
  * runs in a loop processing read request replies until
  * the main server thread asks it to exit. The read requests
- * themselves are handled by Margo RPC threads.
+ * themselves are handled by Margo RPC threads, which wake
+ * this thread when replies are ready to send.
  *
  * @param arg: pointer to SM thread control structure
  * @return NULL */
@@ -378,36 +773,20 @@ void* sm_service_reads(void* arg)
 
         pthread_mutex_lock(&(sm->sync));
 
+        /* wait for responses to be queued */
+        __atomic_store_n(&(sm->waiting), 1, __ATOMIC_SEQ_CST);
+        while (!sm->time_to_exit &&
+               (NULL == __atomic_load_n(&(sm->chunk_reads),
+                                        __ATOMIC_SEQ_CST))) {
+            pthread_cond_wait(&(sm->wakeup), &(sm->sync));
+        }
+        __atomic_store_n(&(sm->waiting), 0, __ATOMIC_SEQ_CST);
+
         if (sm->time_to_exit) {
             pthread_mutex_unlock(&(sm->sync));
             break;
         }
 
-#ifdef BURSTY_WAIT // REVISIT WHETHER BURSTY WAIT STILL DESIRABLE
-        /* determine how long to wait next time based on
-         * how much data we just processed in this burst */
-        size_t bursty_interval;
-        if (sm->burst_data_sz >= LARGE_BURSTY_DATA) {
-            /* for large bursts above a threshold,
-             * wait for a fixed amount of time */
-            bursty_interval = MAX_BURSTY_INTERVAL;
-        } else {
-            /* for smaller bursts, set delay proportionally
-             * to burst size we just processed */
-            bursty_interval =
-                (SLEEP_SLICE_PER_UNIT * sm->burst_data_sz) / MIB;
-        }
-        if (bursty_interval > MIN_SLEEP_INTERVAL) {
-            usleep(SLEEP_INTERVAL); /* wait an interval */
-        }
-#else
-        /* wait an interval */
-        usleep(MIN_SLEEP_INTERVAL);
-#endif // REVISIT WHETHER BURSTY WAIT STILL DESIRABLE
-
-        /* reset our burst size counter */
-        sm->burst_data_sz = 0;
-
         pthread_mutex_unlock(&(sm->sync));
     }
 
@@ -419,14 +798,16 @@ void* sm_service_reads(void* arg)
 
 /* BEGIN MARGO SERVER-SERVER RPC INVOCATION FUNCTIONS */
 
-/* invokes the chunk_read_response rpc, this sends a set of read
+/* starts the chunk_read_response rpc, this sends a set of read
  * reply headers and corresponding data back to a server that
  * had requested we read data on its behalf, the headers and
  * data are posted as a bulk transfer buffer */
-int invoke_chunk_read_response_rpc(remote_chunk_reads_t* rcr)
+static void start_chunk_read_response_rpc(remote_chunk_reads_t* rcr,
+                                          chunk_read_response_op_t* op)
 {
-    /* assume we'll succeed */
-    int rc = (int)UNIFYFS_SUCCESS;
+    op->rcr = rcr;
+    op->req = MARGO_REQUEST_NULL;
+    op->rc  = (int)UNIFYFS_SUCCESS;
 
     /* rank of destination server */
     int dst_rank = rcr->rank;
@@ -440,13 +821,11 @@ int invoke_chunk_read_response_rpc(remote_chunk_reads_t* rcr)
     ServerRpcContext_t* ctx = unifyfsd_rpc_context;
 
     /* get handle to read response rpc on destination server */
-    hg_handle_t handle;
     hg_return_t hret = margo_create(ctx->svr_mid, dst_addr,
-        ctx->rpcs.chunk_read_response_id, &handle);
+        ctx->rpcs.chunk_read_response_id, &(op->handle));
     assert(hret == HG_SUCCESS);
 
-    /* get address and size of our response buffer */
-    void* data_buf    = (void*)rcr->resp;
+    /* size of our response buffer */
     hg_size_t bulk_sz = rcr->total_sz;
 
     /* fill in input struct */
@@ -458,38 +837,52 @@ int invoke_chunk_read_response_rpc(remote_chunk_reads_t* rcr)
     in.num_chks  = (int32_t)rcr->num_chunks;
     in.bulk_size = bulk_sz;
 
-    /* register our response buffer for bulk remote read access */
-    hret = margo_bulk_create(ctx->svr_mid, 1,
-        &data_buf, &bulk_sz, HG_BULK_READ_ONLY, &in.bulk_handle);
-    assert(hret == HG_SUCCESS);
+    /* our response buffer is already registered for bulk access */
+    in.bulk_handle = rcr->resp_buf->bulk;
 
-    /* call the read response rpc */
+    /* call the read response rpc, input is serialized
+     * before margo_iforward() returns */
     LOGDBG("invoking the chunk-read-response rpc function");
-    hret = margo_forward(handle, &in);
+    hret = margo_iforward(op->handle, &in, &(op->req));
     if (hret != HG_SUCCESS) {
         /* failed to invoke the rpc */
-        rc = (int)UNIFYFS_FAILURE;
-    } else {
-        /* rpc executed, now decode response */
-        chunk_read_response_out_t out;
-        hret = margo_get_output(handle, &out);
-        if (hret == HG_SUCCESS) {
-            rc = (int)out.ret;
-            LOGDBG("chunk-read-response rpc to %d - ret=%d",
-                   dst_rank, rc);
-            margo_free_output(handle, &out);
-        } else {
+        op->req = MARGO_REQUEST_NULL;
+        op->rc  = (int)UNIFYFS_FAILURE;
+    }
+}
+
+/* wait for a chunk read response rpc to complete and free its
+ * resources, returns rpc result */
+static int finish_chunk_read_response_rpc(chunk_read_response_op_t* op)
+{
+    int rc = op->rc;
+    remote_chunk_reads_t* rcr = op->rcr;
+
+    if (op->req != MARGO_REQUEST_NULL) {
+        hg_return_t hret = margo_wait(op->req);
+        if (hret != HG_SUCCESS) {
             rc = (int)UNIFYFS_FAILURE;
+        } else {
+            /* rpc executed, now decode response */
+            chunk_read_response_out_t out;
+            hret = margo_get_output(op->handle, &out);
+            if (hret == HG_SUCCESS) {
+                rc = (int)out.ret;
+                LOGDBG("chunk-read-response rpc to %d - ret=%d",
+                       rcr->rank, rc);
+                margo_free_output(op->handle, &out);
+            } else {
+                rc = (int)UNIFYFS_FAILURE;
+            }
         }
     }
 
     /* free resources allocated for executing margo rpc */
-    margo_bulk_free(in.bulk_handle);
-    margo_destroy(handle);
+    margo_destroy(op->handle);
 
-    /* free response data buffer */
-    free(data_buf);
-    rcr->resp = NULL;
+    /* return response data buffer and free chunk reads struct */
+    bulk_pool_put(rcr->resp_buf);
+    free(rcr);
 
     return rc;
 }
@@ -661,10 +1054,6 @@ static void chunk_read_request_rpc(hg_handle_t handle)
     /* verify this is a request for data */
     int32_t ret;
     if (reqcmd == (int)SVC_CMD_RDREQ_CHK) {
-        /* chunk read request command */
-        LOGDBG("request command: SVC_CMD_RDREQ_CHK");
-        sm_issue_chunk_reads(src_rank, app_id, client_id, req_id,
-                             num_chks, (char*)reqbuf);
         ret = (int32_t)UNIFYFS_SUCCESS;
     } else {
         LOGERR("invalid chunk read request command %d from server %d",
@@ -676,7 +1065,8 @@ static void chunk_read_request_rpc(hg_handle_t handle)
     chunk_read_request_out_t out;
     out.ret = ret;
 
-    /* return output to caller */
+    /* return output to caller before reading, the reads may wait for
+     * bulk buffers and the caller must not wait on that */
     hret = margo_respond(handle, &out);
     assert(hret == HG_SUCCESS);
 
@@ -684,8 +1074,15 @@ static void chunk_read_request_rpc(hg_handle_t handle)
     margo_free_input(handle, &in);
     if (NULL != reqbuf) {
         margo_bulk_free(bulk_handle);
-        free(reqbuf);
     }
     margo_destroy(handle);
+
+    if (ret == (int32_t)UNIFYFS_SUCCESS) {
+        /* chunk read request command */
+        LOGDBG("request command: SVC_CMD_RDREQ_CHK");
+        sm_issue_chunk_reads(src_rank, app_id, client_id, req_id,
+                             num_chks, (char*)reqbuf);
+    }
+    free(reqbuf);
 }
 DEFINE_MARGO_RPC_HANDLER(chunk_read_request_rpc)
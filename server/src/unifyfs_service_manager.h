@@ -49,7 +49,12 @@ int sm_issue_chunk_reads(int src_rank,
                          int num_chks,
                          char* msg_buf);
 
-/* MARGO SERVER-SERVER RPC INVOCATION FUNCTIONS */
-int invoke_chunk_read_response_rpc(remote_chunk_reads_t* rcr);
+/* queue chunk reads of our own request manager to be issued by a ULT */
+int sm_queue_local_chunk_reads(int app_id,
+                               int client_id,
+                               int req_id,
+                               int num_chks,
+                               char* msg_buf,
+                               size_t msg_sz);
 
 #endif // UNIFYFS_SERVICE_MANAGER_H
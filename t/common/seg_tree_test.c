@@ -197,6 +197,37 @@ int main(int argc, char** argv)
     ok(max == 150, "max is 150 (got %lu)", max);
     ok(count == 1, "count is 1 (got %lu)", count);
 
+    /* Test removing ranges */
+    seg_tree_clear(&seg_tree);
+    seg_tree_add(&seg_tree, 0, 9, 100);
+    seg_tree_add(&seg_tree, 20, 29, 200);
+    seg_tree_add(&seg_tree, 40, 49, 300);
+
+    /* Remove the middle of a range, splitting it */
+    seg_tree_remove(&seg_tree, 3, 5);
+    is("[0-2:100][6-9:106][20-29:200][40-49:300]",
+        print_tree(tmp, &seg_tree), "Remove middle of range works");
+
+    /* Remove a range that trims one entry and deletes another */
+    seg_tree_remove(&seg_tree, 8, 29);
+    is("[0-2:100][6-7:106][40-49:300]",
+        print_tree(tmp, &seg_tree), "Remove across ranges works");
+
+    /* Remove the tail end of the tree */
+    seg_tree_remove(&seg_tree, 45, 1000);
+    is("[0-2:100][6-7:106][40-44:300]",
+        print_tree(tmp, &seg_tree), "Remove tail works");
+
+    max = seg_tree_max(&seg_tree);
+    count = seg_tree_count(&seg_tree);
+    ok(max == 44, "max is 44 (got %lu)", max);
+    ok(count == 3, "count is 3 (got %lu)", count);
+
+    /* Remove a range that does not exist */
+    seg_tree_remove(&seg_tree, 10, 30);
+    is("[0-2:100][6-7:106][40-44:300]",
+        print_tree(tmp, &seg_tree), "Remove of empty range works");
+
     seg_tree_clear(&seg_tree);
     seg_tree_destroy(&seg_tree);
 
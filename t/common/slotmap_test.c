@@ -2,6 +2,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "t/lib/tap.h"
@@ -12,6 +14,61 @@ struct reservation {
     size_t count;
 };
 
+/* reference first-fit search over a byte-per-slot shadow map */
+static ssize_t shadow_first_fit(const char* shadow, size_t total,
+                                size_t count)
+{
+    size_t run = 0;
+    for (size_t i = 0; i < total; i++) {
+        run = shadow[i] ? 0 : (run + 1);
+        if (run == count) {
+            return (ssize_t)(i + 1 - count);
+        }
+    }
+    return (ssize_t)-1;
+}
+
+static double elapsed_usec(struct timespec* start, struct timespec* end)
+{
+    return ((double)(end->tv_sec - start->tv_sec) * 1e6) +
+           ((double)(end->tv_nsec - start->tv_nsec) / 1e3);
+}
+
+/* Fragment a map of num_slots slots so that only every other slot is
+ * free, except for a run of 64 free slots at the very end. Reserving
+ * 64 slots must then search the whole map. Returns the search time in
+ * microseconds, or -1.0 if the reservation landed in the wrong place. */
+static double time_fragmented_search(size_t num_slots)
+{
+    size_t buf_sz = sizeof(slot_map) + (num_slots / 8) + 1;
+    void* buf = malloc(buf_sz);
+    if (NULL == buf) {
+        return -1.0;
+    }
+    slot_map* smap = slotmap_init(num_slots, buf, buf_sz);
+    if (NULL == smap) {
+        free(buf);
+        return -1.0;
+    }
+
+    slotmap_reserve(smap, num_slots);
+    for (size_t i = 1; (i + 2) < (num_slots - 64); i += 2) {
+        slotmap_release(smap, i, 1);
+    }
+    slotmap_release(smap, num_slots - 64, 64);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ssize_t slot = slotmap_reserve(smap, 64);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    free(buf);
+    if (slot != (ssize_t)(num_slots - 64)) {
+        return -1.0;
+    }
+    return elapsed_usec(&start, &end);
+}
+
 int main(int argc, char** argv)
 {
     int rc;
@@ -63,16 +120,28 @@ int main(int argc, char** argv)
         done_testing(); // will exit program
     }
 
+    /* shadow copy of the use map to check reservations against */
+    char* shadow = (char*) calloc(num_slots, 1);
+    if (NULL == shadow) {
+        BAIL_OUT("calloc() for shadow slot map failed!");
+    }
+
     size_t remove_ndx = 0;
     size_t success_count = 0;
+    size_t first_fit_count = 0;
     for (size_t i = 0; i < num_inserts; i++) {
         size_t cnt = (size_t)rand() % 18;
         if (0 == cnt) {
             cnt++;
         }
 
+        ssize_t expect = shadow_first_fit(shadow, num_slots, cnt);
         ssize_t slot = slotmap_reserve(smap, cnt);
+        if (slot == expect) {
+            first_fit_count++;
+        }
         if (-1 != slot) {
+            memset(shadow + slot, 1, cnt);
             success_count++;
             printf("# - reserved %2zu slots (start = %zu)\n",
                    cnt, (size_t)slot);
@@ -92,6 +161,10 @@ int main(int argc, char** argv)
        "all slotmap_reserve() calls succeeded (%zu of %zu), %zu slots used",
        success_count, num_inserts, smap->used_slots);
 
+    ok(first_fit_count == num_inserts,
+       "slotmap_reserve() returned the first fit (%zu of %zu)",
+       first_fit_count, num_inserts);
+
     slotmap_print(smap);
 
     success_count = 0;
@@ -102,6 +175,7 @@ int main(int argc, char** argv)
             release_count++;
             rc = slotmap_release(smap, rsvp->slot, rsvp->count);
             if (0 == rc) {
+                memset(shadow + rsvp->slot, 0, rsvp->count);
                 success_count++;
                 printf("# - released %2zu slots (start = %zu)\n",
                        rsvp->count, rsvp->slot);
@@ -117,9 +191,41 @@ int main(int argc, char** argv)
 
     slotmap_print(smap);
 
+    /* reservations made after releases reuse the freed slots first */
+    first_fit_count = 0;
+    for (size_t i = 0; i < num_removes; i++) {
+        size_t cnt = ((size_t)rand() % 8) + 1;
+        ssize_t expect = shadow_first_fit(shadow, num_slots, cnt);
+        ssize_t slot = slotmap_reserve(smap, cnt);
+        if (slot == expect) {
+            first_fit_count++;
+        }
+        if (-1 != slot) {
+            memset(shadow + slot, 1, cnt);
+        }
+    }
+    ok(first_fit_count == num_removes,
+       "slotmap_reserve() after release returned the first fit (%zu of %zu)",
+       first_fit_count, num_removes);
+
     rc = slotmap_clear(smap);
     ok(rc == 0, "clear the slotmap");
 
+    /* the search cost should grow with the number of 64-slot words in
+     * the map, even when the map is fragmented at the bit level */
+    size_t small_slots = 1UL << 16;
+    size_t large_slots = 1UL << 20;
+    double small_usec = time_fragmented_search(small_slots);
+    double large_usec = time_fragmented_search(large_slots);
+    ok((small_usec >= 0.0) && (large_usec >= 0.0),
+       "reserve found the only free run in fragmented slot maps");
+    printf("# fragmented search: %zu slots in %.1f usec (%.2f nsec/word)\n",
+           small_slots, small_usec, (small_usec * 1e3) / (small_slots / 64));
+    printf("# fragmented search: %zu slots in %.1f usec (%.2f nsec/word)\n",
+           large_slots, large_usec, (large_usec * 1e3) / (large_slots / 64));
+
+    free(shadow);
+
     done_testing();
 }
 
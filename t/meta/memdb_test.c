@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+/*
+ * Tests the in-memory MDHIM data store: single and batched puts, gets,
+ * deletes, and extent range queries, including ranges that start or
+ * end inside an extent or touch the extents of neighboring files.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ds_memdb.h"
+#include "unifyfs_metadata.h"
+
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+static int put_extent(void* dbh, int gfid, size_t offset,
+                      size_t len, size_t addr)
+{
+    unifyfs_key_t key = { .gfid = gfid, .offset = offset };
+    unifyfs_val_t val = { .addr = addr, .len = len };
+    return mdhim_memdb_put(dbh, &key, UNIFYFS_KEY_SZ, &val, UNIFYFS_VAL_SZ);
+}
+
+/* returned range records */
+struct range_out {
+    char** keys;
+    int32_t* keys_len;
+    char** vals;
+    int32_t* vals_len;
+    int cnt;
+};
+
+static void free_range_out(struct range_out* out)
+{
+    for (int i = 0; i < out->cnt; i++) {
+        free(out->keys[i]);
+        free(out->vals[i]);
+    }
+    free(out->keys);
+    free(out->keys_len);
+    free(out->vals);
+    free(out->vals_len);
+    memset(out, 0, sizeof(*out));
+}
+
+/* query the single range [start, end] of gfid */
+static int get_range(void* dbh, int gfid, size_t start, size_t end,
+                     struct range_out* out)
+{
+    unifyfs_key_t start_key = { .gfid = gfid, .offset = start };
+    unifyfs_key_t end_key = { .gfid = gfid, .offset = end };
+    char* keys[2] = { (char*) &start_key, (char*) &end_key };
+    int32_t key_lens[2] = { UNIFYFS_KEY_SZ, UNIFYFS_KEY_SZ };
+    memset(out, 0, sizeof(*out));
+    return mdhim_memdb_batch_ranges(dbh, keys, key_lens,
+                                    &out->keys, &out->keys_len,
+                                    &out->vals, &out->vals_len,
+                                    1, &out->cnt);
+}
+
+/* check that the i-th returned record is the given (clipped) extent */
+static int range_has(struct range_out* out, int i, int gfid,
+                     size_t offset, size_t len, size_t addr)
+{
+    if ((i >= out->cnt) ||
+        (out->keys_len[i] != (int32_t)UNIFYFS_KEY_SZ) ||
+        (out->vals_len[i] != (int32_t)UNIFYFS_VAL_SZ)) {
+        return 0;
+    }
+    unifyfs_key_t* key = (unifyfs_key_t*) out->keys[i];
+    unifyfs_val_t* val = (unifyfs_val_t*) out->vals[i];
+    return ((key->gfid == gfid) && (key->offset == offset) &&
+            (val->len == len) && (val->addr == addr));
+}
+
+int main(int argc, char** argv)
+{
+    void* dbh = NULL;
+    void* dbs = NULL;
+    void* data = NULL;
+    int32_t data_len = 0;
+    int rc;
+
+    plan(NO_PLAN);
+
+    rc = mdhim_memdb_open(&dbh, &dbs, NULL, 0, MDHIM_UNIFYFS_KEY, NULL);
+    if ((rc != MDHIM_SUCCESS) || (NULL == dbh)) {
+        BAIL_OUT("failed to open memory data store");
+    }
+
+    /* put and get */
+    unifyfs_key_t key = { .gfid = 5, .offset = 100 };
+    unifyfs_val_t val = { .addr = 4096, .len = 50, .app_id = 1, .rank = 2 };
+    rc = mdhim_memdb_put(dbh, &key, UNIFYFS_KEY_SZ, &val, UNIFYFS_VAL_SZ);
+    ok(rc == MDHIM_SUCCESS, "put extent");
+
+    rc = mdhim_memdb_get(dbh, &key, UNIFYFS_KEY_SZ, &data, &data_len);
+    ok((rc == MDHIM_SUCCESS) && (data_len == (int32_t)UNIFYFS_VAL_SZ) &&
+       (NULL != data) && (memcmp(data, &val, UNIFYFS_VAL_SZ) == 0),
+       "get returns the stored value");
+    free(data);
+
+    rc = mdhim_memdb_put(dbh, &key, UNIFYFS_KEY_SZ - 1,
+                         &val, UNIFYFS_VAL_SZ);
+    ok(rc == MDHIM_DB_ERROR, "put rejects a bad key length");
+
+    unifyfs_key_t missing = { .gfid = 5, .offset = 101 };
+    rc = mdhim_memdb_get(dbh, &missing, UNIFYFS_KEY_SZ, &data, &data_len);
+    ok((rc == MDHIM_DB_NOTFOUND) && (NULL == data),
+       "get of a missing key returns not found");
+
+    /* a put with an existing key replaces the value */
+    val.addr = 8192;
+    mdhim_memdb_put(dbh, &key, UNIFYFS_KEY_SZ, &val, UNIFYFS_VAL_SZ);
+    rc = mdhim_memdb_get(dbh, &key, UNIFYFS_KEY_SZ, &data, &data_len);
+    ok((rc == MDHIM_SUCCESS) && (NULL != data) &&
+       (((unifyfs_val_t*)data)->addr == 8192),
+       "put overwrites an existing key");
+    free(data);
+
+    /* delete */
+    rc = mdhim_memdb_del(dbh, &key, UNIFYFS_KEY_SZ);
+    ok(rc == MDHIM_SUCCESS, "delete extent");
+    rc = mdhim_memdb_get(dbh, &key, UNIFYFS_KEY_SZ, &data, &data_len);
+    ok(rc == MDHIM_DB_NOTFOUND, "get after delete returns not found");
+    rc = mdhim_memdb_del(dbh, &key, UNIFYFS_KEY_SZ);
+    ok(rc == MDHIM_SUCCESS, "delete of a missing key succeeds");
+
+    /* gfid 7 holds [0,99] [100,199] [300,399], with gfid 6 and 8
+     * neighbors that must never be returned for gfid 7 ranges */
+    put_extent(dbh, 6, 0, 1000, 0);
+    put_extent(dbh, 7, 0, 100, 10000);
+    put_extent(dbh, 7, 100, 100, 20000);
+    put_extent(dbh, 7, 300, 100, 30000);
+    put_extent(dbh, 8, 0, 1000, 40000);
+
+    struct range_out out;
+
+    rc = get_range(dbh, 7, 0, 399, &out);
+    ok((rc == MDHIM_SUCCESS) && (out.cnt == 3) &&
+       range_has(&out, 0, 7, 0, 100, 10000) &&
+       range_has(&out, 1, 7, 100, 100, 20000) &&
+       range_has(&out, 2, 7, 300, 100, 30000),
+       "range covering the file returns all its extents");
+    free_range_out(&out);
+
+    rc = get_range(dbh, 7, 50, 149, &out);
+    ok((rc == MDHIM_SUCCESS) && (out.cnt == 2) &&
+       range_has(&out, 0, 7, 50, 50, 10050) &&
+       range_has(&out, 1, 7, 100, 50, 20000),
+       "range inside two extents is clipped at both ends");
+    free_range_out(&out);
+
+    rc = get_range(dbh, 7, 99, 100, &out);
+    ok((rc == MDHIM_SUCCESS) && (out.cnt == 2) &&
+       range_has(&out, 0, 7, 99, 1, 10099) &&
+       range_has(&out, 1, 7, 100, 1, 20000),
+       "range across an extent boundary returns one byte of each");
+    free_range_out(&out);
+
+    rc = get_range(dbh, 7, 120, 130, &out);
+    ok((rc == MDHIM_SUCCESS) && (out.cnt == 1) &&
+       range_has(&out, 0, 7, 120, 11, 20020),
+       "range inside one extent returns that extent clipped");
+    free_range_out(&out);
+
+    rc = get_range(dbh, 7, 200, 299, &out);
+    ok((rc == MDHIM_SUCCESS) && (out.cnt == 0),
+       "range over a hole returns nothing");
+    free_range_out(&out);
+
+    rc = get_range(dbh, 7, 250, 300, &out);
+    ok((rc == MDHIM_SUCCESS) && (out.cnt == 1) &&
+       range_has(&out, 0, 7, 300, 1, 30000),
+       "range ending at an extent start returns its first byte");
+    free_range_out(&out);
+
+    rc = get_range(dbh, 7, 399, 5000, &out);
+    ok((rc == MDHIM_SUCCESS) && (out.cnt == 1) &&
+       range_has(&out, 0, 7, 399, 1, 30099),
+       "range starting at an extent end returns its last byte");
+    free_range_out(&out);
+
+    rc = get_range(dbh, 7, 400, 5000, &out);
+    ok((rc == MDHIM_SUCCESS) && (out.cnt == 0),
+       "range past the end of the file returns nothing");
+    free_range_out(&out);
+
+    rc = get_range(dbh, 9, 0, 5000, &out);
+    ok((rc == MDHIM_SUCCESS) && (out.cnt == 0),
+       "range of a file past the last key returns nothing");
+    free_range_out(&out);
+
+    rc = get_range(dbh, 7, 300, 200, &out);
+    ok((rc == MDHIM_SUCCESS) && (out.cnt == 0),
+       "range with end before start returns nothing");
+    free_range_out(&out);
+
+    /* multiple ranges in one call */
+    unifyfs_key_t rkeys[4] = {
+        { .gfid = 6, .offset = 990 }, { .gfid = 6, .offset = 2000 },
+        { .gfid = 8, .offset = 0 },   { .gfid = 8, .offset = 9 }
+    };
+    char* rkey_ptrs[4] = { (char*) &rkeys[0], (char*) &rkeys[1],
+                           (char*) &rkeys[2], (char*) &rkeys[3] };
+    int32_t rkey_lens[4] = { UNIFYFS_KEY_SZ, UNIFYFS_KEY_SZ,
+                             UNIFYFS_KEY_SZ, UNIFYFS_KEY_SZ };
+    memset(&out, 0, sizeof(out));
+    rc = mdhim_memdb_batch_ranges(dbh, rkey_ptrs, rkey_lens,
+                                  &out.keys, &out.keys_len,
+                                  &out.vals, &out.vals_len,
+                                  2, &out.cnt);
+    ok((rc == MDHIM_SUCCESS) && (out.cnt == 2) &&
+       range_has(&out, 0, 6, 990, 10, 990) &&
+       range_has(&out, 1, 8, 0, 10, 40000),
+       "multiple ranges return the extents of each range");
+    free_range_out(&out);
+
+    /* a bad key length fails instead of reading past the key */
+    rkey_lens[3] = UNIFYFS_KEY_SZ - 1;
+    memset(&out, 0, sizeof(out));
+    rc = mdhim_memdb_batch_ranges(dbh, rkey_ptrs, rkey_lens,
+                                  &out.keys, &out.keys_len,
+                                  &out.vals, &out.vals_len,
+                                  2, &out.cnt);
+    ok(rc == MDHIM_DB_ERROR, "range with a bad key length fails");
+    free_range_out(&out);
+
+    /* batch put, then delete one of the batch */
+    unifyfs_key_t bkeys[3] = {
+        { .gfid = 10, .offset = 0 },
+        { .gfid = 10, .offset = 10 },
+        { .gfid = 10, .offset = 20 }
+    };
+    unifyfs_val_t bvals[3] = {
+        { .addr = 100, .len = 10 },
+        { .addr = 200, .len = 10 },
+        { .addr = 300, .len = 10 }
+    };
+    void* bkey_ptrs[3] = { &bkeys[0], &bkeys[1], &bkeys[2] };
+    void* bval_ptrs[3] = { &bvals[0], &bvals[1], &bvals[2] };
+    int32_t bkey_lens[3] = { UNIFYFS_KEY_SZ, UNIFYFS_KEY_SZ,
+                             UNIFYFS_KEY_SZ };
+    int32_t bval_lens[3] = { UNIFYFS_VAL_SZ, UNIFYFS_VAL_SZ,
+                             UNIFYFS_VAL_SZ };
+    rc = mdhim_memdb_batch_put(dbh, bkey_ptrs, bkey_lens,
+                               bval_ptrs, bval_lens, 3);
+    ok(rc == MDHIM_SUCCESS, "batch put extents");
+
+    mdhim_memdb_del(dbh, &bkeys[1], UNIFYFS_KEY_SZ);
+    rc = get_range(dbh, 10, 0, 29, &out);
+    ok((rc == MDHIM_SUCCESS) && (out.cnt == 2) &&
+       range_has(&out, 0, 10, 0, 10, 100) &&
+       range_has(&out, 1, 10, 20, 10, 300),
+       "range skips a deleted extent");
+    free_range_out(&out);
+
+    rc = mdhim_memdb_close(dbh, dbs);
+    ok(rc == MDHIM_SUCCESS, "close memory data store");
+
+    done_testing();
+}
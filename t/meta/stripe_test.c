@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+/*
+ * Tests the MDHIM partitioner when file extents are striped across
+ * range servers: every key of a range must be served by one of the
+ * range servers returned for the range, including for gfids whose
+ * unsigned value is near the wrap.
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "partitioner.h"
+#include "unifyfs_metadata.h"
+
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+#define SLICE_SIZE (1024 * 1024)
+
+/* set up an index striping extents across num_srvs range servers */
+static struct index_t* create_index(uint32_t num_srvs)
+{
+    struct index_t* index = calloc(1, sizeof(struct index_t));
+    if (NULL == index) {
+        return NULL;
+    }
+    index->key_type = MDHIM_UNIFYFS_KEY;
+    index->mdhim_max_recs_per_slice = SLICE_SIZE;
+    index->unifyfs_stripe_extents = 1;
+    index->num_rangesrvs = num_srvs;
+    for (uint32_t i = 1; i <= num_srvs; i++) {
+        rangesrv_info* rs = calloc(1, sizeof(rangesrv_info));
+        if (NULL == rs) {
+            return NULL;
+        }
+        rs->rank = i - 1;
+        rs->rangesrv_num = i;
+        HASH_ADD_INT(index->rangesrvs_by_num, rangesrv_num, rs);
+    }
+    return index;
+}
+
+static void free_index(struct index_t* index)
+{
+    rangesrv_info* rs;
+    rangesrv_info* tmp;
+    HASH_ITER(hh, index->rangesrvs_by_num, rs, tmp) {
+        HASH_DEL(index->rangesrvs_by_num, rs);
+        free(rs);
+    }
+    free(index);
+}
+
+static void free_list(rangesrv_list* rl)
+{
+    while (NULL != rl) {
+        rangesrv_list* next = rl->next;
+        free(rl);
+        rl = next;
+    }
+}
+
+static int list_has(rangesrv_list* rl, rangesrv_info* rs)
+{
+    for (; NULL != rl; rl = rl->next) {
+        if (rl->ri == rs) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int list_len(rangesrv_list* rl)
+{
+    int n = 0;
+    for (; NULL != rl; rl = rl->next) {
+        n++;
+    }
+    return n;
+}
+
+/* server holding the extent of gfid at offset, as used for puts */
+static rangesrv_info* key_server(struct mdhim_t* md, struct index_t* index,
+                                 int gfid, size_t offset)
+{
+    unifyfs_key_t key = { .gfid = gfid, .offset = offset };
+    rangesrv_list* rl = get_range_servers(md, index, &key, sizeof(key));
+    rangesrv_info* rs = (NULL != rl) ? rl->ri : NULL;
+    free_list(rl);
+    return rs;
+}
+
+/* check that the servers returned for the range [start, end] of gfid
+ * cover the server of every offset slice in the range, returns the
+ * number of slices whose server was missing */
+static int check_range(struct mdhim_t* md, struct index_t* index,
+                       int gfid, size_t start, size_t end)
+{
+    unifyfs_key_t start_key = { .gfid = gfid, .offset = start };
+    unifyfs_key_t end_key   = { .gfid = gfid, .offset = end };
+    rangesrv_list* rl = get_range_servers_from_unifyfs_range(md, index,
+        &start_key, &end_key);
+    if (NULL == rl) {
+        return -1;
+    }
+
+    int missing = 0;
+    for (size_t off = start; off <= end; off += SLICE_SIZE) {
+        if (!list_has(rl, key_server(md, index, gfid, off))) {
+            missing++;
+        }
+    }
+    if (!list_has(rl, key_server(md, index, gfid, end))) {
+        missing++;
+    }
+    free_list(rl);
+    return missing;
+}
+
+int main(int argc, char** argv)
+{
+    struct mdhim_t md;
+    memset(&md, 0, sizeof(md));
+
+    int gfids[] = { 0, 1, 0xbeef, INT_MAX - 1, INT_MAX, INT_MIN, -3, -2, -1 };
+    int num_gfids = (int)(sizeof(gfids) / sizeof(gfids[0]));
+    uint32_t srv_counts[] = { 1, 2, 3, 4, 7 };
+    int num_counts = (int)(sizeof(srv_counts) / sizeof(srv_counts[0]));
+
+    plan(NO_PLAN);
+
+    for (int c = 0; c < num_counts; c++) {
+        uint32_t num_srvs = srv_counts[c];
+        struct index_t* index = create_index(num_srvs);
+        if (NULL == index) {
+            BAIL_OUT("failed to create index");
+        }
+
+        for (int g = 0; g < num_gfids; g++) {
+            int gfid = gfids[g];
+
+            /* consecutive offset slices go to consecutive servers */
+            int round_robin = 1;
+            rangesrv_info* prev = key_server(&md, index, gfid, 0);
+            for (uint32_t i = 1; i <= (2 * num_srvs); i++) {
+                rangesrv_info* rs = key_server(&md, index, gfid,
+                                               (size_t)i * SLICE_SIZE);
+                if ((NULL == prev) || (NULL == rs) ||
+                    (rs->rangesrv_num !=
+                     ((prev->rangesrv_num % num_srvs) + 1))) {
+                    round_robin = 0;
+                }
+                prev = rs;
+            }
+            ok(round_robin, "%u servers, gfid=%d: slices are round-robin",
+               num_srvs, gfid);
+
+            /* ranges of all lengths and alignments find every server
+             * holding their extents */
+            int missing = 0;
+            for (size_t len = 1; len <= (3 * num_srvs * SLICE_SIZE);
+                 len += (SLICE_SIZE / 2)) {
+                size_t start = (len % 3) * (SLICE_SIZE / 3);
+                int rc = check_range(&md, index, gfid,
+                                     start, start + len - 1);
+                missing += (rc < 0) ? 1 : rc;
+            }
+            ok(missing == 0, "%u servers, gfid=%d: range lookups cover "
+               "all extents (%d missing)", num_srvs, gfid, missing);
+
+            /* a range spanning num_srvs slices visits every server */
+            unifyfs_key_t start_key = { .gfid = gfid, .offset = 0 };
+            unifyfs_key_t end_key = {
+                .gfid = gfid,
+                .offset = ((size_t)num_srvs * SLICE_SIZE) - 1
+            };
+            rangesrv_list* rl = get_range_servers_from_unifyfs_range(&md,
+                index, &start_key, &end_key);
+            ok(list_len(rl) == (int)num_srvs,
+               "%u servers, gfid=%d: full stripe visits %d servers",
+               num_srvs, gfid, list_len(rl));
+            free_list(rl);
+        }
+
+        free_index(index);
+    }
+
+    done_testing();
+}
@@ -87,6 +87,8 @@ int main(int argc, char* argv[])
 
     write_read_hole_test(unifyfs_root);
 
+    writev_readv_test(unifyfs_root);
+
     truncate_test(unifyfs_root);
     truncate_bigempty(unifyfs_root);
     truncate_eof(unifyfs_root);
@@ -53,6 +53,9 @@ int write_read_test(char* unifyfs_root);
 /* test reading from file with holes */
 int write_read_hole_test(char* unifyfs_root);
 
+/* Tests for UNIFYFS_WRAP(writev/readv) and UNIFYFS_WRAP(pwritev/preadv) */
+int writev_readv_test(char* unifyfs_root);
+
 /* Tests for UNIFYFS_WRAP(ftruncate) and UNIFYFS_WRAP(truncate) */
 int truncate_test(char* unifyfs_root);
 int truncate_bigempty(char* unifyfs_root);
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2020, Lawrence Livermore National Security, LLC.
+ * Produced at the Lawrence Livermore National Laboratory.
+ *
+ * Copyright 2020, UT-Battelle, LLC.
+ *
+ * LLNL-CODE-741539
+ * All rights reserved.
+ *
+ * This is the license for UnifyFS.
+ * For details, see https://github.com/LLNL/UnifyFS.
+ * Please read https://github.com/LLNL/UnifyFS/LICENSE for full license text.
+ */
+
+ /*
+  * Test writev/readv/pwritev/preadv
+  */
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <linux/limits.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include "t/lib/tap.h"
+#include "t/lib/testutil.h"
+
+int writev_readv_test(char* unifyfs_root)
+{
+    diag("Starting UNIFYFS_WRAP(writev/readv/pwritev/preadv) tests");
+
+    char path[64];
+    char buf1[64] = {0};
+    char buf2[64] = {0};
+    char buf3[64] = {0};
+    struct iovec iov[3];
+    int fd = -1;
+    size_t global;
+
+    errno = 0;
+
+    testutil_rand_path(path, sizeof(path), unifyfs_root);
+
+    /* writev to bad file descriptor should fail with errno=EBADF */
+    iov[0].iov_base = "hello";
+    iov[0].iov_len  = 5;
+    ok(writev(fd, iov, 1) == -1 && errno == EBADF,
+       "%s:%d writev() to bad file descriptor fails (errno=%d): %s",
+       __FILE__, __LINE__, errno, strerror(errno));
+    errno = 0;
+
+    /* Write "hello universe" from three buffers, one of them empty */
+    fd = open(path, O_RDWR | O_CREAT, 0222);
+    ok(fd != -1, "%s:%d open(%s) (fd=%d): %s",
+       __FILE__, __LINE__, path, fd, strerror(errno));
+    iov[0].iov_base = "hello ";
+    iov[0].iov_len  = 6;
+    iov[1].iov_base = "";
+    iov[1].iov_len  = 0;
+    iov[2].iov_base = "universe";
+    iov[2].iov_len  = 8;
+    ok(writev(fd, iov, 3) == 14, "%s:%d writev(\"hello \", \"universe\"): %s",
+       __FILE__, __LINE__, strerror(errno));
+    ok(lseek(fd, 0, SEEK_CUR) == 14, "%s:%d writev() moved file pointer: %s",
+       __FILE__, __LINE__, strerror(errno));
+
+    /* Overwrite "universe" with "world!!!" at an offset */
+    iov[0].iov_base = "wor";
+    iov[0].iov_len  = 3;
+    iov[1].iov_base = "ld!!!";
+    iov[1].iov_len  = 5;
+    ok(pwritev(fd, iov, 2, 6) == 8, "%s:%d pwritev() at offset 6: %s",
+       __FILE__, __LINE__, strerror(errno));
+    ok(lseek(fd, 0, SEEK_CUR) == 14,
+       "%s:%d pwritev() did not move file pointer: %s",
+       __FILE__, __LINE__, strerror(errno));
+
+    /* Read back into three buffers before syncing */
+    iov[0].iov_base = buf1;
+    iov[0].iov_len  = 5;
+    iov[1].iov_base = buf2;
+    iov[1].iov_len  = 1;
+    iov[2].iov_base = buf3;
+    iov[2].iov_len  = 8;
+    ok(preadv(fd, iov, 3, 0) == 14, "%s:%d preadv() at offset 0: %s",
+       __FILE__, __LINE__, strerror(errno));
+    is(buf1, "hello", "%s:%d preadv() first buffer is \"hello\"",
+       __FILE__, __LINE__);
+    is(buf2, " ", "%s:%d preadv() second buffer is \" \"",
+       __FILE__, __LINE__);
+    is(buf3, "world!!!", "%s:%d preadv() third buffer is \"world!!!\"",
+       __FILE__, __LINE__);
+
+    ok(fsync(fd) == 0, "%s:%d fsync() worked: %s",
+       __FILE__, __LINE__, strerror(errno));
+
+    testutil_get_size(path, &global);
+    ok(global == 14, "%s:%d global size after fsync is %d: %s",
+       __FILE__, __LINE__, global, strerror(errno));
+
+    /* readv across end of file stops at the end */
+    memset(buf1, 0, sizeof(buf1));
+    memset(buf2, 0, sizeof(buf2));
+    ok(lseek(fd, 6, SEEK_SET) == 6, "%s:%d lseek(6) worked: %s",
+       __FILE__, __LINE__, strerror(errno));
+    iov[0].iov_base = buf1;
+    iov[0].iov_len  = 5;
+    iov[1].iov_base = buf2;
+    iov[1].iov_len  = 10;
+    ok(readv(fd, iov, 2) == 8, "%s:%d readv() past end of file: %s",
+       __FILE__, __LINE__, strerror(errno));
+    is(buf1, "world", "%s:%d readv() first buffer is \"world\"",
+       __FILE__, __LINE__);
+    is(buf2, "!!!", "%s:%d readv() second buffer is \"!!!\"",
+       __FILE__, __LINE__);
+    ok(lseek(fd, 0, SEEK_CUR) == 14, "%s:%d readv() moved file pointer: %s",
+       __FILE__, __LINE__, strerror(errno));
+
+    /* invalid vector count should fail with errno=EINVAL */
+    ok(readv(fd, iov, -1) == -1 && errno == EINVAL,
+       "%s:%d readv() with negative count fails (errno=%d): %s",
+       __FILE__, __LINE__, errno, strerror(errno));
+    errno = 0;
+
+    ok(close(fd) == 0, "%s:%d close() worked: %s",
+       __FILE__, __LINE__, strerror(errno));
+
+    return 0;
+}